@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace Core
+{
+	namespace Debug
+	{
+		// Count the allocations made through the global operator new, only replaced when ENGINE_TRACK_ALLOCATIONS is defined
+		class AllocationCounter
+		{
+		private:
+			static std::atomic<unsigned long long> allocationCount;
+			static std::atomic<unsigned long long> allocatedBytes;
+
+			// Bytes currently allocated, and their maximum since the last reset
+			static std::atomic<long long> liveBytes;
+			static std::atomic<long long> peakLiveBytes;
+
+		public:
+			static constexpr bool isEnabled()
+			{
+#ifdef ENGINE_TRACK_ALLOCATIONS
+				return true;
+#else
+				return false;
+#endif
+			}
+
+			static void addAllocation(std::size_t size);
+			static void removeAllocation(std::size_t size);
+
+			static unsigned long long getAllocationCount();
+			static unsigned long long getAllocatedBytes();
+
+			// Start measuring a new peak from the bytes allocated now
+			static void resetPeakBytes();
+			static unsigned long long getPeakBytes();
+		};
+	}
+}
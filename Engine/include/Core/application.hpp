@@ -5,10 +5,14 @@
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 
+#include <string>
+
 #include "singleton.hpp"
 #include "manager.hpp"
 #include "maths.hpp"
 
+#include "render_backend.hpp"
+
 namespace Core
 {
 	class Application final : public Singleton<Application>, Manager
@@ -21,6 +25,10 @@ namespace Core
 		Core::Maths::vec2 windowSize;
 		float aspect = 0.f;
 
+		// Loaded over the functions of glad once the window is created
+		LowRenderer::RenderBackendType renderBackend = LowRenderer::RenderBackendType::OPENGL;
+		std::string recordPath = "logs/gl_calls.txt";
+
 		Application();
 		~Application();
 
@@ -28,6 +36,9 @@ namespace Core
 		void setImGuiColorsEditor();
 
 	public:
+		// Choose the GL functions of the engine, before the initialization
+		static void setRenderBackend(LowRenderer::RenderBackendType type, const std::string& recordPath);
+
 		static void init(unsigned int screenWidth, unsigned int screenHeight, const char* title, GLFWmonitor* monitor = nullptr, GLFWwindow* share = nullptr);
 		static void update();
 		static float getAspect();
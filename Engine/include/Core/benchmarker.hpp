@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <chrono>
 #include <unordered_map>
 
@@ -16,6 +17,8 @@ namespace Core
 
 		private:
 			int reloadCount = 0;
+			int generatedEntityCount = 50000;
+			int formatBenchmarkRuns = 10;
 
 			std::unordered_map<std::string, std::chrono::duration<double>> timeSums;
 
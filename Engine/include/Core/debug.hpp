@@ -56,7 +56,7 @@ namespace Core
 			static void saveToFiles();
 
 			// Output the casted log
-			static void out();
+			static void out(Log* logManager);
 
 		public:
 			template <typename T>
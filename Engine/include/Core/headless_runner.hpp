@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include "tracer.hpp"
+#include "render_backend.hpp"
+
+namespace Resources
+{
+	class Scene;
+}
+
+namespace Core
+{
+	namespace Debug
+	{
+		struct HeadlessOptions
+		{
+			std::string scenePath;
+			std::string outputPath = "logs/headless_benchmark.json";
+
+			int runCount = 10;
+			unsigned int workerCount = 4u;
+
+			// Frames drawn after each load, to measure the CPU cost of the render path
+			int frameCount = 0;
+
+			LowRenderer::RenderBackendType backend = LowRenderer::RenderBackendType::NULL_GL;
+			std::string recordPath = "logs/gl_calls.txt";
+		};
+
+		struct HeadlessFrameResult
+		{
+			int frameCount = 0;
+
+			double totalMilliseconds = 0.0;
+			double maxMilliseconds = 0.0;
+
+			// Calls of the last frame
+			unsigned long long glCalls = 0ull;
+			unsigned int drawCalls = 0u;
+			unsigned int drawnMeshes = 0u;
+			unsigned int culledMeshes = 0u;
+			unsigned int occludedMeshes = 0u;
+			unsigned int occluders = 0u;
+			double occlusionRasterMilliseconds = 0.0;
+			unsigned int programBinds = 0u;
+			unsigned int materialBinds = 0u;
+		};
+
+		struct HeadlessRunResult
+		{
+			double instantiationMilliseconds = 0.0;
+			double loadMilliseconds = 0.0;
+
+			unsigned long long allocationCount = 0ull;
+			unsigned long long allocatedBytes = 0ull;
+
+			// Most bytes allocated at once during the run, measured from its start
+			unsigned long long peakHeapBytes = 0ull;
+
+			std::unordered_map<std::string, StageStatistics> stages;
+
+			HeadlessFrameResult frames;
+		};
+
+		// Load and draw a scene several times without any window, with stubbed GPU calls, and save the timings as JSON
+		class HeadlessRunner
+		{
+		private:
+			static bool parseOptions(int argc, char** argv, HeadlessOptions& options);
+
+			static std::size_t getPeakResidentBytes();
+
+			static void waitForLoad();
+			static void unloadScene(std::unique_ptr<Resources::Scene>& scene);
+
+			// Draw the loaded scene through the render backend, without any window
+			static void drawFrames(const Resources::Scene& scene, int frameCount, HeadlessFrameResult& result);
+
+			static bool writeResults(const HeadlessOptions& options, const std::vector<HeadlessRunResult>& results);
+
+		public:
+			static bool isRequested(int argc, char** argv);
+
+			// Usage: --headless <scene> [--runs <count>] [--workers <count>] [--frames <count>] [--backend null|recording] [--record <path>] [--output <json path>]
+			static int run(int argc, char** argv);
+		};
+	}
+}
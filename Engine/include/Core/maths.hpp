@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cmath>
+#include <initializer_list>
 
 namespace Core::Maths
 {
@@ -40,7 +41,7 @@ namespace Core::Maths
             struct { float x; float y; float z; };
             struct { float r; float g; float b; };
             struct { float c; float l; float q; };
-            struct { float u; float v; float q; };
+            struct { float u; float v; };
         };
 
         vec3(float x = 0.f, float y = 0.f, float z = 0.f)
@@ -86,6 +87,17 @@ namespace Core::Maths
 
     struct mat3
     {
+        // Given by hand, the implicit one of a union of vectors is deleted by GCC
+        mat3() { }
+
+        // Elements in order, like the braces of an aggregate
+        mat3(std::initializer_list<float> values)
+        {
+            int i = 0;
+            for (auto valueIt = values.begin(); valueIt != values.end() && i < 9; valueIt++)
+                e[i++] = *valueIt;
+        }
+
         union
         {
             float e[9] = { 0.f };
@@ -95,6 +107,17 @@ namespace Core::Maths
 
     struct mat4
     {
+        // Given by hand, the implicit one of a union of vectors is deleted by GCC
+        mat4() { }
+
+        // Elements in order, like the braces of an aggregate
+        mat4(std::initializer_list<float> values)
+        {
+            int i = 0;
+            for (auto valueIt = values.begin(); valueIt != values.end() && i < 16; valueIt++)
+                e[i++] = *valueIt;
+        }
+
         union
         {
             float e[16] = { 0.f };
@@ -275,7 +298,7 @@ namespace Core::Maths
 
     inline mat4 operator*(const mat4& lhs, const mat4& rhs)
     {
-        mat4 result = { 0.f };
+        mat4 result;
 
         for (int i = 0; i < 4; i++)
         {
@@ -386,9 +409,9 @@ namespace Core::Maths
 	}
 
 	template<typename T>
-	vec3& operator/=(const vec3& lhs, const T& scale)
+	vec3& operator/=(vec3& lhs, const T& scale)
 	{
-		if (scale != 0.f)
+		if (scale == 0.f)
 		    return lhs;
 
 		lhs = lhs / scale;
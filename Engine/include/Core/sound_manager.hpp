@@ -2,11 +2,14 @@
 
 #include <string>
 
-#include <irrklang/irrklang.h>
-
 #include "singleton.hpp"
 #include "maths.hpp"
 
+namespace irrklang
+{
+	class ISoundEngine;
+}
+
 namespace Core::Engine
 {
 	class SoundManager final : public Singleton<SoundManager>
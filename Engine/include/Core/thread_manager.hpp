@@ -31,12 +31,14 @@ namespace Multithread
         static bool isEmpty(const std::string& poolKey);
 
         static bool isMonoThreaded();
+        static void setMonoThreaded(bool isMonoThreaded);
 
         static void stopAllThread(const std::string& poolKey);
         static void stopAllPool();
 
         static void sync(const std::string& poolKey);
         static void syncAndClean(const std::string& poolKey);
+        static void discardCancelled(const std::string& poolKey);
 
         static void syncAll();
         static void syncAndCleanAll();
@@ -53,6 +55,21 @@ namespace Multithread
                 TM->pools[poolKey].addTask(func, args...);
         }
 
+        template <class Fct, typename... Types>
+        static void manageTask(const std::string& poolKey, const CancellationToken& token, Fct&& func, Types&&... args)
+        {
+            ThreadManager* TM = instance();
+
+            // Tasks of a cancelled load are never started
+            if (!TM->monoThread)
+                TM->pools[poolKey].addTask(token, func, args...);
+            else if (!token.isCancelled())
+            {
+                CancellationToken::Scope tokenScope(token);
+                std::bind(func, args...)();
+            }
+        }
+
         static std::chrono::system_clock::time_point getLastTime(const std::string& poolKey);
 
         static void rethrowExceptions();
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <unordered_map>
+
+#include "singleton.hpp"
+#include "concurrent_queue.hpp"
+
+namespace Core
+{
+	namespace Debug
+	{
+		struct TraceEvent
+		{
+			std::string stage;
+			std::string resourceName;
+
+			std::chrono::steady_clock::time_point start;
+			std::chrono::steady_clock::time_point end;
+
+			unsigned int threadIndex = 0u;
+		};
+
+		// Time spent in one stage during a load, summed over all its events
+		struct StageStatistics
+		{
+			unsigned int count = 0u;
+
+			double totalMilliseconds = 0.0;
+			double maxMilliseconds = 0.0;
+		};
+
+		std::string toJSONString(const std::string& str);
+
+		// Record the stages of a load as a Chrome trace (chrome://tracing or Perfetto)
+		class Tracer final : public Singleton<Tracer>
+		{
+			friend class Singleton<Tracer>;
+
+		public:
+			using Clock = std::chrono::steady_clock;
+
+		private:
+			bool enabled = true;
+			std::atomic<bool> isTracing = false;
+
+			unsigned int traceCount = 0u;
+			std::string lastTracePath;
+
+			Clock::time_point traceStart;
+
+			std::atomic<unsigned int> threadCount = 0u;
+
+			std::atomic_flag lockThreadNames = ATOMIC_FLAG_INIT;
+			std::unordered_map<unsigned int, std::string> threadNames;
+
+			ConcurrentQueue<TraceEvent> events;
+
+			std::unordered_map<std::string, StageStatistics> stageStatistics;
+
+			static unsigned int getThreadIndex();
+
+		public:
+			static Clock::time_point now();
+
+			static void setThreadName(const std::string& threadName);
+			static void setEnabled(bool enabled);
+
+			// Check if a load is traced, before building the names of its events
+			static bool isRecording();
+
+			static void beginTrace();
+			static void endTrace(const std::string& loadState = "loaded");
+
+			static void addEvent(const std::string& stage, const std::string& resourceName, const Clock::time_point& start, const Clock::time_point& end);
+
+			// Get the statistics of the stages of the last traced load, and reset them
+			static std::unordered_map<std::string, StageStatistics> popStageStatistics();
+
+			static void drawImGui();
+
+			// Record the stage from its construction to its destruction, nothing is copied when no load is traced
+			class Scope
+			{
+			private:
+				const char* stage = nullptr;
+				std::string resourceName;
+
+				bool isRecording = false;
+				Clock::time_point start;
+
+			public:
+				Scope(const char* stage, const std::string& resourceName);
+				~Scope();
+			};
+		};
+	}
+}
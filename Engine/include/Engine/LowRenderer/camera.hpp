@@ -25,6 +25,7 @@ namespace LowRenderer
 
 		Camera(Engine::Entity& owner);
 
+		Core::Maths::vec3 getPosition() const;
 		Core::Maths::mat4 getViewMatrix() const;
 		Core::Maths::mat4 getProjection() const;
 		Core::Maths::mat4 getOrthographic() const;
@@ -40,6 +41,6 @@ namespace LowRenderer
 		void sendProjToProgram(const std::shared_ptr<Resources::ShaderProgram> program);
 		void sendViewOrthoToProgram(const std::shared_ptr<Resources::ShaderProgram> program);
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 	};
 }
\ No newline at end of file
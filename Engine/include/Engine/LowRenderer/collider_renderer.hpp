@@ -1,7 +1,6 @@
 #pragma once
 
 #include "renderer.hpp"
-#include "model.hpp"
 #include "transform.hpp"
 #include "collider.hpp"
 
@@ -12,16 +11,19 @@ namespace LowRenderer
 	class ColliderRenderer : public Renderer
 	{
 	private:
-		LowRenderer::Model model;
 		Physics::Collider* collider = nullptr;
 
 	public:
-		ColliderRenderer(Engine::Entity& owner, Physics::Collider* ptr, const std::string& modelFilePath);
+		ColliderRenderer(Engine::Entity& owner, Physics::Collider* ptr);
 		~ColliderRenderer() {}
 
 		Core::Maths::mat4 getModelCollider() const;
 		bool canBeDraw() const;
 		void draw() const override;
+
+		// Add the lines of the collider shape to the debug draw of the frame
+		void addLines() const;
+
 		void drawImGui() override;
 		void onDestroy() override;
 	};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "singleton.hpp"
+
+#include "maths.hpp"
+
+namespace LowRenderer
+{
+	struct DebugVertex
+	{
+		Core::Maths::vec3 position;
+		Core::Maths::vec3 color;
+	};
+
+	// Immediate lines added during the frame, streamed in one buffer and drawn with one call
+	class DebugDraw final : public Singleton<DebugDraw>
+	{
+		friend class Singleton<DebugDraw>;
+
+	private:
+		DebugDraw() = default;
+		~DebugDraw();
+
+		GLuint VAO = 0u;
+		GLuint VBO = 0u;
+
+		// Two vertices per line
+		std::vector<DebugVertex> vertices;
+
+		void createBuffers();
+
+		// Circle of a radius around an axis, in a number of segments
+		void addCircle(const Core::Maths::vec3& center, const Core::Maths::vec3& axis, float radius, const Core::Maths::vec3& color, int segmentCount);
+
+		// Half circle from a start direction, around an axis
+		void addArc(const Core::Maths::vec3& center, const Core::Maths::vec3& axis, const Core::Maths::vec3& start, float radius, const Core::Maths::vec3& color, int segmentCount);
+
+	public:
+		static constexpr int circleSegmentCount = 32;
+
+		static void line(const Core::Maths::vec3& start, const Core::Maths::vec3& end, const Core::Maths::vec3& color);
+		static void ray(const Core::Maths::vec3& origin, const Core::Maths::vec3& direction, const Core::Maths::vec3& color);
+
+		// Edges of the cube from -1 to 1 through a transform
+		static void box(const Core::Maths::mat4& transform, const Core::Maths::vec3& color);
+		static void aabb(const Core::Maths::vec3& center, const Core::Maths::vec3& extents, const Core::Maths::vec3& color);
+
+		static void sphere(const Core::Maths::vec3& center, float radius, const Core::Maths::vec3& color);
+		static void capsule(const Core::Maths::vec3& start, const Core::Maths::vec3& end, float radius, const Core::Maths::vec3& color);
+
+		// Three axis cross of a size around a position
+		static void point(const Core::Maths::vec3& position, float size, const Core::Maths::vec3& color);
+
+		// Contact point of a collision with its normal
+		static void contact(const Core::Maths::vec3& position, const Core::Maths::vec3& normal, const Core::Maths::vec3& color);
+
+		// Draw the lines of the frame with the view projection of the camera and remove them, give the number of lines
+		static unsigned int flush(const Core::Maths::mat4& viewProjection);
+
+		// Remove the lines without drawing them, when no camera draws the frame
+		static void clear();
+	};
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "maths.hpp"
+
+namespace LowRenderer
+{
+	// Clip planes of a view projection, tested four at a time with SSE
+	class Frustum
+	{
+	private:
+		// Six planes stored by component, padded with two planes that contain everything
+		alignas(16) float planeX[8];
+		alignas(16) float planeY[8];
+		alignas(16) float planeZ[8];
+		alignas(16) float planeW[8];
+
+	public:
+		Frustum(const Core::Maths::mat4& viewProjection);
+
+		// Check if a box, given by its center and its half size, is at least partially inside
+		bool intersects(const Core::Maths::vec3& center, const Core::Maths::vec3& extents) const;
+	};
+}
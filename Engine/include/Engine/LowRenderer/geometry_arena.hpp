@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "singleton.hpp"
+
+namespace Resources
+{
+	struct Vertex;
+}
+
+namespace LowRenderer
+{
+	// Range of elements sub-allocated in an arena buffer
+	struct ArenaRange
+	{
+		GLuint first = 0u;
+		GLuint count = 0u;
+	};
+
+	// Command read by glMultiDrawElementsIndirect
+	struct DrawElementsIndirectCommand
+	{
+		GLuint count = 0u;
+		GLuint instanceCount = 1u;
+		GLuint firstIndex = 0u;
+		GLint baseVertex = 0;
+		GLuint baseInstance = 0u;
+	};
+
+	// GPU buffer of fixed size elements, sub-allocated with a first fit free-list
+	class ArenaBuffer
+	{
+	private:
+		GLuint ID = 0u;
+		GLsizeiptr elementSize = 0;
+
+		GLuint capacity = 0u;
+		GLuint usedCount = 0u;
+
+		// Free ranges, sorted by their first element
+		std::vector<ArenaRange> freeRanges;
+
+		void grow(GLuint minCapacity);
+
+	public:
+		ArenaBuffer(GLsizeiptr elementSize, GLuint initialCapacity);
+		~ArenaBuffer();
+
+		// Return true if the buffer has been replaced by a bigger one
+		bool allocate(GLuint count, ArenaRange& range);
+		void free(ArenaRange& range);
+
+		void upload(const ArenaRange& range, const void* data);
+
+		GLuint getID() const;
+		GLuint getCapacity() const;
+		GLuint getUsedCount() const;
+		size_t getFreeRangeCount() const;
+	};
+
+	// Vertices and indices of all the meshes, drawn with a single VAO
+	class GeometryArena final : public Singleton<GeometryArena>
+	{
+		friend class Singleton<GeometryArena>;
+
+	private:
+		GeometryArena();
+		~GeometryArena();
+
+		GLuint VAO = 0u;
+
+		ArenaBuffer vertices;
+		ArenaBuffer indices;
+
+		// Instanced attribute giving its index to each draw of a multi-draw, through its base instance
+		GLuint drawIndexBuffer = 0u;
+		GLuint drawIndexCapacity = 0u;
+
+		void setVertexFormat();
+		void growDrawIndices(GLuint drawCount);
+
+	public:
+		static void allocate(GLuint vertexCount, GLuint indexCount, ArenaRange& vertexRange, ArenaRange& indexRange);
+		static void free(ArenaRange& vertexRange, ArenaRange& indexRange);
+
+		static void upload(const ArenaRange& vertexRange, const Resources::Vertex* vertexData, const ArenaRange& indexRange, const unsigned int* indexData);
+
+		// Make sure each draw of a multi-draw can read its index
+		static void reserveDraws(GLuint drawCount);
+
+		static void bind();
+		static void unbind();
+
+		static void drawImGui();
+	};
+}
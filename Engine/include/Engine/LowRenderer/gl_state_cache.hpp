@@ -0,0 +1,81 @@
+#pragma once
+
+#include <unordered_map>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+#include "singleton.hpp"
+
+namespace LowRenderer
+{
+	// Calls sent to the driver and calls skipped because they would not change anything
+	struct GLCallCounter
+	{
+		unsigned int issued = 0u;
+		unsigned int elided = 0u;
+	};
+
+	struct GLStateCounters
+	{
+		GLCallCounter programs;
+		GLCallCounter vertexArrays;
+		GLCallCounter framebuffers;
+		GLCallCounter textures;
+		GLCallCounter buffers;
+		GLCallCounter caps;
+		GLCallCounter uniforms;
+	};
+
+	// Shadow copy of the GL bindings, used to skip the redundant calls
+	class GLStateCache final : public Singleton<GLStateCache>
+	{
+		friend class Singleton<GLStateCache>;
+
+	private:
+		GLStateCache() = default;
+
+		// Value of a binding that has not been set through the cache
+		static constexpr GLuint unknownBinding = ~0u;
+
+		GLuint program = unknownBinding;
+		GLuint vertexArray = unknownBinding;
+		GLuint framebuffer = unknownBinding;
+		GLuint activeTextureUnit = unknownBinding;
+		GLenum cullFaceMode = unknownBinding;
+
+		// Keys packing a unit or an index with its target
+		std::unordered_map<uint64_t, GLuint> textures;
+		std::unordered_map<GLenum, GLuint> buffers;
+		std::unordered_map<uint64_t, GLuint> indexedBuffers;
+		std::unordered_map<GLenum, bool> caps;
+
+		GLStateCounters counters;
+		GLStateCounters lastCounters;
+
+		static bool count(GLCallCounter& counter, bool isElided);
+
+	public:
+		// Forget the bindings, that may have been changed by calls outside of the cache
+		static void invalidate();
+
+		// Reset the counters and start from an unknown state
+		static void beginFrame();
+
+		static void useProgram(GLuint program);
+		static void bindVertexArray(GLuint vertexArray);
+		static void bindFramebuffer(GLuint framebuffer);
+		static void bindTexture(GLuint unit, GLenum target, GLuint texture);
+		static void bindBuffer(GLenum target, GLuint buffer);
+		static void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+		static void setCapState(GLenum cap, bool state);
+		static void cullFace(GLenum mode);
+
+		// Count a uniform upload, skipped if its shadow copy had the same value
+		static void countUniform(bool isElided);
+
+		static const GLStateCounters& getLastCounters();
+
+		static void drawImGui();
+	};
+}
@@ -12,6 +12,7 @@ namespace Physics
 namespace LowRenderer
 {
 	class Shadow;
+	struct ClusterLight;
 
 	struct LightData
 	{
@@ -42,15 +43,23 @@ namespace LowRenderer
 	public:
 		Light(Engine::Entity& owner);
 
-		std::unique_ptr<Shadow> shadow = nullptr;
+		// Defined where the shadows are complete, for their unique pointer
+		~Light();
+
+		std::unique_ptr<Shadow> shadow;
 		
 		void setAsDirectionnal();
 		void setAsPoint();
 		void setAsSpot();
 		void setShadows(bool isShadow);
 		void compute();
-		void sendToProgram(std::shared_ptr<Resources::ShaderProgram> program, int index) const;
-		void addToLightBuffer(std::vector<LightData>& buffer);
+		// Send the shadow of the light in a slot of the shadow uniforms
+		void sendShadowToProgram(std::shared_ptr<Resources::ShaderProgram> program, int shadowIndex) const;
+		void addToLightBuffer(std::vector<ClusterLight>& buffer, int shadowIndex) const;
+
+		// Distance where the diffuse and specular light fades under minIntensity, infinite for the directional lights
+		float getRange() const;
+		static constexpr float minIntensity = 1.f / 256.f;
 
 
 		const Core::Maths::mat4& getSpaceMatrix() const;
@@ -58,6 +67,6 @@ namespace LowRenderer
 		void drawImGui() override;
 		std::string toString() const override;
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+#include "maths.hpp"
+#include "color.hpp"
+
+namespace Resources
+{
+	class ShaderProgram;
+}
+
+namespace LowRenderer
+{
+	class Camera;
+	class Light;
+
+	// Light read by the lit programs, laid out like the std430 struct of the light buffer
+	struct ClusterLight
+	{
+		Core::Maths::vec3 position;
+		float isPoint = 0.f;
+		Color diffuse;
+		Color specular;
+
+		Core::Maths::vec3 attenuation = Core::Maths::vec3(1.f, 0.f, 0.f);
+		float spotCutoff = -1.f;
+		Core::Maths::vec3 direction = Core::Maths::vec3(0.f, 0.f, -1.f);
+		float spotOuterCutoff = -1.f;
+
+		// Slot of the light in the shadow uniforms, -1 without any shadow
+		float shadowIndex = -1.f;
+		float range = 0.f;
+		float padding[2] = { 0.f, 0.f };
+	};
+
+	// Froxels of the camera frustum, each cluster keeps the lights whose sphere reaches it
+	class LightClusters
+	{
+	private:
+		// Bounds of each cluster in view space, rebuilt when the projection changes
+		std::vector<Core::Maths::vec3> clusterMins;
+		std::vector<Core::Maths::vec3> clusterMaxs;
+
+		float boundsFovY = 0.f;
+		float boundsAspect = 0.f;
+		float boundsNear = 0.f;
+		float boundsFar = 0.f;
+
+		Core::Maths::mat4 view;
+
+		// Clusters per pixel on the screen
+		Core::Maths::vec2 tileScale;
+
+		std::vector<ClusterLight> lights;
+
+		// Spheres of the lights in view space, by component for the SIMD tests
+		std::vector<float> sphereX;
+		std::vector<float> sphereY;
+		std::vector<float> sphereZ;
+		std::vector<float> sphereRadius;
+
+		// The ambient of the lights does not fade with the distance, it is summed for all of them
+		Core::Maths::vec4 ambient;
+
+		// Lights of each cluster, the lights past the maximum are dropped
+		std::vector<uint32_t> clusterLightIndices;
+		std::vector<uint32_t> clusterLightCounts;
+		std::vector<uint32_t> sliceDroppedCounts;
+
+		// Offset and count of each cluster in the compact list of indices
+		std::vector<uint32_t> clusterRanges;
+		std::vector<uint32_t> compactIndices;
+
+		GLuint lightBuffer = 0;
+		GLuint clusterBuffer = 0;
+		GLuint indexBuffer = 0;
+
+		void computeBounds(const Camera& camera);
+
+		// View depth where a slice starts, the slices get deeper with the distance
+		float getSliceDepth(int slice) const;
+
+	public:
+		static constexpr int gridX = 16;
+		static constexpr int gridY = 9;
+		static constexpr int gridZ = 24;
+		static constexpr int clusterCount = gridX * gridY * gridZ;
+
+		static constexpr uint32_t maxLightsPerCluster = 128u;
+
+		// Binding points of the storage buffers, after the draw buffer
+		static constexpr GLuint lightBinding = 1u;
+		static constexpr GLuint clusterBinding = 2u;
+		static constexpr GLuint indexBinding = 3u;
+
+		~LightClusters();
+
+		// Start a frame from the view of a camera, the lights of the last frame are removed
+		void begin(const Camera& camera, const Core::Maths::vec2& screenSize);
+
+		// Add an active light with its slot in the shadow uniforms
+		void addLight(const Light& light, int shadowIndex);
+
+		// Fill the clusters of a range of slices, the tasks of a frame take separate ranges
+		void assignSlices(int firstSlice, int endSlice);
+
+		// Compact the lists of the clusters and upload them with the lights
+		void upload();
+
+		// Bind the buffers and send the grid to a lit program
+		void sendToProgram(const std::shared_ptr<Resources::ShaderProgram>& program) const;
+
+		size_t getLightCount() const;
+		size_t getAssignedCount() const;
+		size_t getDroppedCount() const;
+	};
+}
@@ -7,8 +7,6 @@
 #include "shader.hpp"
 #include "material.hpp"
 
-#define COLLIDER_COLOR Core::Maths::vec3(0.f, 1.f, 0.f)
-
 namespace Physics
 {
 	class TransformComponent;
@@ -16,6 +14,44 @@ namespace Physics
 
 namespace LowRenderer
 {
+	// Per draw data read by the vertex shaders from the draw buffer
+	struct DrawData
+	{
+		Core::Maths::mat4 model;
+		Core::Maths::vec4 tilling;
+	};
+
+	// Mesh to draw with its material, submitted with the other draws of its pass
+	struct ModelDraw
+	{
+		const Resources::Mesh* mesh = nullptr;
+		const Resources::Material* material = nullptr;
+		bool hasFaceCulling = true;
+
+		DrawData data;
+
+		// Bounds of the mesh in world space
+		Resources::Bounds bounds;
+
+		// Draw of an entity that never moves, baked in the cached shadow maps
+		bool isStatic = false;
+
+		// Level of detail of the mesh
+		uint32_t lod = 0u;
+	};
+
+	// Camera that chooses the levels of detail, from the part of the screen covered by the meshes
+	struct LodView
+	{
+		Core::Maths::vec3 position;
+
+		// 1 / tan(fovY / 2), a sphere covers radius * scale / distance of the half height of the screen
+		float projectionScale = 1.f;
+
+		// The levels past this one are not used
+		size_t maxLod = Resources::Mesh::maxLodCount - 1u;
+	};
+
 	class Model
 	{
 	private:
@@ -26,9 +62,18 @@ namespace LowRenderer
 		std::string m_filePath;
 		std::string m_name;
 
+		// Level chosen by the last camera pass, the other passes keep it
+		mutable size_t m_lod = 0u;
+
+		size_t selectLod(float screenSize) const;
+
 		Model(Physics::TransformComponent* transform, const std::string& meshName);
 
 	public:
+		// Screen sizes under which each coarser level is used, and the margin kept around them before changing again
+		static constexpr float lodScreenSizes[Resources::Mesh::maxLodCount - 1] = { 0.4f, 0.2f, 0.1f };
+		static constexpr float lodHysteresis = 0.15f;
+
 		bool hasFaceCulling = true;
 
 		Physics::TransformComponent* m_transform = nullptr;
@@ -37,9 +82,8 @@ namespace LowRenderer
 
 		Model() = default;
 
-		void draw(std::shared_ptr<Resources::ShaderProgram> shaderProgram) const;
-		void simpleDraw(std::shared_ptr<Resources::ShaderProgram> shaderProgram) const;
-		void drawCollider(std::shared_ptr<Resources::ShaderProgram> shaderProgram, Core::Maths::mat4& modelCollider) const;
+		// Add the uploaded meshes of the model and its children to the draws of a pass, a view chooses new levels of detail
+		void addDraws(std::vector<ModelDraw>& draws, const Core::Maths::vec4& tilling, const LodView* lodView = nullptr) const;
 		void drawImGui();
 
 		void loadMeshes();
@@ -20,10 +20,10 @@ namespace LowRenderer
 		~ModelRenderer();
 
 		void draw() const override;
-		void simpleDraw(std::shared_ptr<Resources::ShaderProgram> program) const;
+		void addDraws(std::vector<ModelDraw>& draws, const LodView* lodView = nullptr) const;
 		void drawImGui() override;
 		std::string toString() const override;
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace LowRenderer
+{
+	// Point the OpenGL functions used by the engine to stubs, to run without a GPU nor a context
+	void loadNullGL();
+
+	// Binds of names that have never been generated and draws without a program or a vertex array
+	unsigned long long getNullGLErrorCount();
+}
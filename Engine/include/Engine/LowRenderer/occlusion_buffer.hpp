@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+
+#include "maths.hpp"
+
+namespace Resources
+{
+	struct Bounds;
+}
+
+namespace LowRenderer
+{
+	// Triangle of an occluder in the pixels of the buffer, with its inverse view depth
+	struct OccluderTriangle
+	{
+		float x[3];
+		float y[3];
+		float invDepth[3];
+
+		// Rows covered by the triangle, empty for the triangles that are not rasterized
+		int minY = 0;
+		int maxY = -1;
+	};
+
+	// Low resolution depth of the biggest occluders, rasterized on the CPU to skip the meshes hidden behind them
+	class OcclusionBuffer
+	{
+	private:
+		// Occluder geometry in model space, transformed by the setup tasks
+		struct Occluder
+		{
+			const std::vector<Core::Maths::vec3>* positions = nullptr;
+			const std::vector<unsigned int>* indices = nullptr;
+			Core::Maths::mat4 model;
+			size_t firstTriangle = 0u;
+		};
+
+		Core::Maths::mat4 viewProjection;
+		float nearDepth = 0.f;
+
+		std::vector<Occluder> occluders;
+		std::vector<OccluderTriangle> triangles;
+
+		// Inverse view depth of the closest occluder of each pixel, zero where there is none
+		std::vector<float> pixelDepths;
+
+		// Farthest pixel of each tile, a mesh closer than it may be visible in the tile, padded to load the last ones four at a time
+		std::vector<float> tileDepths;
+
+		void rasterizeTriangle(const OccluderTriangle& triangle, int firstRow, int endRow);
+
+	public:
+		static constexpr int width = 320;
+		static constexpr int height = 192;
+
+		// Tiles of the hierarchical level, tested four at a time
+		static constexpr int tileSize = 8;
+		static constexpr int tileCountX = width / tileSize;
+		static constexpr int tileCountY = height / tileSize;
+
+		// Occluders chosen among the visible draws, the biggest ones on the screen first
+		static constexpr size_t maxOccluderCount = 32u;
+		static constexpr float minOccluderScreenSize = 0.2f;
+
+		OcclusionBuffer();
+
+		// Start a frame from the view projection of the camera, the occluders of the last frame are removed
+		void begin(const Core::Maths::mat4& viewProjection, float nearDepth);
+
+		// Add the occluder geometry of a mesh with its model matrix
+		void addOccluder(const std::vector<Core::Maths::vec3>& positions, const std::vector<unsigned int>& indices, const Core::Maths::mat4& model);
+
+		// Project the triangles of a range of occluders, the tasks of a frame take separate ranges
+		void setupOccluders(size_t firstOccluder, size_t endOccluder);
+
+		// Rasterize all the triangles in a range of tile rows and compute the depths of their tiles
+		void rasterizeTileRows(int firstTileRow, int endTileRow);
+
+		// Check if a box, given by its center and its half size, is behind the occluders in all the tiles it covers
+		bool isOccluded(const Resources::Bounds& bounds) const;
+
+		size_t getOccluderCount() const;
+		size_t getTriangleCount() const;
+	};
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <fstream>
+
+#include "singleton.hpp"
+
+namespace LowRenderer
+{
+	enum class RenderBackendType
+	{
+		// Functions of the driver loaded by glad
+		OPENGL,
+
+		// Stubs that validate and count the calls, without any context
+		NULL_GL,
+
+		// Functions already loaded, or the stubs without a context, with each call written to a file
+		RECORDING,
+	};
+
+	// Calls of a GL function since the last reset, all made on the context thread
+	struct GLFunctionCalls
+	{
+		const char* name = nullptr;
+		unsigned long long count = 0ull;
+
+		GLFunctionCalls(const char* name);
+	};
+
+	// Layer between the engine and the GL functions, chosen at startup
+	class RenderBackend final : public Singleton<RenderBackend>
+	{
+		friend class Singleton<RenderBackend>;
+
+	private:
+		RenderBackend() = default;
+		~RenderBackend();
+
+		RenderBackendType type = RenderBackendType::OPENGL;
+
+		// The wrappers count the calls, they are installed once over the loaded functions
+		bool areWrappersInstalled = false;
+		std::vector<GLFunctionCalls> calls;
+
+		std::ofstream recordFile;
+		std::atomic_flag recordFlag = ATOMIC_FLAG_INIT;
+
+		void installWrappers();
+
+	public:
+		// Replace the GL functions used by the engine, after glad has loaded them for the OpenGL backend
+		static bool load(RenderBackendType type, const std::string& recordPath = "logs/gl_calls.txt");
+
+		// Read the backend from the --backend opengl|null|recording and --record <path> arguments, false if they are invalid
+		static bool parseArguments(int argc, char** argv, RenderBackendType& type, std::string& recordPath);
+
+		static RenderBackendType getType();
+
+		// Called by the wrappers, before calling the function they replace
+		static void countCall(size_t functionIndex);
+		static bool isRecording();
+		static void recordCall(const std::string& call);
+
+		static const std::vector<GLFunctionCalls>& getCalls();
+		static unsigned long long getCallCount();
+		static void resetCalls();
+
+		static void drawImGui();
+	};
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "shadow.hpp"
+
+namespace Resources
+{
+	class ShaderProgram;
+	class Material;
+}
+
+namespace LowRenderer
+{
+	enum class RenderCommandType : uint32_t
+	{
+		// Bind a program of the buffer, the next commands use it
+		BIND_PROGRAM,
+
+		// Send the camera, the lights and the sky box to the bound program
+		SEND_FRAME_UNIFORMS,
+
+		// Bind a target for a pass of the shadow of a light of the buffer
+		BIND_SHADOW_MAP,
+
+		SET_FACE_CULLING,
+
+		// Send a material of the buffer to the bound program
+		BIND_MATERIAL,
+
+		// Draw a range of the uploaded indirect commands
+		DRAW_INDIRECT,
+	};
+
+	// Command of sixteen bytes, the resources are indices in the tables of its buffer
+	struct RenderCommand
+	{
+		RenderCommandType type;
+		uint32_t args[3] = { 0u, 0u, 0u };
+	};
+
+	// Commands recorded without any GL call, replayed later on the thread of the context
+	class RenderCommandBuffer
+	{
+	private:
+		std::vector<RenderCommand> commands;
+
+		std::vector<std::shared_ptr<Resources::ShaderProgram>> programs;
+		std::vector<const Resources::Material*> materials;
+		std::vector<Light*> lights;
+
+		void push(RenderCommandType type, uint32_t arg0 = 0u, uint32_t arg1 = 0u, uint32_t arg2 = 0u);
+
+	public:
+		void clear();
+
+		void bindProgram(const std::shared_ptr<Resources::ShaderProgram>& program);
+		void sendFrameUniforms();
+		void bindShadowMap(Light* light, size_t pass, ShadowTarget target);
+		void setFaceCulling(bool hasFaceCulling);
+		void bindMaterial(const Resources::Material* material);
+		void drawIndirect(uint32_t firstCommand, uint32_t commandCount, uint32_t meshCount);
+
+		const std::vector<RenderCommand>& getCommands() const;
+
+		const std::shared_ptr<Resources::ShaderProgram>& getProgram(uint32_t index) const;
+		const Resources::Material* getMaterial(uint32_t index) const;
+		Light* getLight(uint32_t index) const;
+	};
+}
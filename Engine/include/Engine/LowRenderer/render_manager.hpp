@@ -2,20 +2,112 @@
 
 #include "singleton.hpp"
 
-#include <glad\glad.h>
+#include <glad/glad.h>
 
 #include <unordered_set>
 #include <set>
+#include <vector>
+#include <functional>
 
 #include "collider_renderer.hpp"
 #include "sprite_renderer.hpp"
 #include "model_renderer.hpp"
+#include "character.hpp"
 #include "sky_box.hpp"
 #include "camera.hpp"
 #include "light.hpp"
+#include "geometry_arena.hpp"
+#include "gl_state_cache.hpp"
+#include "frustum.hpp"
+#include "render_queue.hpp"
+#include "render_command.hpp"
+#include "shadow_map.hpp"
+#include "light_clusters.hpp"
+#include "occlusion_buffer.hpp"
+#include "sprite_batch.hpp"
+#include "debug_draw.hpp"
 
 namespace LowRenderer
 {
+	// Meshes kept and rejected by the culling of a pass
+	struct PassCounters
+	{
+		unsigned int drawn = 0u;
+		unsigned int culled = 0u;
+
+		// Meshes inside of the frustum, hidden behind the occluders
+		unsigned int occluded = 0u;
+	};
+
+	// Work done by the render manager during a frame
+	struct RenderCounters
+	{
+		unsigned int drawCalls = 0u;
+		unsigned int drawnMeshes = 0u;
+
+		// Meshes drawn as an instance of the command of a previous mesh
+		unsigned int instancedDraws = 0u;
+
+		// Triangles of the drawn levels of detail, and of the same meshes at their full detail
+		unsigned int drawnTriangles = 0u;
+		unsigned int fullDetailTriangles = 0u;
+
+		unsigned int materialBinds = 0u;
+		unsigned int programBinds = 0u;
+		unsigned int vaoBinds = 0u;
+
+		// Commands replayed by the executor
+		unsigned int recordedCommands = 0u;
+
+		// Sprites drawn by the batches, and their calls
+		unsigned int batchedSprites = 0u;
+		unsigned int spriteDrawCalls = 0u;
+
+		// Collider gizmos and other debug lines, drawn in one call
+		unsigned int debugLines = 0u;
+
+		PassCounters cameraPass;
+		PassCounters directionalPass;
+		PassCounters pointPass;
+
+		// Directional shadow passes, by cascade
+		PassCounters cascadePasses[ShadowMap::maxCascadeCount];
+
+		// Shadow maps drawn again and kept from a previous frame
+		unsigned int drawnShadowMaps = 0u;
+		unsigned int cachedShadowMaps = 0u;
+
+		// Lights sent to the clusters, their indices in the clusters and the ones past the maximum of a cluster
+		unsigned int clusteredLights = 0u;
+		unsigned int clusterLightIndices = 0u;
+		unsigned int droppedClusterLights = 0u;
+
+		// Occluders rasterized for the camera pass, with their triangles
+		unsigned int occluders = 0u;
+		unsigned int occluderTriangles = 0u;
+
+		// CPU time spent to submit the passes
+		double shadowMilliseconds = 0.0;
+		double modelMilliseconds = 0.0;
+		double lightAssignMilliseconds = 0.0;
+		double occlusionRasterMilliseconds = 0.0;
+	};
+
+	// Visible draws gathered by a task of the render pool, merged in a queue by the context thread
+	struct VisibleDraws
+	{
+		std::vector<ModelDraw> draws;
+		std::vector<float> depths;
+		std::vector<const ModelRenderer*> renderers;
+
+		PassCounters counters;
+
+		// Casters of a shadow map
+		size_t staticCasterCount = 0u;
+		uint64_t staticCastersHash = 0u;
+		uint64_t dynamicCastersHash = 0u;
+	};
+
 	class RenderManager final : public Singleton<RenderManager>
 	{
 		friend class Singleton<RenderManager>;
@@ -24,65 +116,127 @@ namespace LowRenderer
 		RenderManager();
 		~RenderManager();
 
-		std::unordered_map<GLenum, bool> enabledCaps;
-		std::unordered_map<std::string, std::shared_ptr<UniformBlock>> uniformBlocks;
-
 		std::unordered_set<ColliderRenderer*> colliders;
 		std::unordered_set<SpriteRenderer*> sprites;
 		std::unordered_set<ModelRenderer*> models;
 		std::unordered_set<SkyBox*> skyBoxes;
 		std::unordered_set<Light*> lights;
+		std::unordered_set<Resources::Text*> texts;
 		std::set<Camera*> cameras;
 
+		// Streamed buffer of the texts, filled once per font
+		GLuint textVAO = 0;
+		GLuint textVBO = 0;
+		std::unordered_map<Resources::Font*, std::vector<Resources::TextVertex>> textBatches;
+
+		// Consecutive active sprites that share a program, and their streamed quads
+		std::vector<const SpriteRenderer*> spriteRun;
+		SpriteBatch spriteBatch;
+
 		float minBias = 0.00005;
 		float maxBias = 0.0005;
 
-		void drawColliders() const;
+		// Per draw data and indirect commands of the last uploaded draws
+		GLuint drawBuffer = 0;
+		GLuint indirectBuffer = 0;
+
+		// Submit each run of draws with a single call instead of a call per mesh
+		bool useMultiDrawIndirect = true;
+
+		// Skip the meshes that are outside of the camera and light volumes
+		bool frustumCulling = true;
+
+		// Draw the repeated meshes of a run with a single instanced command
+		bool useInstancing = true;
+
+		// Draw the shadow maps only when their light or their casters change
+		bool cacheShadows = true;
+
+		// Draw the simplified levels of the meshes that are small on the screen
+		bool useLods = true;
+
+		// Skip the meshes of the camera pass hidden behind the biggest occluders
+		bool occlusionCulling = true;
+
+		// Gather and record the passes on the render pool instead of the context thread alone
+		bool parallelRecording = true;
+
+		static constexpr const char* renderPool = "render";
+
+		// Smallest number of renderers or draws given to a task
+		static constexpr size_t minItemsPerTask = 64u;
+
+		// Lights with a slot in the shadow uniforms of the lit programs, the next ones have no shadow
+		static constexpr size_t maxShadowLights = 8u;
+		std::vector<Light*> shadowLights;
+
+		// Lights of the camera frustum, assigned to its clusters once per frame
+		LightClusters lightClusters;
+
+		// Depth of the occluders of the camera, rasterized on the CPU once per frame
+		OcclusionBuffer occlusionBuffer;
+
+		// Draws of the frame, sorted to change the states as rarely as possible
+		RenderQueue cameraQueue;
+		RenderQueue shadowQueue;
+		RenderQueue immediateQueue;
+
+		std::vector<ModelRenderer*> activeModels;
+		std::vector<VisibleDraws> visibleDraws;
+
+		// Commands recorded by each task, replayed in order
+		std::vector<RenderCommandBuffer> commandBuffers;
+		RenderCommandBuffer immediateCommands;
+
+		std::vector<ModelDraw> shadowDraws;
+		std::vector<DrawData> drawDatas;
+		std::vector<DrawElementsIndirectCommand> drawCommands;
+
+		// Index of the command of each uploaded draw
+		std::vector<size_t> drawCommandIndices;
+
+		RenderCounters counters;
+		RenderCounters lastCounters;
+
+		void uploadDraws(const RenderQueue& queue);
+
+		// Record the uploaded draws of a range of the queue, without any GL call
+		void recordDraws(RenderCommandBuffer& commands, const RenderQueue& queue, size_t firstDraw, size_t endDraw, bool useMaterials) const;
+
+		// Replay recorded commands, on the thread of the context only
+		void executeCommands(const RenderCommandBuffer& commands);
+		void sendFrameUniforms(const std::shared_ptr<Resources::ShaderProgram>& program);
+
+		// Number of tasks to split a work between the render pool and the calling thread
+		size_t getTaskCount(size_t itemCount) const;
+
+		// Run the tasks on the render pool and on the calling thread, then wait for all of them
+		static void runTasks(size_t taskCount, const std::function<void(size_t)>& task);
+
+		// Remove the draws added since firstDraw that are outside of the frustum and count them
+		void cullDraws(std::vector<ModelDraw>& draws, size_t firstDraw, const Frustum& frustum, PassCounters& passCounters) const;
+
+		// Importance of the shadow of a light, from zero to one, that chooses the size of its tiles
+		float getShadowImportance(const Light* light) const;
+
+		// Add the shapes of the drawn colliders to the debug lines and draw all the lines of the frame
+		void drawDebugLines(const Core::Maths::mat4& viewProjection);
+
+		// Assign the active lights to the clusters of the camera and upload them
+		void assignLights(const Camera& camera);
+
+		// Rasterize the biggest visible occluders, then remove the visible draws hidden behind them
+		void cullOccluded(const Camera& camera, const Core::Maths::mat4& viewProjection, float projectionScale, size_t gatherTaskCount);
 
 		void drawShadows();
 		void drawSkybox();
 		void drawModels();
 		void drawSprites();
+		void drawTexts();
 
 		template <class C>
 		static void clearComponents();
 
-		template<>
-		static void clearComponents<Light>()
-		{
-			instance()->lights.clear();
-		}
-
-		template<>
-		static void clearComponents<SpriteRenderer>()
-		{
-			instance()->sprites.clear();
-		}
-
-		template<>
-		static void clearComponents<ModelRenderer>()
-		{
-			instance()->models.clear();
-		}
-
-		template<>
-		static void clearComponents<Camera>()
-		{
-			instance()->cameras.clear();
-		}
-
-		template<>
-		static void clearComponents<SkyBox>()
-		{
-			instance()->skyBoxes.clear();
-		}
-
-		template<>
-		static void clearComponents<ColliderRenderer>()
-		{
-			instance()->colliders.clear();
-		}
-
 	public:
 		static void GLSetCapState(const GLenum cap, bool state);
 		static void GLEnable(const GLenum cap);
@@ -92,21 +246,77 @@ namespace LowRenderer
 
 		static void draw();
 
+		// Counters of the frame being drawn, complete once draw has returned
+		static const RenderCounters& getFrameCounters();
+
+		// Draw a list of meshes with the bound program, batched by material and instanced by mesh
+		static void drawModelDraws(const std::shared_ptr<Resources::ShaderProgram>& program, const std::vector<ModelDraw>& draws, bool useMaterials = true);
+
+		// Draw sprites with the bound program, their quads streamed in one buffer and drawn with one call per texture
+		static void drawSpriteBatch(const std::shared_ptr<Resources::ShaderProgram>& program, const std::vector<const SpriteRenderer*>& sprites);
+
 		static void linkComponent(Light* compToLink);
 		static void linkComponent(ModelRenderer* compToLink);
 		static void linkComponent(SpriteRenderer* compToLink);
 		static void linkComponent(Camera* compToLink);
 		static void linkComponent(ColliderRenderer* compToLink);
 		static void linkComponent(SkyBox* compToLink);
+		static void linkComponent(Resources::Text* compToLink);
 
 		static void removeComponent(ColliderRenderer* compToRemove);
 		static void removeComponent(SpriteRenderer* compToRemove);
 		static void removeComponent(ModelRenderer* compToRemove);
+		static void removeComponent(Resources::Text* compToRemove);
 
 		static void clearAll();
 
-		static void bindUBO(Resources::ShaderProgram* program, const std::string& UBOName);
-
 		static void drawImGui();
 	};
+
+	template<>
+	inline void RenderManager::clearComponents<Light>()
+	{
+		instance()->lights.clear();
+	}
+
+	template<>
+	inline void RenderManager::clearComponents<SpriteRenderer>()
+	{
+		instance()->sprites.clear();
+		instance()->spriteRun.clear();
+
+		// The atlas keeps the textures of the sprites alive
+		instance()->spriteBatch.clear();
+	}
+
+	template<>
+	inline void RenderManager::clearComponents<ModelRenderer>()
+	{
+		instance()->models.clear();
+	}
+
+	template<>
+	inline void RenderManager::clearComponents<Camera>()
+	{
+		instance()->cameras.clear();
+	}
+
+	template<>
+	inline void RenderManager::clearComponents<SkyBox>()
+	{
+		instance()->skyBoxes.clear();
+	}
+
+	template<>
+	inline void RenderManager::clearComponents<ColliderRenderer>()
+	{
+		instance()->colliders.clear();
+	}
+
+	template<>
+	inline void RenderManager::clearComponents<Resources::Text>()
+	{
+		instance()->texts.clear();
+		instance()->textBatches.clear();
+	}
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+
+#include "model.hpp"
+
+namespace Resources
+{
+	class ShaderProgram;
+}
+
+namespace LowRenderer
+{
+	// Draw of the queue with its packed sort key
+	struct RenderQueueItem
+	{
+		// Pass, program, material, face culling, mesh and depth, from the most to the least significant bits
+		uint64_t key = 0u;
+
+		uint32_t drawIndex = 0u;
+		uint32_t programIndex = 0u;
+		uint32_t pass = 0u;
+	};
+
+	// Draws of a frame, radix sorted to bind each state only when it changes
+	class RenderQueue
+	{
+	private:
+		std::vector<RenderQueueItem> items;
+		std::vector<RenderQueueItem> sortedItems;
+
+		std::vector<ModelDraw> draws;
+		std::vector<ModelDraw> sortedDraws;
+
+		// Small identifiers given to the states in the order they are pushed
+		std::vector<std::shared_ptr<Resources::ShaderProgram>> programs;
+		std::unordered_map<Resources::ShaderProgram*, uint32_t> programIDs;
+		std::unordered_map<const Resources::Material*, uint32_t> materialIDs;
+		std::unordered_map<const Resources::Mesh*, uint32_t> meshIDs;
+
+		float maxDepth = 1.f;
+
+	public:
+		// Depths are quantized between zero and maxDepth
+		void clear(float maxDepth);
+
+		void push(uint32_t pass, const std::shared_ptr<Resources::ShaderProgram>& program, const ModelDraw& draw, float depth);
+
+		void sort();
+
+		// Draws in the sorted order
+		const std::vector<ModelDraw>& getDraws() const;
+		size_t size() const;
+
+		uint32_t getPass(size_t index) const;
+		const std::shared_ptr<Resources::ShaderProgram>& getProgram(size_t index) const;
+
+		// Check if two draws share their pass and their program
+		bool isSameRun(size_t lhs, size_t rhs) const;
+
+		// End of the run of draws that share the pass and the program of the first one
+		size_t getRunEnd(size_t first) const;
+	};
+}
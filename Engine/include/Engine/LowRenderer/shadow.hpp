@@ -1,43 +1,111 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include <cstdint>
 
 #include "shader.hpp"
 #include "light.hpp"
+#include "shadow_atlas.hpp"
+#include "model.hpp"
 
 namespace LowRenderer
 {
+	// Atlas that the shadow pass draws in
+	enum class ShadowTarget : uint32_t
+	{
+		// Tiles of the atlas read by the lights, cleared
+		MAP,
+
+		// Tiles of the static atlas, cleared
+		STATIC_MAP,
+
+		// Tiles of the atlas read by the lights, filled with the static atlas
+		MAP_FROM_STATIC,
+	};
+
+	// Casters that the shadow pass draws in the map of a light this frame
+	enum class ShadowUpdate
+	{
+		// The map has not changed since the last frame
+		NONE,
+
+		// Every caster, in the cleared map
+		ALL_CASTERS,
+
+		// The dynamic casters, over the baked static map
+		DYNAMIC_CASTERS,
+
+		// The static casters baked in the static map, then the dynamic ones over it
+		STATIC_THEN_DYNAMIC_CASTERS,
+	};
+
+	// Hashes of the view and of the casters drawn in the map of a pass
+	struct ShadowCache
+	{
+		bool isCached = false;
+		bool isStaticMapValid = false;
+		uint64_t viewHash = 0u;
+		uint64_t staticHash = 0u;
+		uint64_t dynamicHash = 0u;
+	};
+
 	class Shadow
 	{
 	protected:
 		Shadow(const std::string& shaderProgramName);
 		Shadow() = default;
 
-		unsigned int shadowWidth = 2048;
-		unsigned int shadowHeight = 2048;
-		float superSample = 4.f;
-		float aspect = 0.f;
+		// Tile of each view in the shadow atlas, empty tiles are not drawn
+		std::vector<AtlasTile> tiles;
 
-		GLuint FBO = 0;
+		std::vector<ShadowCache> caches;
 
 	public:
-		~Shadow();
+		virtual ~Shadow() = default;
 
-		// Depth map
-		unsigned int ID = 0;
 		std::shared_ptr<Resources::ShaderProgram> program = nullptr;
 
-		void virtual generateBuffer() = 0;
-		void virtual generateTexture() = 0;
-		void virtual attachTextureToBuffer() = 0;
+		// Update the matrices of the light, called once per frame
+		void virtual compute(const LowRenderer::Light* light) { }
+
+		// Send the matrices of a pass to the depth program
+		void virtual sendToShader(const LowRenderer::Light* light, size_t pass) const = 0;
+
+		// Send the tiles of the views, in texture coordinates, to a program that reads the atlas
+		void virtual sendToLitProgram(const std::shared_ptr<Resources::ShaderProgram>& program, int lightIndex) const;
+
+		// Views of a light in the tiles sent to the programs
+		static constexpr int maxViewCount = 6;
+
+		// Number of views drawn in the atlas, and the size of their tiles for the most important lights
+		GLsizei virtual getViewCount() const = 0;
+		GLsizei virtual getMaxTileSize() const = 0;
+
+		// Views drawn with their own casters, each pass draws the same number of views
+		size_t virtual getPassCount() const { return 1u; }
+
+		// Check if a mesh casts a shadow in the views of a pass, and give its depth to sort the casters
+		bool virtual isCaster(size_t pass, const ModelDraw& draw, float& depth) const = 0;
+
+		// Hash of the matrices of a pass, changed when its views move
+		uint64_t virtual getPassHash(size_t pass) const = 0;
+
+		// Keep the tiles given by the atlas, the cached maps are lost when they move
+		void setTiles(const std::vector<AtlasTile>& newTiles);
+		const std::vector<AtlasTile>& getTiles() const;
 
-		void virtual create() = 0;
+		// Hash of the casters of a map, changed when a caster moves, appears or disappears
+		static constexpr uint64_t emptyCastersHash = 14695981039346656037ull;
+		static uint64_t hashCaster(uint64_t castersHash, const void* mesh, uint32_t lod, const Core::Maths::mat4& model);
 
-		void virtual sendToShader(const LowRenderer::Light* light) const = 0;
+		// Compare the views of a pass and its casters with the ones of its last drawn map
+		ShadowUpdate getUpdate(size_t pass, uint64_t staticCastersHash, size_t staticCasterCount, uint64_t dynamicCastersHash, size_t dynamicCasterCount);
 
-		bool bindAndSetViewport();
-		void unbindAndResetViewport();
+		// Redraw the maps of all the passes on the next frame
+		void invalidateCache();
 
-		float getAspect() const;
+		// Bind an atlas with a viewport per view of a pass, the cleared tiles are cleared
+		bool bindTarget(size_t pass, ShadowTarget target);
 	};
 }
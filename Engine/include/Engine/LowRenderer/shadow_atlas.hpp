@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "singleton.hpp"
+
+namespace LowRenderer
+{
+	class Shadow;
+
+	// Square region of the atlas, in texels
+	struct AtlasTile
+	{
+		GLint x = 0;
+		GLint y = 0;
+		GLsizei size = 0;
+	};
+
+	bool operator==(const AtlasTile& lhs, const AtlasTile& rhs);
+	bool operator!=(const AtlasTile& lhs, const AtlasTile& rhs);
+
+	// Views of a shadow waiting for their tiles
+	struct AtlasRequest
+	{
+		Shadow* shadow = nullptr;
+		GLsizei tileSize = 0;
+	};
+
+	// Depth texture shared by all the shadows, each view of a light is drawn in a tile of it
+	class ShadowAtlas final : public Singleton<ShadowAtlas>
+	{
+		friend class Singleton<ShadowAtlas>;
+
+	private:
+		ShadowAtlas();
+		~ShadowAtlas();
+
+		GLuint FBO = 0u;
+		GLuint ID = 0u;
+
+		// Static casters of the cached shadows, at the same place as in the atlas
+		GLuint staticFBO = 0u;
+		GLuint staticID = 0u;
+
+		// Free squares of the quadtree, split in four to get smaller tiles
+		std::vector<AtlasTile> freeTiles;
+
+		std::vector<AtlasRequest> requests;
+
+		// Halvings of all the tiles needed to fit the last requests
+		int downscale = 0;
+		size_t usedArea = 0u;
+
+		void createTexture(GLuint& framebuffer, GLuint& texture);
+
+		bool allocate(GLsizei size, AtlasTile& tile);
+		bool allocateRequests(int downscale, std::vector<AtlasTile>& tiles);
+
+	public:
+		static constexpr GLsizei atlasSize = 8192;
+		static constexpr GLsizei minTileSize = 128;
+
+		// Remove the requests of the last frame
+		static void begin();
+
+		// Ask for the tiles of the views of a shadow, from zero to one, the less important ones get smaller tiles
+		static void request(Shadow* shadow, float importance);
+
+		// Pack the requests from the biggest tiles to the smallest, then give their tiles to the shadows
+		static void pack();
+
+		static GLuint getID();
+		static GLuint getFramebuffer(bool isStatic);
+
+		// Fill a tile of the atlas with the same tile of the static atlas
+		static void copyFromStatic(const AtlasTile& tile);
+
+		static void drawImGui();
+	};
+}
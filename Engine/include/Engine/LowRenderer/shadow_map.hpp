@@ -1,20 +1,55 @@
 #pragma once
 
+#include <vector>
+
 #include "shadow.hpp"
+#include "frustum.hpp"
 
 namespace LowRenderer
 {
+	// Shadow of a directional light, split in cascades that fit the slices of the camera frustum
 	class ShadowMap : public Shadow
 	{
 	private:
-		void generateBuffer() override;
-		void generateTexture() override;
-		void attachTextureToBuffer() override;
+		// Light space of all the cascades, giving the position on the light plane and the depth from zero to one
+		Core::Maths::mat4 cascadeSpace;
+
+		// Center and radius of each cascade on the light plane, with the view depth where it ends
+		std::vector<Core::Maths::vec4> cascadeSpheres;
+
+		std::vector<Core::Maths::mat4> cascadeMatrices;
+		std::vector<Frustum> cascadeFrustums;
+
 	public:
+		static constexpr int maxCascadeCount = 4;
+
+		int cascadeCount = 4;
+
+		// View depth covered by the cascades
+		float shadowDistance = 100.f;
+
+		// Mix between the uniform splits, at zero, and the logarithmic splits, at one
+		float splitLambda = 0.75f;
+
+		// Distance towards the light where the meshes still cast shadows on the cascades
+		float casterDistance = 100.f;
+
 		ShadowMap();
 
-		void create() override;
+		void compute(const LowRenderer::Light* light) override;
+
+		const Core::Maths::mat4& getCascadeSpace() const;
+
+		void sendToShader(const LowRenderer::Light* light, size_t pass) const override;
+		void sendToLitProgram(const std::shared_ptr<Resources::ShaderProgram>& program, int lightIndex) const override;
+
+		GLsizei getViewCount() const override;
+		GLsizei getMaxTileSize() const override;
+
+		size_t getPassCount() const override;
+		bool isCaster(size_t pass, const ModelDraw& draw, float& depth) const override;
+		uint64_t getPassHash(size_t pass) const override;
 
-		void sendToShader(const LowRenderer::Light* light) const override;
+		void drawImGui();
 	};
 }
\ No newline at end of file
@@ -11,14 +11,29 @@ namespace LowRenderer
 	class ShadowPoint : public Shadow
 	{
 	private:
-		void generateBuffer() override;
-		void generateTexture() override;
-		void attachTextureToBuffer() override;
+		// Matrices of the six faces, rebuilt when the light moves
+		Core::Maths::vec3 matricesPosition;
+		Core::Maths::mat4 shadowTransforms[6];
+		bool hasMatrices = false;
+
 	public:
+		// Range of the point light shadows
+		static constexpr float farPlane = 25.f;
+
 		ShadowPoint();
 
-		void create() override;
+		// Projections of the faces of a light at the origin, in the order +X, -X, +Y, -Y, +Z, -Z
+		static const Core::Maths::mat4* getFaceMatrices();
+
+		void compute(const LowRenderer::Light* light) override;
+
+		void sendToShader(const LowRenderer::Light* light, size_t pass) const override;
+		void sendToLitProgram(const std::shared_ptr<Resources::ShaderProgram>& program, int lightIndex) const override;
+
+		GLsizei getViewCount() const override;
+		GLsizei getMaxTileSize() const override;
 
-		void sendToShader(const LowRenderer::Light* light) const override;
+		bool isCaster(size_t pass, const ModelDraw& draw, float& depth) const override;
+		uint64_t getPassHash(size_t pass) const override;
 	};
 }
\ No newline at end of file
@@ -24,7 +24,7 @@ namespace LowRenderer
 
 		std::string toString() const override;
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 
 		void sendToProgram(std::shared_ptr<Resources::ShaderProgram> program) const;
 	};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include <glad/glad.h>
+
+#include "maths.hpp"
+
+namespace Resources
+{
+	class Texture;
+	class ShaderProgram;
+}
+
+namespace LowRenderer
+{
+	class SpriteRenderer;
+
+	struct SpriteVertex
+	{
+		Core::Maths::vec3 position;
+
+		// Tilled coordinates, repeated inside the region of the texture
+		Core::Maths::vec2 texCoords;
+		Core::Maths::vec4 color;
+
+		// Corner and size of the region of the texture in the bound one, in texture coordinates
+		Core::Maths::vec4 region;
+	};
+
+	// Quads of the sprites streamed in one buffer, their textures copied in a shared atlas to draw them together
+	class SpriteBatch
+	{
+	private:
+		// Texture of the sprites and its place in the atlas
+		struct AtlasEntry
+		{
+			std::shared_ptr<Resources::Texture> texture;
+
+			// Upload and size of the texture when it was copied
+			unsigned int uploadCount = 0u;
+			int width = 0;
+			int height = 0;
+
+			bool isPacked = false;
+			int x = 0;
+			int y = 0;
+
+			// Drawn since the last prune
+			bool isUsed = true;
+		};
+
+		struct SpriteQuad
+		{
+			SpriteVertex vertices[6];
+			size_t entryIndex = 0u;
+
+			// Texture bound to draw the quad, the atlas or the texture itself if it is not packed
+			GLuint textureID = 0u;
+		};
+
+		GLuint VAO = 0u;
+		GLuint VBO = 0u;
+		GLuint atlasID = 0u;
+
+		std::vector<AtlasEntry> entries;
+		std::unordered_map<const Resources::Texture*, size_t> entryIndices;
+
+		// Pack all the textures again before the next draw
+		bool isAtlasDirty = false;
+
+		std::vector<SpriteQuad> quads;
+		std::vector<SpriteVertex> vertices;
+
+		void createBuffers();
+
+		// Pack the textures of the entries and copy them in the atlas, the ones that do not fit keep their own texture
+		void packAtlas();
+
+	public:
+		static constexpr GLsizei atlasSize = 2048;
+
+		~SpriteBatch();
+
+		// Remove the entries no sprite used since the last call, once per frame before the sprites are added
+		void pruneEntries();
+
+		// Remove the quads of the last draw
+		void begin();
+
+		// Add the quad of a sprite, a new texture is packed in the atlas on the next draw
+		void addSprite(const SpriteRenderer& sprite);
+
+		// Upload the quads in one buffer and draw them in order, with one call each time the bound texture changes, give the number of calls
+		unsigned int draw(const std::shared_ptr<Resources::ShaderProgram>& program);
+
+		// Release the textures kept by the atlas, when the scene is unloaded
+		void clear();
+
+		size_t getSpriteCount() const;
+	};
+}
@@ -2,14 +2,13 @@
 
 #include "renderer.hpp"
 #include "texture.hpp"
-#include "mesh.hpp"
+#include "sprite_batch.hpp"
 
 namespace LowRenderer
 {
 	class SpriteRenderer : public Renderer
 	{
 	private:
-		std::shared_ptr<Resources::Mesh> mesh = nullptr;
 		std::shared_ptr<Resources::Texture> texture = nullptr;
 
 		float tillingMultiplier = 1.f;
@@ -25,11 +24,16 @@ namespace LowRenderer
 		SpriteRenderer(Engine::Entity& owner, const std::string& shaderPromgramName);
 
 		std::string getTexturePath();
+		const std::shared_ptr<Resources::Texture>& getTexture() const;
 
 		void draw() const override;
+
+		// Write the two triangles of the sprite, the batch fills the region of its texture
+		void addQuad(SpriteVertex* vertices) const;
+
 		void drawImGui() override;
 		std::string toString() const override;
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 	};
 }
\ No newline at end of file
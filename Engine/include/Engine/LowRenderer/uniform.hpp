@@ -2,38 +2,195 @@
 
 #include <glad/glad.h>
 
+#include <string_view>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "maths.hpp"
+#include "color.hpp"
+#include "gl_state_cache.hpp"
+
 namespace LowRenderer
 {
+	// Uniforms are found by the hash of their name instead of the name itself
+	using UniformID = uint64_t;
+
+	// FNV-1a hash of a uniform name, computed at compile time for the constant names
+	constexpr UniformID hashUniformName(std::string_view name)
+	{
+		UniformID hash = 14695981039346656037ull;
+
+		for (char c : name)
+		{
+			hash ^= (unsigned char)c;
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	// ID of an element of an array of uniforms, like shadowTiles[index]
+	constexpr UniformID getElementID(UniformID arrayID, int index)
+	{
+		return (arrayID ^ ((UniformID)index + 1ull)) * 1099511628211ull;
+	}
+
+	// Keep the name of a uniform to log it instead of its ID, only in the debug builds
+	void registerUniformName(UniformID ID, const std::string& name);
+
+	// Name registered for an ID, or the ID itself when it is unknown
+	std::string getUniformName(UniformID ID);
+
+	// IDs of the uniforms sent by the engine
+	namespace UniformIDs
+	{
+		constexpr UniformID model = hashUniformName("model");
+		constexpr UniformID color = hashUniformName("color");
+		constexpr UniformID tilling = hashUniformName("tilling");
+		constexpr UniformID proj = hashUniformName("proj");
+		constexpr UniformID viewProj = hashUniformName("viewProj");
+		constexpr UniformID viewOrtho = hashUniformName("viewOrtho");
+		constexpr UniformID viewPos = hashUniformName("viewPos");
+
+		constexpr UniformID minBias = hashUniformName("minBias");
+		constexpr UniformID maxBias = hashUniformName("maxBias");
+		constexpr UniformID farPlane = hashUniformName("farPlane");
+		constexpr UniformID lightPos = hashUniformName("lightPos");
+		constexpr UniformID lightSpaceMatrix = hashUniformName("lightSpaceMatrix");
+
+		constexpr UniformID shadowSpaceMatrices = hashUniformName("shadowSpaceMatrices");
+		constexpr UniformID clusterScale = hashUniformName("clusterScale");
+		constexpr UniformID ambientLight = hashUniformName("ambientLight");
+		constexpr UniformID shadowAtlas = hashUniformName("shadowAtlas");
+		constexpr UniformID shadowTiles = hashUniformName("shadowTiles");
+		constexpr UniformID shadowCascades = hashUniformName("shadowCascades");
+		constexpr UniformID pointFaceMatrices = hashUniformName("pointFaceMatrices");
+		constexpr UniformID shadowMatrices = hashUniformName("shadowMatrices");
+
+		constexpr UniformID materialAmbient = hashUniformName("material.ambient");
+		constexpr UniformID materialDiffuse = hashUniformName("material.diffuse");
+		constexpr UniformID materialSpecular = hashUniformName("material.specular");
+		constexpr UniformID materialEmissive = hashUniformName("material.emissive");
+		constexpr UniformID materialShininess = hashUniformName("material.shininess");
+		constexpr UniformID materialRefractiveIndex = hashUniformName("material.refractiveIndex");
+
+		constexpr UniformID diffuseTex = hashUniformName("diffuseTex");
+		constexpr UniformID text = hashUniformName("text");
+		constexpr UniformID sdf = hashUniformName("sdf");
+		constexpr UniformID cubemap = hashUniformName("cubemap");
+		constexpr UniformID environmentMap = hashUniformName("environmentMap");
+	}
+
+	// Sixteen floats read as the columns of a matrix, to pack several values in one uniform
+	struct PackedMat4
+	{
+		float e[16];
+	};
+
+	// Upload of a type of value, chosen at compile time
+	template <typename T>
+	struct UniformSetter;
+
+	template <>
+	struct UniformSetter<int>
+	{
+		static void set(GLint location, int count, const int* value) { glUniform1iv(location, count, value); }
+	};
+
+	template <>
+	struct UniformSetter<float>
+	{
+		static void set(GLint location, int count, const float* value) { glUniform1fv(location, count, value); }
+	};
+
+	template <>
+	struct UniformSetter<Core::Maths::vec2>
+	{
+		static void set(GLint location, int count, const Core::Maths::vec2* value) { glUniform2fv(location, count, value->e); }
+	};
+
+	template <>
+	struct UniformSetter<Core::Maths::vec3>
+	{
+		static void set(GLint location, int count, const Core::Maths::vec3* value) { glUniform3fv(location, count, value->e); }
+	};
+
+	template <>
+	struct UniformSetter<Core::Maths::vec4>
+	{
+		static void set(GLint location, int count, const Core::Maths::vec4* value) { glUniform4fv(location, count, value->e); }
+	};
+
+	template <>
+	struct UniformSetter<Color>
+	{
+		static void set(GLint location, int count, const Color* value) { glUniform4fv(location, count, value->data.e); }
+	};
+
+	// The matrices of the engine are row major
+	template <>
+	struct UniformSetter<Core::Maths::mat4>
+	{
+		static void set(GLint location, int count, const Core::Maths::mat4* value) { glUniformMatrix4fv(location, count, GL_TRUE, value->e); }
+	};
+
+	template <>
+	struct UniformSetter<PackedMat4>
+	{
+		static void set(GLint location, int count, const PackedMat4* value) { glUniformMatrix4fv(location, count, GL_FALSE, value->e); }
+	};
+
 	class Uniform
 	{
 		GLint  location;
 		GLenum type;
 
-		void* currentValue = nullptr;
-		size_t typeSize = 0u;
+		// Shadow copy of the last value sent to the program
+		mutable std::vector<unsigned char> currentValue;
 
 	public:
 		Uniform() = default;
 		Uniform(GLint location, GLenum type);
 
-		bool bind(const void* value, int count, bool transpose) const;
+		template <typename T>
+		bool set(const T* value, int count) const
+		{
+			if (location < 0)
+				return false;
 
-		bool areSame(const void* value);
-	};
+			// An array is always sent, the copy of each element is forgotten by the program
+			if (count > 1)
+			{
+				currentValue.clear();
 
-	class UniformBlock
-	{
-		GLuint	bindingPoint;
-		GLuint	UBO;
+				UniformSetter<T>::set(location, count, value);
+				GLStateCache::countUniform(false);
 
-	public:
-		UniformBlock() = default;
-		UniformBlock(GLuint bindingPoint, GLsizei UBOsize);
-		~UniformBlock();
+				return true;
+			}
+
+			// The program keeps its uniforms, skip the values that it already has
+			if (areSame(value, sizeof(T)))
+			{
+				GLStateCache::countUniform(true);
+				return true;
+			}
+
+			currentValue.assign((const unsigned char*)value, (const unsigned char*)value + sizeof(T));
+
+			UniformSetter<T>::set(location, count, value);
+			GLStateCache::countUniform(false);
+
+			return true;
+		}
+
+		GLint getLocation() const;
+		GLenum getType() const;
 
-		void bind();
-		void unbind();
+		bool areSame(const void* value, size_t size) const;
 
-		GLuint getBindingPoint() const;
+		// Send the next value even if it is the same as the last one
+		void resetValue() const;
 	};
-}
\ No newline at end of file
+}
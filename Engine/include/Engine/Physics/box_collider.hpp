@@ -22,6 +22,6 @@ namespace Physics
 
 		std::string toString() const override;
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 	};
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 #include "collision.hpp"
 #include "maths.hpp"
 
+#define CONTACT_COLOR Core::Maths::vec3(1.f, 0.f, 0.f)
+
 namespace Physics
 {
 	class Collider : public Engine::Component
@@ -35,6 +37,9 @@ namespace Physics
 		void computeCollisionCallback(bool hasHit, const Collision& collision);
 		void computeTriggerCallback(bool hasHit, Collider* collider);
 
+		// Add the points and normals of the current collisions to the debug lines
+		void drawContacts() const;
+
 		void drawImGui() override;
 
 		virtual void updateShape() = 0;
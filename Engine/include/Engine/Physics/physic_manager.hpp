@@ -42,20 +42,20 @@ namespace Physics
 		template <class C>
 		static void clearComponents();
 
-		template<>
-		static void clearComponents<SphereCollider>()
-		{
-			instance()->sphereColliders.clear();
-			instance()->lastSphereRigidbodyIndex = 0;
-		}
-
-		template<>
-		static void clearComponents<BoxCollider>()
-		{
-			instance()->boxColliders.clear();
-			instance()->lastBoxRigidbodyIndex = 0;
-		}
-
 		static void update();
 	};
+
+	template<>
+	inline void PhysicManager::clearComponents<SphereCollider>()
+	{
+		instance()->sphereColliders.clear();
+		instance()->lastSphereRigidbodyIndex = 0;
+	}
+
+	template<>
+	inline void PhysicManager::clearComponents<BoxCollider>()
+	{
+		instance()->boxColliders.clear();
+		instance()->lastBoxRigidbodyIndex = 0;
+	}
 }
\ No newline at end of file
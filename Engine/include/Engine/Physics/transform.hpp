@@ -234,6 +234,6 @@ namespace Physics
 
 		std::string toString() const override;
 
-		static void parseComponent(Engine::Entity& entity, std::istringstream& iss, std::string& parentName);
+		static void parseComponent(Engine::Entity& entity, Engine::ComponentReader& iss, std::string& parentName);
 	};
 }
\ No newline at end of file
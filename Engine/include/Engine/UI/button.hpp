@@ -44,7 +44,7 @@ namespace UI
 		void drawImGui() override;
 		std::string toString() const override;
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 
 		LowRenderer::SpriteRenderer* getSprite();
 	};
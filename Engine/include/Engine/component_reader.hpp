@@ -0,0 +1,35 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Engine
+{
+	// Arguments of a component, read from a text line or from the typed words of a binary scene
+	class ComponentReader
+	{
+	private:
+		std::istringstream* stream = nullptr;
+
+		const uint32_t* words = nullptr;
+		const uint32_t* wordsEnd = nullptr;
+		const std::vector<std::string>* strings = nullptr;
+
+		// Take the next word of a binary component, false once they are all read like a stream at its end
+		bool readWord(uint32_t& word);
+
+	public:
+		ComponentReader(std::istringstream& stream);
+		ComponentReader(const uint32_t* words, size_t wordCount, const std::vector<std::string>& strings);
+
+		ComponentReader& operator>>(float& value);
+		ComponentReader& operator>>(int& value);
+		ComponentReader& operator>>(bool& value);
+		ComponentReader& operator>>(std::string& value);
+
+		// Rest of the line, without its leading spaces
+		void readLine(std::string& line);
+	};
+}
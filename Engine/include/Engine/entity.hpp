@@ -7,6 +7,7 @@
 
 #include "object.hpp"
 #include "collision.hpp"
+#include "component_reader.hpp"
 
 #include "debug.hpp"
 
@@ -19,11 +20,47 @@ namespace Engine
 {
 	class Component;
 
+	// Type of the components that can be parsed from a scene or a recipe
+	enum class ComponentType : unsigned short
+	{
+		NONE,
+		TRANSFORM,
+		RIGIDBODY,
+		BOXCOLLIDER,
+		SPHERECOLLIDER,
+		MODELRENDERER,
+		CAMERA,
+		LIGHT,
+		SKYBOX,
+		SPRITERENDERER,
+		TEXT,
+		PLAYERMOVEMENT,
+		PLAYERSTATE,
+		PLAYERLIFE,
+		PLAYERSHOOTING,
+		ENEMYMOVEMENT,
+		ENEMYSTATE,
+		ENEMYLIFE,
+		LIFEBAR,
+		AMMOCOUNTER,
+		MAINMENU,
+		LOSESCREEN,
+		WINSCREEN,
+		PAUSESCREEN,
+		GAMEMASTER,
+		CAMERAMOVEMENT,
+		BUTTON,
+		BULLETHOLE,
+		NOCLIPMOVEMENT,
+		MEDKIT
+	};
+
 	class Entity : public Object
 	{
 	private:
 
 	public:
+		// Static entities never move, their meshes are baked in the cached shadow maps
 		bool isStatic = false;
 
 		std::string m_name = "Entity";
@@ -104,6 +141,9 @@ namespace Engine
 
 		std::string toString();
 
+		static ComponentType getComponentType(const std::string& typeName);
+
+		void parseComponent(ComponentType type, ComponentReader& iss, std::string& parentName);
 		void parseComponents(std::istringstream& parseComponent, std::string& parentName);
 		void parseRecipe(const std::string& filePath, std::string& parentName);
 		void parse(std::istream& scnStream, std::string& parentName);
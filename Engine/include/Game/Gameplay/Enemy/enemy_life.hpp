@@ -22,7 +22,7 @@ namespace Gameplay
 
 		std::string toString() const override;
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 
 		void onCollisionEnter(const Physics::Collision& collision) override {}
 		void onCollisionExit(const Physics::Collision& collision) override {}
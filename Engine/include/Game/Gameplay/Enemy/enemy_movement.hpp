@@ -19,7 +19,7 @@ namespace Gameplay
 
 		std::string toString() const override;
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 
 		void onTriggerEnter(Physics::Collider* collider) override;
 		void onTriggerExit(Physics::Collider* collider) override;
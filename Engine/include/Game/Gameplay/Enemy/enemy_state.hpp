@@ -27,7 +27,7 @@ namespace Gameplay
 
 		std::string toString() const override;
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 
 		void hurtPlayer();
 		void onCollisionEnter(const Physics::Collision& collision) override;
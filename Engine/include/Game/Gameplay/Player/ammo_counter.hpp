@@ -33,6 +33,6 @@ namespace Gameplay
         void reload();
 
         std::string toString() const override;
-        static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+        static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
     };
 }
@@ -53,7 +53,7 @@ namespace Gameplay
 		void update() override;
 		void drawImGui() override;
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 
 		Core::Timer timer;
 	};
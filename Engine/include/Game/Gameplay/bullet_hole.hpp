@@ -17,6 +17,6 @@ namespace Gameplay
 		void start() override;
 		void update() override;
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 	};
 }
\ No newline at end of file
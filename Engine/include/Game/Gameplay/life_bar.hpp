@@ -20,6 +20,6 @@ namespace Gameplay
 
         std::string toString() const;
 
-        static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+        static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
     };
 }
\ No newline at end of file
@@ -28,6 +28,6 @@ namespace Gameplay
 		void removePlayer();
 
 		std::string toString() const override;
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 	};
 }
\ No newline at end of file
@@ -19,6 +19,6 @@ namespace Gameplay
 	
 		std::string toString() const override;
 	
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 	};
 }
\ No newline at end of file
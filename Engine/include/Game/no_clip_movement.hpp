@@ -29,5 +29,5 @@ public:
 	void fixedUpdate() override;
 	void update() override;
 
-	static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+	static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 };
\ No newline at end of file
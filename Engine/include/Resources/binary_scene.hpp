@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Engine
+{
+	class Entity;
+}
+
+namespace Resources
+{
+	class Scene;
+
+	struct BinarySceneHeader
+	{
+		char magic[4] = { 'L', 'S', 'C', 'B' };
+		uint32_t version = 3u;
+
+		uint32_t stringCount = 0u;
+		uint32_t stringBytes = 0u;
+		uint32_t recipeCount = 0u;
+		uint32_t entityCount = 0u;
+		uint32_t componentCount = 0u;
+		uint32_t wordCount = 0u;
+	};
+
+	// Components of a recipe, shared by all the entities that use it
+	struct BinaryRecipe
+	{
+		uint32_t pathIndex = 0u;
+		uint32_t firstComponent = 0u;
+		uint32_t componentCount = 0u;
+	};
+
+	struct BinaryEntity
+	{
+		// The entity never moves, like the STATIC keyword of the text format
+		static constexpr uint32_t staticFlag = 1u << 0;
+
+		uint32_t nameIndex = 0u;
+		uint32_t firstComponent = 0u;
+		uint32_t componentCount = 0u;
+		uint32_t flags = 0u;
+	};
+
+	// Arguments of a component stored as 32 bits words: floats by their bits, integers and booleans by their value, strings by their index
+	struct BinaryComponent
+	{
+		uint16_t type = 0u;
+		uint16_t wordCount = 0u;
+		uint32_t firstWord = 0u;
+	};
+
+	struct BinarySceneData
+	{
+		BinarySceneHeader header;
+
+		std::vector<std::string> strings;
+		std::vector<BinaryRecipe> recipes;
+		std::vector<BinaryEntity> entities;
+		std::vector<BinaryComponent> components;
+		std::vector<uint32_t> words;
+	};
+
+	// Compact binary encoding of the .scn and .recipe text formats
+	class BinaryScene
+	{
+	private:
+		// Component record that instantiates the recipe stored in its first word
+		static constexpr uint16_t recipeComponentType = 0xFFFF;
+
+		static bool read(const std::string& filePath, BinarySceneData& data);
+		static bool write(const std::string& filePath, const BinarySceneData& data);
+		static bool isValid(const BinarySceneData& data);
+
+		static void instantiateComponents(Engine::Entity& owner, const BinarySceneData& data, uint32_t firstComponent, uint32_t componentCount, std::string& parentName);
+
+		// Write a text scene of groups of eight entities, the first one being the parent of the others and having a collider
+		static bool generate(const std::string& scenePath, int entityCount);
+
+	public:
+		static const std::string extension;
+
+		static bool isBinaryScene(const std::string& filePath);
+		static std::string getBinaryPath(const std::string& scenePath);
+
+		// Convert a text scene, and the recipes it uses, to the binary format
+		static bool convert(const std::string& scenePath, const std::string& binaryPath);
+
+		// Instantiate the entities of a binary scene without parsing any text
+		static bool load(Scene& scene, const std::string& filePath);
+
+		// Compare the instantiation of a generated scene in both formats, averaged over a number of runs
+		static void benchmark(int entityCount = 50000, int runCount = 10);
+	};
+}
@@ -1,45 +1,106 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include <glad/glad.h>
+
 #include "maths.hpp"
 #include "component.hpp"
-#include "shader.hpp"
+#include "resource.hpp"
 
 namespace Resources
 {
 	struct Character
 	{
-		unsigned int ID;
 		Core::Maths::vec2 size;
 		Core::Maths::vec2 bearing;
-		unsigned int advance;
+		Core::Maths::vec2 uvMin;
+		Core::Maths::vec2 uvMax;
+		float advance;
+	};
+
+	struct TextVertex
+	{
+		// Screen position in xy and atlas coordinates in zw
+		Core::Maths::vec4 positionUV;
+		Core::Maths::vec4 color;
 	};
 
-	class Font
+	class Font : public Resource
 	{
 	private:
 		std::unordered_map<char, Character> charMap;
+
+		std::vector<unsigned char> atlasBuffer;
+		int atlasSize = 0;
+
+		GLuint atlasID = 0;
+
+		int pixelSize = 48;
+		bool isSDF = false;
+
+		float lineHeight = 0.f;
+
+		// Distance in pixels encoded around each signed distance field glyph
+		static constexpr int distanceSpread = 6;
+
+		void mainThreadInitialization() override;
+
 	public:
-		Font(const std::string& path);
+		Font(const std::string& path, int pixelSize, bool isSDF);
+		~Font();
+
+		bool generateAtlas();
+		bool generateID();
+
+		GLuint getID() const;
+		int getPixelSize() const;
+		bool isDistanceField() const;
+		float getLineHeight() const;
+
+		size_t getCPUBytes() const override;
+		size_t getGPUBytes() const override;
+
+		const Character* getCharacter(char c) const;
 	};
 
 	class Text : public Engine::Component
 	{
 	private:
-		std::shared_ptr<ShaderProgram> m_shaderProgram = nullptr;
 		std::shared_ptr<Font> m_font = nullptr;
 
+		std::string m_text;
+
+		// Position in pixels from the bottom left of the window
+		Core::Maths::vec2 m_position = Core::Maths::vec2(0.f, 0.f);
+		Core::Maths::vec4 m_color = Core::Maths::vec4(1.f, 1.f, 1.f, 1.f);
+		float m_scale = 1.f;
+
+		// Vertices of the string, rebuilt only when the text changes
+		mutable std::vector<TextVertex> vertices;
+		mutable bool isDirty = true;
+
+		void onDestroy() override;
+
 	public:
-		Text(Engine::Entity& owner, const std::string& path);
-		~Text();
+		Text(Engine::Entity& owner, const std::string& fontPath, int pixelSize = 48, bool isSDF = false);
+
+		void setText(const std::string& text);
+		const std::string& getText() const;
+
+		void setPosition(const Core::Maths::vec2& position);
+		void setColor(const Core::Maths::vec4& color);
+		void setScale(float scale);
 
-		void draw() const;
+		const std::shared_ptr<Font>& getFont() const;
+		const std::vector<TextVertex>& getVertices() const;
 
+		void drawImGui() override;
 		std::string toString() const override;
 
-		static void parseComponent(Engine::Entity& owner, std::istringstream& iss);
+		static void parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss);
 	};
-}
\ No newline at end of file
+}
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
 
 #include <glad/glad.h>
 
@@ -17,15 +18,38 @@ namespace Resources
 		std::vector<std::string> paths;
 		CubeMapTexture textures[6];
 
+		// Faces that are still being read, then decoded
+		std::atomic<int> remainingFaces = 0;
+
+		// Content of each face, combined in order once the six are read
+		uint64_t faceHashes[6] = {};
+		std::atomic<bool> isFaceMissing = false;
+
+		// Cube map of other paths with the same six images, used in place of this one once the main thread knows it
+		std::shared_ptr<CubeMap> sharedCubeMap;
+		bool isShared = false;
+
+		bool readFace(int faceIndex);
+		bool generateFaceBuffer(int faceIndex);
+
 	public:
 		CubeMap(const std::vector<std::string>& paths);
 		~CubeMap();
 
 		GLuint	getID() const;
+		const std::vector<std::string>& getPaths() const;
+		size_t getDecodedSize() const;
+
+		size_t getCPUBytes() const override;
+		size_t getGPUBytes() const override;
 		bool generateBuffers();
+
+		// Decode the faces again, the cube map keeps its texture
+		void reload();
+
 		bool generateID();
 
-		void bind() const;
+		void bind(GLuint unit) const;
 
 		void mainThreadInitialization() override;
 	};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <filesystem>
+#include <unordered_map>
+
+#include "singleton.hpp"
+#include "concurrent_queue.hpp"
+
+namespace Resources
+{
+	// Watch the resources directory and hot reload the resources of the changed files
+	class FileWatcher final : public Singleton<FileWatcher>
+	{
+		friend class Singleton<FileWatcher>;
+
+	private:
+		std::thread watchThread;
+		std::atomic<bool> isWatching = false;
+
+		// Directory containing the watched one, the changed paths are given relatively to it
+		std::filesystem::path basePath;
+		std::filesystem::path watchedPath;
+
+		// Paths of the changed files, filled by the watch thread
+		ConcurrentQueue<std::string> changedFiles;
+
+#ifdef __linux__
+		int inotifyDescriptor = -1;
+		std::unordered_map<int, std::filesystem::path> watchedDirectories;
+
+		void addWatch(const std::filesystem::path& directoryPath);
+		void readEvents();
+#else
+		std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes;
+
+		void scanWriteTimes(bool notifyChanges);
+#endif
+
+		FileWatcher() = default;
+		~FileWatcher();
+
+		void watch();
+		void addChangedFile(const std::filesystem::path& filePath);
+
+	public:
+		static void init(const std::string& directoryPath);
+
+		// Reload the resources of the files changed since the last call, on the main thread
+		static void update();
+	};
+}
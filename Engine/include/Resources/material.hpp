@@ -13,18 +13,54 @@ namespace Resources
 	{
 		Material(const std::string& name);
 
+		// Copy parsed aside from a material in use, swapped into it on the main thread
+		Material(const std::shared_ptr<Material>& reloadedMaterial);
+
+		// Material in use which takes the values of this copy once it is parsed, for a hot reload
+		std::shared_ptr<Material> reloadedMaterial;
+
 		LowRenderer::Color ambient = { 0.2f, 0.2f, 0.2f, 1.0f };
 		LowRenderer::Color diffuse = { 0.8f, 0.8f, 0.8f, 1.0f };
 		LowRenderer::Color specular = { 0.0f, 0.0f, 0.0f, 1.0f };
 		LowRenderer::Color emissive = { 0.0f, 0.0f, 0.0f, 0.0f };
 
-		std::unordered_map<std::string, std::shared_ptr<Texture>> textures = {
-			{ "material.alphaTexture", Texture::defaultAlpha },
-			{ "material.ambientTexture", Texture::defaultAmbient },
-			{ "material.diffuseTexture", Texture::defaultDiffuse },
-			{ "material.emissiveTexture", Texture::defaultEmissive },
-			{ "material.specularTexture", Texture::defaultSpecular },
-			{ "material.normalMap", Texture::defaultNormalMap },
+		enum TextureSlot
+		{
+			ALPHA_TEXTURE,
+			AMBIENT_TEXTURE,
+			DIFFUSE_TEXTURE,
+			EMISSIVE_TEXTURE,
+			SPECULAR_TEXTURE,
+			NORMAL_MAP,
+			TEXTURE_COUNT
+		};
+
+		// Sampler of each texture slot
+		static constexpr const char* textureNames[TEXTURE_COUNT] = {
+			"material.alphaTexture",
+			"material.ambientTexture",
+			"material.diffuseTexture",
+			"material.emissiveTexture",
+			"material.specularTexture",
+			"material.normalMap",
+		};
+
+		static constexpr LowRenderer::UniformID textureIDs[TEXTURE_COUNT] = {
+			LowRenderer::hashUniformName(textureNames[ALPHA_TEXTURE]),
+			LowRenderer::hashUniformName(textureNames[AMBIENT_TEXTURE]),
+			LowRenderer::hashUniformName(textureNames[DIFFUSE_TEXTURE]),
+			LowRenderer::hashUniformName(textureNames[EMISSIVE_TEXTURE]),
+			LowRenderer::hashUniformName(textureNames[SPECULAR_TEXTURE]),
+			LowRenderer::hashUniformName(textureNames[NORMAL_MAP]),
+		};
+
+		std::shared_ptr<Texture> textures[TEXTURE_COUNT] = {
+			Texture::defaultAlpha,
+			Texture::defaultAmbient,
+			Texture::defaultDiffuse,
+			Texture::defaultEmissive,
+			Texture::defaultSpecular,
+			Texture::defaultNormalMap,
 		};
 
 		float shininess = 100.f;
@@ -39,5 +75,7 @@ namespace Resources
 		void sendToShader(const std::shared_ptr<Resources::ShaderProgram>& shaderProgram) const;
 
 		void drawImGui();
+
+		void mainThreadInitialization() override;
 	};
 }
\ No newline at end of file
@@ -2,12 +2,14 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 
-#include <glad\glad.h>
+#include <glad/glad.h>
 
 #include "maths.hpp"
 
 #include "resource.hpp"
+#include "geometry_arena.hpp"
 
 namespace Resources
 {
@@ -20,27 +22,93 @@ namespace Resources
 		Core::Maths::vec3 normal;
 	};
 
+	// Bounding volumes of a mesh, a box given by its center and its half size, and a sphere around the center
+	struct Bounds
+	{
+		Core::Maths::vec3 center;
+		Core::Maths::vec3 extents;
+		float radius = 0.f;
+
+		// Bounds of the mesh transformed by a model matrix
+		Bounds transform(const Core::Maths::mat4& model) const;
+	};
+
+	// Indices of a level of detail, after the indices of the finer levels
+	struct LodRange
+	{
+		GLuint first = 0u;
+		GLuint count = 0u;
+	};
+
 	class Mesh : public Resource
 	{
 	private:
-		GLuint VAO = 0;
-		GLuint VBO = 0;
+		// Ranges of the mesh in the geometry arena, the CPU copy may have been released
+		LowRenderer::ArenaRange vertexRange;
+		LowRenderer::ArenaRange indexRange;
+
+		// Local bounds, kept when the vertices are released
+		Bounds bounds;
+
+		// Levels of detail in the indices, from the full mesh to the coarsest one
+		std::vector<LodRange> lods;
+
+		// Simplified level kept on the CPU for the occlusion culling, with the positions it uses only
+		std::vector<Core::Maths::vec3> occluderPositions;
+		std::vector<unsigned int> occluderIndices;
+
+		// Mesh in use which takes the geometry of this copy once it is parsed, for a hot reload
+		std::shared_ptr<Mesh> reloadedMesh;
+
+		void computeBounds();
+
+		// Append coarser index lists that share the vertices of the mesh
+		void generateLods();
+
+		// Keep the finest level under the cap as an occluder, capping the coarsest one when none fits
+		void computeOccluder();
 
 		void mainThreadInitialization() override;
 
 
 	public:
+		static constexpr size_t maxLodCount = 4u;
+
+		// Smallest level generated, in triangles
+		static constexpr size_t minLodTriangleCount = 64u;
+
+		// Largest occluder kept, in triangles
+		static constexpr size_t maxOccluderTriangleCount = 1024u;
+
 		std::string parentMeshName;
 		Mesh(const std::string& name, const std::string& parentMeshName);
+
+		// Copy parsed aside from a mesh in use, swapped into it on the main thread
+		Mesh(const std::shared_ptr<Mesh>& reloadedMesh);
 		~Mesh();
 
 		//std::vector<float> attributs;
 		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
 
 		void parse(const std::string& toParse, std::array<unsigned int, 3> offsets);
 
 		void draw() const;
-		void generateVAO();
-		void compute(std::array<unsigned int, 3> offsets, std::vector<Core::Maths::vec3>& vertices, std::vector<Core::Maths::vec3>& texCoords, std::vector<Core::Maths::vec3>& normals, std::vector<unsigned int>& indices);
+		void upload();
+
+		bool isUploaded() const;
+		const Bounds& getBounds() const;
+		LowRenderer::DrawElementsIndirectCommand getDrawCommand(GLuint drawIndex, size_t lod = 0u) const;
+
+		size_t getLodCount() const;
+		GLuint getTriangleCount(size_t lod) const;
+
+		bool isOccluder() const;
+		const std::vector<Core::Maths::vec3>& getOccluderPositions() const;
+		const std::vector<unsigned int>& getOccluderIndices() const;
+
+		size_t getCPUBytes() const override;
+		size_t getGPUBytes() const override;
+		void compute(std::array<unsigned int, 3> offsets, std::vector<Core::Maths::vec3>& vertices, std::vector<Core::Maths::vec3>& texCoords, std::vector<Core::Maths::vec3>& normals, std::vector<unsigned int>& faceIndices);
 	};
 }
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <vector>
+
+#include "mesh.hpp"
+
+namespace Resources
+{
+	// Index list with at most targetIndexCount indices, made by collapsing the cheapest edges for the quadric error
+	// The vertices are only moved on their neighbours, the levels of a mesh share its vertices
+	std::vector<unsigned int> simplifyMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, size_t targetIndexCount);
+}
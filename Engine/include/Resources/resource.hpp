@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include "cancellation_token.hpp"
+
 namespace Resources
 {
 	class Resource
@@ -9,13 +11,28 @@ namespace Resources
 	protected:
 		std::string m_filePath;
 
-		Resource() = default;
+		// Token of the load which created the resource
+		Multithread::CancellationToken loadToken;
+
+		// Keep the CPU copy of the data once it is uploaded, to read it back from the CPU
+		bool keepCPUData = false;
+
+		Resource();
 		Resource(const std::string& filePath);
 
 	public:
 		std::string m_name;
 		std::string getPath() const;
 
+		bool isLoadCancelled() const;
+
+		void setKeepCPUData(bool keep);
+		bool isCPUDataKept() const;
+
+		// Bytes used by the resource in RAM and in VRAM
+		virtual size_t getCPUBytes() const { return 0u; }
+		virtual size_t getGPUBytes() const { return 0u; }
+
 		virtual void mainThreadInitialization() { }
 	};
 }
\ No newline at end of file
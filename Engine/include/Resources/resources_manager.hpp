@@ -1,8 +1,12 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
 #include <filesystem>
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <memory>
 #include <atomic>
 
@@ -11,6 +15,7 @@
 
 #include "thread_manager.hpp"
 #include "benchmarker.hpp"
+#include "tracer.hpp"
 
 #include "character.hpp"
 #include "cube_map.hpp"
@@ -22,9 +27,25 @@
 #include "mesh.hpp"
 
 #include "concurrent_queue.hpp"
+#include "cancellation_token.hpp"
 
 namespace Resources
 {
+	enum class ContentType
+	{
+		TEXTURE,
+		CUBEMAP,
+		OBJ
+	};
+
+	// Path whose content is identical to the one of an already loaded path
+	struct ContentAlias
+	{
+		ContentType type;
+		std::string path;
+		std::string sharedPath;
+	};
+
 	class ResourcesManager final : public Singleton<ResourcesManager>, Core::Manager
 	{
 		friend Singleton<ResourcesManager>;
@@ -41,6 +62,12 @@ namespace Resources
 
 		std::atomic<bool> isLoading = false;
 
+		// Token of the current scene load, cancelled when switching scenes
+		Multithread::CancellationToken loadToken = Multithread::CancellationToken::create();
+
+		// Token of the persistent resources, never cancelled
+		Multithread::CancellationToken persistentToken;
+
 		ResourcesManager();
 		~ResourcesManager();
 		
@@ -52,6 +79,10 @@ namespace Resources
 		std::atomic_flag lockMeshChildren = ATOMIC_FLAG_INIT;
 		std::atomic_flag lockCubemaps = ATOMIC_FLAG_INIT;
 		std::atomic_flag lockMaterials = ATOMIC_FLAG_INIT;
+		std::atomic_flag lockFonts = ATOMIC_FLAG_INIT;
+		std::atomic_flag lockContentAliases = ATOMIC_FLAG_INIT;
+		std::atomic_flag lockCPUResidentPaths = ATOMIC_FLAG_INIT;
+		std::atomic_flag lockStagedResources = ATOMIC_FLAG_INIT;
 
 		ConcurrentQueue<Resource*> toInitInMainThread;
 
@@ -70,14 +101,107 @@ namespace Resources
 
 		std::unordered_map<std::string, std::shared_ptr<Recipe>>		recipes;
 
+		// Mtl libraries that have been loaded, to reload their materials
+		std::unordered_set<std::string>									mtlLibraries;
+
+		// Share the decoded resources between the paths which have the same content
+		bool contentDeduplication = true;
+
+		// Path that owns each content hash, guarded by the lock of its resources
+		std::unordered_map<uint64_t, std::string>						textureContents;
+		std::unordered_map<uint64_t, std::string>						cubeMapContents;
+		std::unordered_map<uint64_t, std::string>						objContents;
+
+		std::vector<ContentAlias>										contentAliases;
+
+		// Files whose resources keep their CPU data after the upload, like meshes read by the CPU
+		std::unordered_set<std::string>									cpuResidentPaths;
+
+		// Copies parsed by a hot reload, kept until the main thread swaps them into the resources in use
+		std::vector<std::shared_ptr<Resource>>							stagedResources;
+
 		std::string resourcesPath = std::filesystem::current_path().string();
 
 		void setDefaultResources();
 
+		static void importObj(const std::string& filePath, bool setAsPersistent, bool isReload);
+		static void importMtl(const std::string& dirPath, const std::string& mtlName, bool isReload);
+
+		void addMeshChild(const std::string& filePath, const std::string& meshName);
+
+		void addStagedResource(const std::shared_ptr<Resource>& resourcePtr);
+		void releaseStagedResource(const Resource* resource);
+
+		void addContentAlias(ContentType type, const std::string& path, const std::string& sharedPath);
+		std::string getSharedPath(const std::string& path);
+		size_t getSavedBytes(const ContentAlias& alias);
+		void purgeContentAliases(bool cancelledOnly = false);
+
+		bool isCPUResident(const std::string& filePath);
+
+		template <class C>
+		void addResidentBytes(std::unordered_map<std::string, std::shared_ptr<C>>& map, std::atomic_flag& mapFlag, std::unordered_set<const Resource*>& countedResources, size_t& cpuBytes, size_t& gpuBytes)
+		{
+			while (mapFlag.test_and_set());
+
+			// The deduplicated resources are counted once
+			for (const auto& pair : map)
+			{
+				if (!countedResources.insert(pair.second.get()).second)
+					continue;
+
+				cpuBytes += pair.second->getCPUBytes();
+				gpuBytes += pair.second->getGPUBytes();
+			}
+
+			mapFlag.clear();
+		}
+
+		template <class C>
+		std::shared_ptr<C> findSharedContent(std::unordered_map<uint64_t, std::string>& contents, std::unordered_map<std::string, std::shared_ptr<C>>& map, uint64_t contentHash)
+		{
+			auto contentIt = contents.find(contentHash);
+
+			if (contentIt == contents.end())
+				return nullptr;
+
+			auto resourceIt = map.find(contentIt->second);
+
+			// The path which owned the content may have been purged or cancelled
+			if (resourceIt == map.end() || resourceIt->second->isLoadCancelled())
+				return nullptr;
+
+			return resourceIt->second;
+		}
+
+		template <class C>
+		bool purgeAlias(std::unordered_map<std::string, std::shared_ptr<C>>& map, std::atomic_flag& mapFlag, const std::string& path, bool cancelledOnly)
+		{
+			while (mapFlag.test_and_set());
+
+			auto aliasIt = map.find(path);
+
+			if (aliasIt == map.end())
+			{
+				mapFlag.clear();
+				return true;
+			}
+
+			// The alias is unused if the resource is only referenced by the map entries
+			long mapReferences = (long)std::count_if(map.begin(), map.end(), [&aliasIt](const auto& pair) { return pair.second == aliasIt->second; });
+			bool isUnused = aliasIt->second.use_count() <= mapReferences && (!cancelledOnly || aliasIt->second->isLoadCancelled());
+
+			if (isUnused)
+				map.erase(aliasIt);
+
+			mapFlag.clear();
+
+			return isUnused;
+		}
+
 		template <class C>
 		void purgeCallback(const std::shared_ptr<C>& resourcePtr) { }
 
-		template <>
 		void purgeCallback(const std::shared_ptr<Mesh>& meshPtr)
 		{
 			// Remove the dependency with the meshes and the materials
@@ -86,11 +210,11 @@ namespace Resources
 		}
 
 		template <class C>
-		void purgeMap(std::unordered_map<std::string, std::shared_ptr<C>>& map)
+		void purgeMap(std::unordered_map<std::string, std::shared_ptr<C>>& map, bool cancelledOnly = false)
 		{
 			// Remove each resources that is not used
-			std::erase_if(map, [this](const std::pair<const std::string&, const std::shared_ptr<C>&> &pair) {
-				if (pair.second.use_count() > 1)
+			std::erase_if(map, [this, cancelledOnly](const std::pair<const std::string&, const std::shared_ptr<C>&> &pair) {
+				if (pair.second.use_count() > 1 || (cancelledOnly && !pair.second->isLoadCancelled()))
 					return false;
 
  				purgeCallback(pair.second);
@@ -99,21 +223,57 @@ namespace Resources
 		}
 
 		template <class C>
-		void purgeMap(std::unordered_map<std::string, std::shared_ptr<C>>& map, std::atomic_flag& mapFlag)
+		void purgeMap(std::unordered_map<std::string, std::shared_ptr<C>>& map, std::atomic_flag& mapFlag, bool cancelledOnly = false)
 		{
 			while (mapFlag.test_and_set());
-			purgeMap(map);
+			purgeMap(map, cancelledOnly);
 			mapFlag.clear();
 		}
 
+		template <class Fct, typename... Types>
+		static void manageImportTask(bool isReload, Fct&& func, Types&&... args)
+		{
+			if (isReload)
+				manageReloadTask(func, args...);
+			else
+				manageTask(func, args...);
+		}
+
+		static std::string getTaskName() { return ""; }
+
+		template <typename T, typename... Types>
+		static std::string getTaskName(const T& first, const Types&... others)
+		{
+			// Name the task with the resource or the path it works on
+			if constexpr (std::is_convertible_v<T, const Resource*>)
+				return first->m_name;
+			else if constexpr (std::is_convertible_v<T, std::string>)
+				return first;
+			else
+				return "";
+		}
+
 	public:
 		static void init(unsigned int workerCount);
 
 		static void loadObj(std::string filePath, bool setAsPersistent = false);
 		static void loadMaterials(const std::string& dirPath, const std::string& mtlName);
 
+		// Import again the resources loaded from the file, keeping their GPU objects
+		static void reloadFile(const std::string& filePath);
+
+		// Keep the CPU data of the resources loaded from the file, applied on their next upload
+		static void setKeepCPUData(const std::string& filePath, bool keep = true);
+
 		static void clearResources();
 		static void purgeResources();
+		static void purgeCancelledResources();
+
+		static void cancelLoading();
+
+		static const Multithread::CancellationToken& getLoadToken();
+		static bool isLoadCancelled();
+		static bool isLoadInProgress();
 
 		static void addToMainThreadInitializerQueue(Resource* resourcePtr);
 
@@ -121,10 +281,14 @@ namespace Resources
 
 		static bool checkLoadEnd();
 
-		static std::shared_ptr<Font>	loadFont(const std::string& fontPath);
+		static std::shared_ptr<Font>	loadFont(const std::string& fontPath, int pixelSize = 48, bool isSDF = false);
 		static std::shared_ptr<Texture> loadTexture(const std::string& texturePath, bool setAsPersistent = false);
 		static std::shared_ptr<Texture> loadTexture(const std::string& name, int width, int height, float* data, bool setAsPersistent = false);
 		static std::shared_ptr<CubeMap> loadCubeMap(const std::vector<std::string>& cubeMapPaths, bool setAsPersistent = false);
+
+		// Called by the load tasks once the files are read, return the resource that already has the same content or register it
+		static std::shared_ptr<Texture> resolveTextureContent(const std::string& texturePath, uint64_t contentHash);
+		static std::shared_ptr<CubeMap> resolveCubeMapContent(const std::string& pathsDir, uint64_t contentHash);
 		static std::shared_ptr<Material> loadMaterial(const std::string& materialPath, bool setAsPersistent = false);
 		static std::shared_ptr<Recipe> loadRecipe(const std::string& recipePath, bool setAsPersistent = false);
 		static std::shared_ptr<Shader> loadShader(const std::string& shaderPath, bool setAsPersistent = false);
@@ -136,6 +300,10 @@ namespace Resources
 
 		static std::string getResourcesPath();
 
+		// Total size of the decoded data shared between paths with the same content
+		static size_t getDeduplicationSavedBytes();
+		static void logDeduplicationReport();
+
 		static void drawImGui();
 
 		template <class Fct, typename... Types>
@@ -148,11 +316,28 @@ namespace Resources
 			{
 				Core::Debug::Benchmarker::startChrono("load");
 				Core::Debug::Benchmarker::startChrono("loadWithOpenGL");
+				Core::Debug::Tracer::beginTrace();
 				RM->isLoading = true;
 			}
 
-			// Add the task to the thread manager
-			Multithread::ThreadManager::manageTask("load", func, args...);
+			// The name of the task is only built for the traced loads
+			std::string taskName = Core::Debug::Tracer::isRecording() ? getTaskName(args...) : std::string();
+			Core::Debug::Tracer::Clock::time_point queuedTime = Core::Debug::Tracer::now();
+
+			// Add the task to the thread manager, bound to the load it belongs to
+			Multithread::ThreadManager::manageTask("load", getLoadToken(), [task = std::bind(func, args...), taskName, queuedTime]() mutable
+			{
+				// Trace the time spent by the task in the queue
+				Core::Debug::Tracer::addEvent("Queue wait", taskName, queuedTime, Core::Debug::Tracer::now());
+				task();
+			});
+		}
+
+		// Add a hot reload task, it is not part of a scene load so the chronos and the trace are left as they are
+		template <class Fct, typename... Types>
+		static void manageReloadTask(Fct&& func, Types&&... args)
+		{
+			Multithread::ThreadManager::manageTask("load", getLoadToken(), std::bind(func, args...));
 		}
 	};
 }
\ No newline at end of file
@@ -10,6 +10,8 @@ namespace Resources
 {
 	class Scene
 	{
+		friend class BinaryScene;
+
 	private:
 		std::string curEntityName = "";
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 #include <memory>
 
 #include <glad/glad.h>
@@ -13,10 +14,11 @@ namespace Resources
 {
 	struct Sampler
 	{
-		GLuint location;
+		// Texture unit given to the sampler after the link
+		GLuint unit;
 		GLenum type;
 
-		void bind(GLuint textureID);
+		void bind(GLuint textureID) const;
 	};
 
 	class Shader : public Resource
@@ -56,8 +58,13 @@ namespace Resources
 		GLint programID = GL_INVALID_VALUE;
 		std::string name;
 
-		std::unordered_map<std::string, LowRenderer::Uniform> uniforms;
-		std::unordered_map<std::string, Sampler> samplerIDs;
+		// Uniforms and samplers resolved once after the link, the elements of an array share the uniform of their full name
+		std::vector<LowRenderer::Uniform> uniforms;
+		std::unordered_map<LowRenderer::UniformID, size_t> uniformIndices;
+		std::unordered_map<LowRenderer::UniformID, Sampler> samplers;
+
+		void addUniform(const std::string& uniformName, GLint location, GLint size, GLenum type, GLuint& samplerUnit);
+		void warnMissingUniform(LowRenderer::UniformID ID) const;
 
 		void loadUniforms();
 		void loadLocations();
@@ -71,20 +78,43 @@ namespace Resources
 		ShaderProgram(const std::string& programName, const std::string& vertPath, const std::string& fragPath, const std::string& geomPath);
 		~ShaderProgram();
 
-		void setUniform(const std::string& target, const void* value, bool shouldBeTracked, int count = 1, bool transpose = false) const;
-		bool setSampler(const std::string& target, GLuint textureID);
+		template <typename T>
+		void setUniform(LowRenderer::UniformID ID, const T* values, int count) const
+		{
+			const auto& uniformIt = uniformIndices.find(ID);
+
+			if (uniformIt == uniformIndices.end())
+			{
+				if (debugSetUniform)
+					warnMissingUniform(ID);
+
+				return;
+			}
+
+			// The elements of an array follow its first one, their copies are outdated once it is sent
+			for (size_t i = uniformIt->second + 1; i < uniformIt->second + count && i < uniforms.size(); i++)
+				uniforms[i].resetValue();
+
+			uniforms[uniformIt->second].set(values, count);
+		}
+
+		template <typename T>
+		void setUniform(LowRenderer::UniformID ID, const T& value) const
+		{
+			setUniform(ID, &value, 1);
+		}
+
+		bool setSampler(LowRenderer::UniformID ID, GLuint textureID) const;
 		bool bind() const;
 		void unbind() const;
 
 		void reload();
+		bool usesShader(const std::string& shaderPath) const;
 
 		std::string getName();
 
 		void linkShaders();
 
-		GLint getUBOLocation(const std::string& UBOName) const;
-		bool bindToUBO(const std::string& UBOName, GLint UBIndex, GLuint bindingPoint);
-
 		void drawImGui();
 	};
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <memory>
+#include <cstdint>
 
 #include <glad/glad.h>
 
@@ -22,8 +24,21 @@ namespace Resources
 		float*	colorBuffer = nullptr;
 		bool	stbiLoaded = false;
 
+		// Uploads of the texture, the copies of it are refreshed when it changes
+		unsigned int uploadCount = 0u;
+
+		// Encoded file already read to hash its content, released once decoded
+		std::vector<char> fileContent;
+
+		// Texture of another path with the same content, used in place of this one once the main thread knows it
+		std::shared_ptr<Texture> sharedTexture;
+		bool isShared = false;
+
 		void mainThreadInitialization() override;
 
+		// Decode the file of the texture, from its content if it has already been read
+		float* decode(const std::string& correctPath);
+
 		void allocateTexture(int textureType);
 
 	public:
@@ -35,9 +50,24 @@ namespace Resources
 		virtual bool generateBuffer();
 		virtual bool generateID();
 
+		void reload();
+
+		// Read the file before decoding it, and hash it for the content deduplication
+		bool readContent(uint64_t& contentHash);
+
+		// Release the content read, when it is not decoded
+		void releaseContent();
+
 		GLuint getID() const;
 		int getHeight() const;
 		int getWidth() const;
+		unsigned int getUploadCount() const;
+
+		// Size of the decoded color buffer, in bytes
+		size_t getDecodedSize() const;
+
+		size_t getCPUBytes() const override;
+		size_t getGPUBytes() const override;
 
 		void drawImGui();
 
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory>
+#include <atomic>
+
+namespace Multithread
+{
+    class CancellationToken
+    {
+    private:
+        // A default token has no flag and can not be cancelled
+        std::shared_ptr<std::atomic<bool>> cancelled;
+
+        // Token of the task running on the current thread
+        static inline thread_local const CancellationToken* current = nullptr;
+
+    public:
+        static CancellationToken create()
+        {
+            CancellationToken token;
+            token.cancelled = std::make_shared<std::atomic<bool>>(false);
+
+            return token;
+        }
+
+        void cancel() const
+        {
+            if (cancelled)
+                cancelled->store(true);
+        }
+
+        bool isCancelled() const
+        {
+            return cancelled && cancelled->load();
+        }
+
+        static const CancellationToken* getCurrent()
+        {
+            return current;
+        }
+
+        // Set the token of the current thread until the end of the scope
+        class Scope
+        {
+        private:
+            const CancellationToken* previous = nullptr;
+
+        public:
+            Scope(const CancellationToken& token)
+                : previous(current)
+            {
+                current = &token;
+            }
+
+            ~Scope()
+            {
+                current = previous;
+            }
+        };
+    };
+}
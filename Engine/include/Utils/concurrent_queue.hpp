@@ -41,6 +41,17 @@ public:
         return true;
 	}
 
+    template <class Predicate>
+    void eraseIf(Predicate predicate)
+    {
+        while (used.test_and_set());
+
+        // Remove each element matching the predicate, keeping the order of the others
+        std::erase_if(this->c, predicate);
+
+        used.clear();
+    }
+
     void clear()
     {
         while (used.test_and_set());
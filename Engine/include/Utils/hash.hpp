@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Utils
+{
+    // 64 bits hash of a buffer, following the XXH64 algorithm
+    uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0u);
+
+    // Combine a hash with another one, the order matters
+    uint64_t combineHashes(uint64_t hash, uint64_t other);
+
+    // Hash the content of a file, return false if it cannot be read
+    bool hashFile(const std::string& filePath, uint64_t& hash);
+
+    // Read the whole content of a file, to hash it and decode it without reading it again
+    bool readFile(const std::string& filePath, std::vector<char>& content);
+}
@@ -9,9 +9,16 @@
 #include "singleton.hpp"
 
 #include "concurrent_queue.hpp"
+#include "cancellation_token.hpp"
 
 namespace Multithread
 {
+    struct Task
+    {
+        std::function<void()> function;
+        CancellationToken token;
+    };
+
     class ThreadPool
     {
     private:
@@ -22,7 +29,7 @@ namespace Multithread
         std::atomic<std::chrono::system_clock::time_point> lastTime = std::chrono::system_clock::now();
 
         std::vector<std::thread> workers;
-        ConcurrentQueue<std::function<void()>> tasks;
+        ConcurrentQueue<Task> tasks;
 
         ConcurrentQueue<std::exception_ptr> exceptions;
 
@@ -45,11 +52,18 @@ namespace Multithread
 
         void sync();
         void syncAndClean();
+        void discardCancelled();
 
         template <class Fct, typename... Types>
         void addTask(Fct&& func, Types&&... args)
         {
-            tasks.tryPush(std::bind(func, args...));
+            tasks.tryPush({ std::bind(func, args...), CancellationToken() });
+        }
+
+        template <class Fct, typename... Types>
+        void addTask(const CancellationToken& token, Fct&& func, Types&&... args)
+        {
+            tasks.tryPush({ std::bind(func, args...), token });
         }
 
         std::chrono::system_clock::time_point getLastTime();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <ctime>
 #include <functional>
 
 #include "maths.hpp"
@@ -62,7 +63,13 @@ namespace Utils
     {
         char timeString[I];
         struct tm tstruct;
+
+        // Same thread safe conversion, with the arguments in the other order out of MSVC
+#ifdef _MSC_VER
         localtime_s(&tstruct, &currentTime);
+#else
+        localtime_r(&currentTime, &tstruct);
+#endif
         strftime(timeString, sizeof(timeString), format.c_str(), &tstruct);
 
         return std::string(timeString);
@@ -0,0 +1,13 @@
+#version 450 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+
+uniform mat4 viewProj;
+
+out vec3 Color;
+
+void main()
+{
+	Color = aColor;
+	gl_Position = viewProj * vec4(aPos, 1.f);
+}
\ No newline at end of file
@@ -1,10 +1,24 @@
 #version 450 core
 layout (location = 0) in vec3 VertPos;
+layout (location = 5) in uint DrawIndex;
+
+struct DrawData
+{
+	mat4 model;
+	vec4 tilling;
+};
+
+// Per draw data of the multi-draws, the matrices are stored by rows
+layout (std430, row_major, binding = 0) readonly buffer DrawBuffer
+{
+	DrawData draws[];
+};
 
 uniform mat4 lightSpaceMatrix;
-uniform mat4 model;
 
 void main()
 {
+	mat4 model = draws[DrawIndex].model;
+
 	gl_Position = lightSpaceMatrix * model * vec4(VertPos, 1.0);
 }
\ No newline at end of file
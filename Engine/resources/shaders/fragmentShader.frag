@@ -1,6 +1,16 @@
 #version 450 core
 
-#define LIGHT_COUNT 8
+// Lights with a slot in the shadow uniforms
+#define SHADOW_LIGHT_COUNT 8
+
+// Tiles of the shadow atlas, six per light for the faces of the point lights (SHADOW_LIGHT_COUNT * 6)
+#define VIEWS_PER_LIGHT 6
+#define SHADOW_TILE_COUNT 48
+
+// Froxels of the camera frustum, like the grid of the light clusters of the engine
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
 #define BLINN_PHONG
 
 //#define USE_NORMAL_MAP
@@ -9,8 +19,6 @@
 #define PCFSampleCount (1 + 2 * PCF) * (1 + 2 * PCF)
 #define PCFFactor 1.0 / (PCFSampleCount)
 
-//#define USE_UBO
-
 in VS_OUT
 {
 	vec3 FragPos;
@@ -44,7 +52,6 @@ struct Light
 {
 	vec3 position;
 	bool isPoint;
-	vec4 ambient;
 	vec4 diffuse;
 	vec4 specular;
 
@@ -54,28 +61,59 @@ struct Light
 	vec3 spotDirection;
 	float spotOuterCutoff;
 
-	bool enable;
-	bool hasShadow;
+	int shadowIndex;
 	
 	mat4 spaceMatrix;
-} lights[LIGHT_COUNT];
+};
+
+// Light as written by the engine, with the cosines of the cutoffs
+struct PackedLight
+{
+	vec4 positionAndIsPoint;
+	vec4 diffuse;
+	vec4 specular;
+	vec4 attenuationAndCutoff;
+	vec4 directionAndOuterCutoff;
+	vec4 shadowIndexAndRange;
+};
 
-layout(std140) uniform lightBlock
+layout(std430, binding = 1) readonly buffer LightBuffer
 {
-    Light lightBuffer[LIGHT_COUNT];
+	PackedLight packedLights[];
 };
 
+// Offset and count of the lights of each cluster in the index list
+layout(std430, binding = 2) readonly buffer ClusterBuffer
+{
+	uvec2 clusters[];
+};
+
+layout(std430, binding = 3) readonly buffer LightIndexBuffer
+{
+	uint lightIndices[];
+};
+
+// Clusters per pixel, then the scale and bias of the logarithm of the view depth
+uniform vec4 clusterScale;
+
+// Ambient of all the lights, it does not fade with the distance
+uniform vec4 ambientLight;
+
 uniform vec3 viewPos;
 uniform float farPlane;
 
 uniform float maxBias;
 uniform float minBias;
 
-uniform mat4 lightAttribs1[LIGHT_COUNT][1];
-uniform mat4 lightAttribs2[LIGHT_COUNT][1];
-uniform mat4 lightAttribs3[LIGHT_COUNT][1];
-uniform sampler2D shadowMaps[LIGHT_COUNT][1];
-uniform samplerCube shadowCubeMaps[LIGHT_COUNT][1];
+uniform mat4 shadowSpaceMatrices[SHADOW_LIGHT_COUNT];
+
+// Depth of all the shadows, with the offset and the size of the tile of each view
+uniform sampler2D shadowAtlas;
+uniform vec4 shadowTiles[SHADOW_TILE_COUNT];
+
+// Center and radius of each cascade of the directional lights in their light space, with the view depth where it ends
+uniform vec4 shadowCascades[SHADOW_TILE_COUNT];
+uniform mat4 pointFaceMatrices[VIEWS_PER_LIGHT];
 
 uniform samplerCube environmentMap;
 
@@ -84,60 +122,58 @@ vec3 viewDir = normalize(fs_in.TangentFragPos - fs_in.TangentViewPos);
 
 out vec4 FragColor;
 
-void parseLights()
+Light unpackLight(uint index)
 {
-	// Parse each light matrix to a light struct
-	for (int i = 0; i < LIGHT_COUNT; i++)
-	{
-		lights[i].position	= lightAttribs1[i][0][0].xyz;
-		lights[i].isPoint	= bool(lightAttribs1[i][0][0].w);
-		lights[i].ambient	= lightAttribs1[i][0][1];
-		lights[i].diffuse	= lightAttribs1[i][0][2];
-		lights[i].specular	= lightAttribs1[i][0][3];
-
-		lights[i].attenuation		= vec3(lightAttribs2[i][0][0]);
-		lights[i].spotCutoff		= cos(lightAttribs2[i][0][0][3]);
-		lights[i].spotDirection		= vec3(lightAttribs2[i][0][1]);
-		lights[i].spotOuterCutoff	= cos(lightAttribs2[i][0][1][3]);
-		lights[i].enable			= bool(lightAttribs2[i][0][2][0]);
-		lights[i].hasShadow			= bool(lightAttribs2[i][0][2][1]);
-
-		lights[i].spaceMatrix = lightAttribs3[i][0];
-	}
+	PackedLight packedLight = packedLights[index];
+
+	Light light;
+	light.position			= packedLight.positionAndIsPoint.xyz;
+	light.isPoint			= bool(packedLight.positionAndIsPoint.w);
+	light.diffuse			= packedLight.diffuse;
+	light.specular			= packedLight.specular;
+	light.attenuation		= packedLight.attenuationAndCutoff.xyz;
+	light.spotCutoff		= packedLight.attenuationAndCutoff.w;
+	light.spotDirection		= packedLight.directionAndOuterCutoff.xyz;
+	light.spotOuterCutoff	= packedLight.directionAndOuterCutoff.w;
+	light.shadowIndex		= int(packedLight.shadowIndexAndRange.x);
+
+	if (light.shadowIndex >= 0)
+		light.spaceMatrix = shadowSpaceMatrices[light.shadowIndex];
+
+	return light;
 }
 
-float getDirectionalShadow(in Light light, int index)
+// Cluster of the fragment, from its pixel and its view depth
+uint getCluster()
 {
-	// Perspcetive divide
-	vec4 fragPosLightSpace = light.spaceMatrix * vec4(fs_in.FragPos, 1.0);
-	vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
+	uvec2 tile = min(uvec2(gl_FragCoord.xy * clusterScale.xy), uvec2(CLUSTER_X - 1, CLUSTER_Y - 1));
 
-	// Avoid shadow out of the frustum
-	if (projCoords.z > 1.0)
-		return 0.0;
-
-	// [0,1]
-	projCoords = projCoords * 0.5 + 0.5;
+	float viewDepth = 1.0 / gl_FragCoord.w;
+	uint slice = uint(clamp(log(viewDepth) * clusterScale.z + clusterScale.w, 0.0, float(CLUSTER_Z - 1)));
 
-	vec3 lightDir = normalize(light.position - fs_in.FragPos);
-
-	float slopeFactor = 1.0 - dot(normal, lightDir);
-
-	float bias = max(minBias * slopeFactor, maxBias);
-	float currentDepth = projCoords.z - bias;
+	return tile.x + CLUSTER_X * (tile.y + CLUSTER_Y * slice);
+}
 
+float getTileShadow(vec4 tile, vec2 tileCoords, float currentDepth)
+{
 	// Apply Percentage-Closer filtering to avoid "stair" shadows
 	// Use to soft shadow boders
 	float shadow = 0.0;
-		
+
 	// Calculate the texel size from the depth texture size
-	vec2 texelSize = 1.0 / textureSize(shadowMaps[index][0], 0);
-		
+	vec2 texelSize = 1.0 / textureSize(shadowAtlas, 0);
+
+	// Keep the samples inside the tile, the next tiles belong to other views
+	vec2 minCoords = tile.xy + 0.5 * texelSize;
+	vec2 maxCoords = tile.xy + tile.zz - 0.5 * texelSize;
+	vec2 atlasCoords = tile.xy + tileCoords * tile.z;
+
 	for (int x = -PCF; x <= PCF; x++)
 	{
 		for (int y = -PCF; y <= PCF; y++)
 		{
-			float pcfDepth = texture(shadowMaps[index][0], projCoords.xy + vec2(x, y) * texelSize).r;
+			vec2 sampleCoords = clamp(atlasCoords + vec2(x, y) * texelSize, minCoords, maxCoords);
+			float pcfDepth = texture(shadowAtlas, sampleCoords).r;
 
 			// Compare pcf and current depth of fragment to determine shadow
 			shadow += float(currentDepth > pcfDepth);
@@ -145,58 +181,115 @@ float getDirectionalShadow(in Light light, int index)
 	}
 
 	return shadow * PCFFactor;
-
 }
 
-vec3 sampleOffsetDirections[20] = vec3[]
-(
-   vec3(1, 1,  1), vec3( 1, -1,  1), vec3(-1, -1,  1), vec3(-1, 1,  1), 
-   vec3(1, 1, -1), vec3( 1, -1, -1), vec3(-1, -1, -1), vec3(-1, 1, -1),
-   vec3(1, 1,  0), vec3( 1, -1,  0), vec3(-1, -1,  0), vec3(-1, 1,  0),
-   vec3(1, 0,  1), vec3(-1,  0,  1), vec3( 1,  0, -1), vec3(-1, 0, -1),
-   vec3(0, 1,  1), vec3( 0, -1,  1), vec3( 0, -1, -1), vec3( 0, 1, -1)
-);
-
-float getPointShadow(int indexLight)
+// First cascade of a directional light that reaches the fragment, -1 past the last one
+int getCascade(int index)
 {
-	vec3 fragToLight = fs_in.FragPos - lights[indexLight].position.xyz;
-	float currentDepth = length(fragToLight);
+	// Distance to the camera along its view
+	float viewDepth = 1.0 / gl_FragCoord.w;
 
-	float shadow = 0.0;
-	float bias = 0.15;
-	int samples = 20;
-	float viewDistance = length(fs_in.TangentViewPos - fs_in.FragPos);
-	float diskRadius = (1.0 + (viewDistance / farPlane)) / 25.0;
-	for (int i = 0; i < samples; i++)
+	for (int i = 0; i < VIEWS_PER_LIGHT; i++)
 	{
-		float closestDepth = texture(shadowCubeMaps[indexLight][0], fragToLight + sampleOffsetDirections[i] * diskRadius).r;
-		closestDepth *= farPlane;
-		if (currentDepth - bias > closestDepth)
-			shadow += 1.0;
+		float splitDepth = shadowCascades[index * VIEWS_PER_LIGHT + i].w;
+
+		// The unused cascades end at zero
+		if (splitDepth == 0.0)
+			return -1;
+
+		if (viewDepth <= splitDepth)
+			return i;
 	}
 
-	shadow /= float(samples);
+	return -1;
+}
 
-	return shadow;
+float getDirectionalShadow(in Light light, int index)
+{
+	int cascade = getCascade(index);
+	if (cascade < 0)
+		return 0.0;
+
+	vec4 tile = shadowTiles[index * VIEWS_PER_LIGHT + cascade];
+	vec4 sphere = shadowCascades[index * VIEWS_PER_LIGHT + cascade];
+
+	// The cascade has no tile in the atlas
+	if (tile.z == 0.0)
+		return 0.0;
+
+	// Position on the light plane and depth from zero to one, shared by the cascades
+	vec3 lightSpacePos = (light.spaceMatrix * vec4(fs_in.FragPos, 1.0)).xyz;
+
+	// Avoid shadow out of the frustum
+	if (lightSpacePos.z > 1.0)
+		return 0.0;
+
+	// [0,1] in the square around the sphere of the cascade
+	vec2 tileCoords = (lightSpacePos.xy - sphere.xy) / sphere.z * 0.5 + 0.5;
+
+	// Avoid shadow out of the volume of the cascade
+	if (any(lessThan(tileCoords, vec2(0.0))) || any(greaterThan(tileCoords, vec2(1.0))))
+		return 0.0;
+
+	vec3 lightDir = normalize(light.position - fs_in.FragPos);
+
+	float slopeFactor = 1.0 - dot(normal, lightDir);
+
+	float bias = max(minBias * slopeFactor, maxBias);
+	float currentDepth = lightSpacePos.z - bias;
+
+	return getTileShadow(tile, tileCoords, currentDepth);
 }
 
-float getShadow(in Light light, int index)
+// Face of the cube seen in a direction, in the order +X, -X, +Y, -Y, +Z, -Z
+int getCubeFace(vec3 direction)
 {
-	return getDirectionalShadow(light, index);
-	/*if (lights[indexLight].position.w == 0.0)
-		return getDirectionalShadow(indexLight);
+	vec3 absDirection = abs(direction);
+
+	if (absDirection.x >= absDirection.y && absDirection.x >= absDirection.z)
+		return direction.x > 0.0 ? 0 : 1;
+
+	if (absDirection.y >= absDirection.z)
+		return direction.y > 0.0 ? 2 : 3;
 
-	return getPointShadow(indexLight);*/
+	return direction.z > 0.0 ? 4 : 5;
 }
 
-void getLightColor(in Light light, int index, inout vec4 ambient, inout vec4 diffuse, inout vec4 specular, inout float shadow)
+float getPointShadow(in Light light, int index)
 {
-	if (!light.enable)
-		return;
+	vec3 fragToLight = fs_in.FragPos - light.position;
+
+	int face = getCubeFace(fragToLight);
+	vec4 tile = shadowTiles[index * VIEWS_PER_LIGHT + face];
+
+	// The face has no tile in the atlas
+	if (tile.z == 0.0)
+		return 0.0;
+
+	// Position in the tile of the face, projected like the depth cube shader
+	vec4 faceCoords = pointFaceMatrices[face] * vec4(fragToLight, 1.0);
+	vec2 tileCoords = faceCoords.xy / faceCoords.w * 0.5 + 0.5;
+
+	// The tiles keep the distance to the light divided by the far plane
+	float bias = 0.15;
+	float currentDepth = (length(fragToLight) - bias) / farPlane;
+
+	return getTileShadow(tile, tileCoords, currentDepth);
+}
+
+float getShadow(in Light light, int index)
+{
+	if (light.isPoint)
+		return getPointShadow(light, index);
+
+	return getDirectionalShadow(light, index);
+}
 
-	if (light.hasShadow)
+void getLightColor(in Light light, inout vec4 diffuse, inout vec4 specular, inout float shadow)
+{
+	if (light.shadowIndex >= 0)
 	{
-		shadow -= getShadow(light, index);
+		shadow -= getShadow(light, light.shadowIndex);
 
 		//if (shadow > 1.0)
 		//	shadow = 1.0;
@@ -227,9 +320,6 @@ void getLightColor(in Light light, int index, inout vec4 ambient, inout vec4 dif
 		finalIntensity = spotIntensity / attenuation;
 	}
 
-	// Compute ambient
-	ambient += light.ambient;
-
 	// Pre-compute normal ElightDir
 	float NdotL = dot(normal, lightDir);
 
@@ -258,19 +348,16 @@ void getLightColor(in Light light, int index, inout vec4 ambient, inout vec4 dif
 
 void getLightsSumColor(out vec4 ambient, out vec4 diffuse, out vec4 specular, out float shadow)
 {
-	ambient = diffuse = specular = vec4(0.0, 0.0, 0.0, 1.0);
+	diffuse = specular = vec4(0.0, 0.0, 0.0, 1.0);
+	ambient = vec4(ambientLight.rgb, 1.0);
 
 	shadow = 1.0;
 
-	for (int i = 0; i < LIGHT_COUNT; i++)
-	{
-		// TODO: remove this
-		#ifdef USE_UBO
-			getLightColor(lightBuffer[i], i, ambient, diffuse, specular, shadow);
-		#else
-			getLightColor(lights[i], i, ambient, diffuse, specular, shadow);
-		#endif
-	}
+	// Only the lights that reach the cluster of the fragment
+	uvec2 cluster = clusters[getCluster()];
+
+	for (uint i = 0; i < cluster.y; i++)
+		getLightColor(unpackLight(lightIndices[cluster.x + i]), diffuse, specular, shadow);
 
 	shadow = clamp(shadow, 0.0, 1.0);
 }
@@ -334,8 +421,6 @@ void setNormal()
 
 void main()
 {
-	parseLights();
-
 	// Initialize some variables to avoid to calculate them another time
 	setNormal();
 
@@ -1,20 +1,27 @@
 #version 450 core
 
-in vec3 TexCoords;
+in vec2 TexCoords;
+in vec4 Color;
+flat in vec4 Region;
 
 uniform sampler2D diffuseTex;
-uniform vec4 color;
-
-uniform vec2 tilling;
 
 out vec4 FragColor;
 
-vec2 getTilledTexCoords()
+// Repeat the tilled coordinates inside the region of the sprite, half a texel away from its neighbours in the atlas
+vec2 getRegionTexCoords()
 {
-	return TexCoords.st * tilling.x + tilling.y;
+	vec2 halfTexel = 0.5 / vec2(textureSize(diffuseTex, 0));
+	vec2 texCoords = Region.xy + fract(TexCoords) * Region.zw;
+
+	return clamp(texCoords, Region.xy + halfTexel, Region.xy + Region.zw - halfTexel);
 }
 
 void main()
 {
-	FragColor = color * texture(diffuseTex, getTilledTexCoords());
+	// The gradients of the tilled coordinates do not jump where they repeat
+	vec2 gradX = dFdx(TexCoords) * Region.zw;
+	vec2 gradY = dFdy(TexCoords) * Region.zw;
+
+	FragColor = Color * textureGrad(diffuseTex, getRegionTexCoords(), gradX, gradY);
 }
\ No newline at end of file
@@ -1,14 +1,20 @@
 #version 450 core
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aTexCoords;
+layout (location = 1) in vec2 aTexCoords;
+layout (location = 2) in vec4 aColor;
+layout (location = 3) in vec4 aRegion;
 
-out vec3 TexCoords;
+out vec2 TexCoords;
+out vec4 Color;
+flat out vec4 Region;
 
 uniform mat4 viewOrtho;
-uniform mat4 model;
 
 void main()
 {
+   // The quads are already in world space, the batch transforms them on the CPU
    TexCoords = aTexCoords;
-   gl_Position = viewOrtho * model * vec4(aPos, 1.0);
+   Color = aColor;
+   Region = aRegion;
+   gl_Position = viewOrtho * vec4(aPos, 1.0);
 }
\ No newline at end of file
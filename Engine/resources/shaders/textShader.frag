@@ -2,12 +2,21 @@
 
 out vec4 color;
 in  vec2 TexCoords;
+in  vec4 TextColor;
 
 uniform sampler2D text;
-uniform vec3 textColor;
+uniform bool sdf;
 
 void main()
-{    
-	vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-	color = vec4(textColor, 1.0) * sampled;
+{
+	float coverage = texture(text, TexCoords).r;
+
+	// The distance field stores the glyph edge at 0.5
+	if (sdf)
+	{
+		float smoothing = fwidth(coverage);
+		coverage = smoothstep(0.5 - smoothing, 0.5 + smoothing, coverage);
+	}
+
+	color = vec4(TextColor.rgb, TextColor.a * coverage);
 }
\ No newline at end of file
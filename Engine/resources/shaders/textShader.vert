@@ -1,7 +1,9 @@
-#version 330 core
+#version 450 core
 layout (location = 0) in vec4 vertPos;
+layout (location = 1) in vec4 vertColor;
 
 out vec2 TexCoords;
+out vec4 TextColor;
 
 uniform mat4 proj;
 
@@ -9,4 +11,5 @@ void main()
 {
     gl_Position = proj * vec4(vertPos.xy, 0.0, 1.0);
     TexCoords = vertPos.zw;
-}  
\ No newline at end of file
+    TextColor = vertColor;
+}
\ No newline at end of file
@@ -6,6 +6,21 @@ layout (location = 2) in vec3 VertTangent;
 layout (location = 3) in vec3 VertBitangent;
 layout (location = 4) in vec3 VertNormal;
 
+// Index of the draw, given by the base instance of the indirect command
+layout (location = 5) in uint DrawIndex;
+
+struct DrawData
+{
+	mat4 model;
+	vec4 tilling;
+};
+
+// Per draw data of the multi-draws, the matrices are stored by rows
+layout (std430, row_major, binding = 0) readonly buffer DrawBuffer
+{
+	DrawData draws[];
+};
+
 //#define USE_NORMAL_MAP
 
 out VS_OUT
@@ -21,13 +36,14 @@ out VS_OUT
 } vs_out;
 
 
-uniform vec2 tilling;
 uniform vec3 viewPos;
 uniform mat4 viewProj;
-uniform mat4 model;
 
 void main()
 {
+	mat4 model = draws[DrawIndex].model;
+	vec2 tilling = draws[DrawIndex].tilling.xy;
+
 	vec4 fragPos = model * vec4(VertPos, 1.0);
 	gl_Position = viewProj * fragPos;
 	vs_out.FragPos = fragPos.xyz;
@@ -47,7 +47,8 @@ namespace Core::Input
 		for (auto mouseIt = IM->mouseButtons.begin(); mouseIt != IM->mouseButtons.end(); mouseIt++)
 			mouseIt->second.compute(IM->window);
 
-		// Compute mouse motion
+		// Compute mouse motion, the headless build has no cursor
+#ifndef ENGINE_HEADLESS
 		{
 			double newMouseX, newMouseY;
 
@@ -58,6 +59,7 @@ namespace Core::Input
 			IM->deltasMouse.y = (float)(newMouseY - IM->mousePosition.y);
 			IM->mousePosition = Core::Maths::vec2((float)newMouseX, (float)newMouseY);
 		}
+#endif
 	}
 
 	KeyButton& InputManager::getButtonByName(const std::string& name)
@@ -8,7 +8,10 @@ namespace Core::Input
 
 	void KeyAxis::compute(GLFWwindow* window)
 	{
+		// The headless build has no window, its axes stay centered
+#ifndef ENGINE_HEADLESS
 		m_value = (float)(glfwGetKey(window, m_positiveKeyID) - glfwGetKey(window, m_negativeKeyID));
+#endif
 	}
 
 	float KeyAxis::getValue() const
@@ -11,7 +11,11 @@ namespace Core::Input
 	void MouseButton::compute(GLFWwindow* window)
 	{
 		m_wasDown = m_isDown;
+
+		// The headless build has no window, its buttons stay released
+#ifndef ENGINE_HEADLESS
 		m_isDown = glfwGetMouseButton(window, m_keyID);
+#endif
 
 		// Set button parameters
 		m_isPressed = !m_wasDown && m_isDown;
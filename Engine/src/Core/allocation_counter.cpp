@@ -0,0 +1,122 @@
+#include "allocation_counter.hpp"
+
+#include <new>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <malloc.h>
+#define getAllocationSize _msize
+#else
+#include <malloc.h>
+#define getAllocationSize malloc_usable_size
+#endif
+
+namespace Core::Debug
+{
+	std::atomic<unsigned long long> AllocationCounter::allocationCount = 0ull;
+	std::atomic<unsigned long long> AllocationCounter::allocatedBytes = 0ull;
+	std::atomic<long long> AllocationCounter::liveBytes = 0ll;
+	std::atomic<long long> AllocationCounter::peakLiveBytes = 0ll;
+
+	void AllocationCounter::addAllocation(std::size_t size)
+	{
+		allocationCount.fetch_add(1ull, std::memory_order_relaxed);
+		allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+		long long currentBytes = liveBytes.fetch_add((long long)size, std::memory_order_relaxed) + (long long)size;
+		long long peakBytes = peakLiveBytes.load(std::memory_order_relaxed);
+
+		while (currentBytes > peakBytes && !peakLiveBytes.compare_exchange_weak(peakBytes, currentBytes, std::memory_order_relaxed));
+	}
+
+	void AllocationCounter::removeAllocation(std::size_t size)
+	{
+		liveBytes.fetch_sub((long long)size, std::memory_order_relaxed);
+	}
+
+	unsigned long long AllocationCounter::getAllocationCount()
+	{
+		return allocationCount.load(std::memory_order_relaxed);
+	}
+
+	unsigned long long AllocationCounter::getAllocatedBytes()
+	{
+		return allocatedBytes.load(std::memory_order_relaxed);
+	}
+
+	void AllocationCounter::resetPeakBytes()
+	{
+		peakLiveBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+	unsigned long long AllocationCounter::getPeakBytes()
+	{
+		long long peakBytes = peakLiveBytes.load(std::memory_order_relaxed);
+
+		return peakBytes > 0ll ? (unsigned long long)peakBytes : 0ull;
+	}
+}
+
+#ifdef ENGINE_TRACK_ALLOCATIONS
+
+static void* countedAllocation(std::size_t size)
+{
+	void* memory = std::malloc(size ? size : 1);
+
+	// Count the size given by the allocator, the one freed with the memory
+	if (memory)
+		Core::Debug::AllocationCounter::addAllocation(getAllocationSize(memory));
+
+	return memory;
+}
+
+// Replace the global allocation functions to count every allocation of the engine
+void* operator new(std::size_t size)
+{
+	if (void* memory = countedAllocation(size))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+// Used by the temporary buffers of the standard algorithms, they are freed by the replaced delete
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocation(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocation(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	if (!memory)
+		return;
+
+	Core::Debug::AllocationCounter::removeAllocation(getAllocationSize(memory));
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete(void* memory, std::size_t size) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete[](void* memory, std::size_t size) noexcept
+{
+	operator delete(memory);
+}
+
+#endif
@@ -5,10 +5,12 @@
 #include <imgui_impl_opengl3.h>
 
 #include "resources_manager.hpp"
+#include "file_watcher.hpp"
 #include "thread_manager.hpp"
 #include "inputs_manager.hpp"
 #include "engine_master.hpp"
 #include "benchmarker.hpp"
+#include "tracer.hpp"
 #include "debug.hpp"
 #include "time.hpp"
 
@@ -28,6 +30,8 @@ namespace Core
 
 	Application::~Application()
 	{
+		Resources::FileWatcher::kill();
+
 		Multithread::ThreadManager::kill();
 
 		Resources::ResourcesManager::kill();
@@ -42,6 +46,7 @@ namespace Core
 		Debug::Benchmarker::kill();
 		Debug::Log::kill();
 
+#ifndef ENGINE_HEADLESS
 		// Destroy ImGui context
 		ImGui_ImplGlfw_Shutdown();
 		ImGui::DestroyContext();
@@ -49,6 +54,7 @@ namespace Core
 		// Destroy glfw window
 		glfwDestroyWindow(window);
 		glfwTerminate();
+#endif
 	}
 
 	GLFWwindow* Application::createWindow(unsigned int screenWidth, unsigned int screenHeight, const char* title, GLFWmonitor* monitor, GLFWwindow* share)
@@ -57,6 +63,11 @@ namespace Core
 		if (instance()->hasBeenInitialized())
 			return nullptr;
 
+#ifdef ENGINE_HEADLESS
+		// The headless build is not linked to GLFW, it only runs the benchmark
+		Debug::Assertion::out(false, "The headless build can not create a window");
+		return nullptr;
+#else
 		// glfw - Initialize and configuration
 		glfwInit();
 		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
@@ -91,6 +102,7 @@ namespace Core
 		ImGui_ImplOpenGL3_Init("#version 130");
 
 		return newWindow;
+#endif
 	}
 
 	void windowResizeCallback(GLFWwindow* window, int width, int height)
@@ -98,6 +110,14 @@ namespace Core
 		Application::updateWindowSize(width, height);
 	}
 
+	void Application::setRenderBackend(LowRenderer::RenderBackendType type, const std::string& recordPath)
+	{
+		Application* AP = instance();
+
+		AP->renderBackend = type;
+		AP->recordPath = recordPath;
+	}
+
 	void Application::init(unsigned int screenWidth, unsigned int screenHeight, const char* title, GLFWmonitor* monitor, GLFWwindow* share)
 	{
 		Application* AP = instance();
@@ -114,15 +134,26 @@ namespace Core
 		AP->setInitializationState();
  		Debug::Log::info("Application initialized");
 
+		// Wrap the functions loaded by glad before the first resources are sent
+		if (!LowRenderer::RenderBackend::load(AP->renderBackend, AP->recordPath))
+			Debug::Log::error("Unable to load the render backend, the engine uses OpenGL directly");
+
+#ifndef ENGINE_HEADLESS
 		glfwSetWindowSizeCallback(AP->window, windowResizeCallback);
 
 		int width, height;
 		glfwGetWindowSize(AP->window, &width, &height);
 		updateWindowSize(width, height);
+#endif
+
+		Debug::Tracer::setThreadName("Main thread");
 
 		// Init Managers
 		Resources::ResourcesManager::init(4u);
 
+		// Hot reload the resources when their files change
+		Resources::FileWatcher::init("resources");
+
 		Input::InputManager::init(AP->window);
 
 		AP->setImGuiColorsEditor();
@@ -136,6 +167,7 @@ namespace Core
 		// Avoid big deltatime while loading resources
 		Core::TimeManager::computeTime();
 
+#ifndef ENGINE_HEADLESS
 		// Loop while the game is running
 		while (!glfwWindowShouldClose(AP->window))
 		{
@@ -161,15 +193,19 @@ namespace Core
 			glfwSwapBuffers(AP->window);
 			glfwPollEvents();
 
-			// Initialize resources
+			// Reload the changed resources, then initialize resources
+			Resources::FileWatcher::update();
 			Resources::ResourcesManager::mainThreadQueueInitialize();
 		}
+#endif
 	}
 
 	void Application::closeApplication()
 	{
 		// Tell to glfw to close the window 
+#ifndef ENGINE_HEADLESS
 		glfwSetWindowShouldClose(instance()->window, true);
+#endif
 	}
 
 	float Application::getAspect()
@@ -180,6 +216,7 @@ namespace Core
 
 	void Application::setCursor(bool isCursorFree)
 	{
+#ifndef ENGINE_HEADLESS
 		Application* AP = instance();
 
 		// Toggle the cursor visibility
@@ -190,6 +227,7 @@ namespace Core
 		}
 
 		glfwSetInputMode(AP->window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+#endif
 	}
 
 	Core::Maths::vec2 Application::getWindowSize()
@@ -4,6 +4,8 @@
 
 #include "utils.hpp"
 #include "time.hpp"
+#include "tracer.hpp"
+#include "binary_scene.hpp"
 
 #include "graph.hpp"
 
@@ -56,6 +58,14 @@ namespace Core::Debug
 			if (ImGui::Button("Reset statistics"))
 				resetStatistics();
 
+			Tracer::drawImGui();
+
+			ImGui::InputInt("Generated entities", &BM->generatedEntityCount);
+			ImGui::InputInt("Scene format runs", &BM->formatBenchmarkRuns);
+
+			if (ImGui::Button("Benchmark scene formats"))
+				Resources::BinaryScene::benchmark(BM->generatedEntityCount, BM->formatBenchmarkRuns);
+
 			if (ImGui::CollapsingHeader("Averages"))
 			{
 				for (const auto& sum : BM->timeSums)
@@ -22,7 +22,8 @@ namespace Core
 
 		Log::Log()
 		{
-			printThread = std::thread(&Log::out);
+			// The instance is not set until the constructor returns, the thread is given it
+			printThread = std::thread(&Log::out, this);
 		}
 
 		Log::~Log()
@@ -63,10 +64,8 @@ namespace Core
 			saveToFile("logs/exception.txt", LogType::EXCEPTION);
 		}
 
-		void Log::out()
+		void Log::out(Log* logManager)
 		{
-			Log* logManager = instance();
-
 			while (!logManager->terminate.test())
 			{
 				LogInfo log;
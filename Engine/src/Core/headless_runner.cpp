@@ -0,0 +1,381 @@
+#include "headless_runner.hpp"
+
+#include <thread>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <filesystem>
+
+#include "resources_manager.hpp"
+#include "allocation_counter.hpp"
+#include "physic_manager.hpp"
+#include "render_manager.hpp"
+#include "thread_manager.hpp"
+#include "render_backend.hpp"
+#include "application.hpp"
+#include "null_gl.hpp"
+#include "scene.hpp"
+#include "debug.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#define NOGDI
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace Core::Debug
+{
+	double toMilliseconds(const Tracer::Clock::duration& duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	bool parsePositiveInteger(const char* str, int& value)
+	{
+		char* end = nullptr;
+		long parsedValue = std::strtol(str, &end, 10);
+
+		if (*end != '\0' || parsedValue < 0)
+			return false;
+
+		value = (int)parsedValue;
+		return true;
+	}
+
+	bool HeadlessRunner::isRequested(int argc, char** argv)
+	{
+#ifdef ENGINE_HEADLESS
+		// The headless build has no window, it always runs the benchmark
+		return true;
+#endif
+
+		for (int i = 1; i < argc; i++)
+		{
+			if (std::strcmp(argv[i], "--headless") == 0)
+				return true;
+		}
+
+		return false;
+	}
+
+	bool HeadlessRunner::parseOptions(int argc, char** argv, HeadlessOptions& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			// Every option is followed by its value
+			if (i + 1 >= argc)
+				return false;
+
+			const char* value = argv[++i];
+
+			if (option == "--headless")
+				options.scenePath = value;
+			else if (option == "--output")
+				options.outputPath = value;
+			else if (option == "--runs")
+			{
+				if (!parsePositiveInteger(value, options.runCount))
+					return false;
+			}
+			else if (option == "--frames")
+			{
+				if (!parsePositiveInteger(value, options.frameCount))
+					return false;
+			}
+			else if (option == "--backend")
+			{
+				if (std::strcmp(value, "null") == 0)
+					options.backend = LowRenderer::RenderBackendType::NULL_GL;
+				else if (std::strcmp(value, "recording") == 0)
+					options.backend = LowRenderer::RenderBackendType::RECORDING;
+				else
+					return false;
+			}
+			else if (option == "--record")
+				options.recordPath = value;
+			else if (option == "--workers")
+			{
+				int workerCount;
+				if (!parsePositiveInteger(value, workerCount))
+					return false;
+
+				options.workerCount = (unsigned int)workerCount;
+			}
+			else
+				return false;
+		}
+
+		return !options.scenePath.empty() && options.runCount > 0;
+	}
+
+	std::size_t HeadlessRunner::getPeakResidentBytes()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return 0u;
+
+		return counters.PeakWorkingSetSize;
+#else
+		rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return 0u;
+
+		// The maximum resident set size is given in kilobytes
+		return (std::size_t)usage.ru_maxrss * 1024u;
+#endif
+	}
+
+	void HeadlessRunner::waitForLoad()
+	{
+		// Do the work of the main thread until the load ends, the uploads being stubbed
+		do
+		{
+			Resources::ResourcesManager::mainThreadQueueInitialize();
+			Multithread::ThreadManager::rethrowExceptions();
+
+			std::this_thread::yield();
+		} while (Resources::ResourcesManager::isLoadInProgress());
+	}
+
+	void HeadlessRunner::unloadScene(std::unique_ptr<Resources::Scene>& scene)
+	{
+		// Unload like the Graph does, but remove every resource so each run is a cold load
+		Resources::ResourcesManager::cancelLoading();
+
+		LowRenderer::RenderManager::clearAll();
+		Physics::PhysicManager::clearAll();
+
+		Resources::ResourcesManager::clearResources();
+
+		scene.reset();
+
+		Resources::ResourcesManager::purgeResources();
+	}
+
+	void HeadlessRunner::drawFrames(const Resources::Scene& scene, int frameCount, HeadlessFrameResult& result)
+	{
+		LowRenderer::Camera* camera = LowRenderer::RenderManager::getCurrentCamera();
+
+		if (!camera)
+		{
+			Log::warning("The scene has no camera, its frames are not drawn");
+			return;
+		}
+
+		// The cameras get their aspect in their fixed update, that is not run here
+		camera->aspect = Core::Application::getAspect();
+
+		for (int frame = 0; frame < frameCount; frame++)
+		{
+			LowRenderer::RenderBackend::resetCalls();
+
+			auto frameStart = Tracer::now();
+
+			scene.draw();
+
+			double frameMilliseconds = toMilliseconds(Tracer::now() - frameStart);
+
+			result.totalMilliseconds += frameMilliseconds;
+			result.maxMilliseconds = std::max(result.maxMilliseconds, frameMilliseconds);
+			result.frameCount++;
+		}
+
+		const LowRenderer::RenderCounters& counters = LowRenderer::RenderManager::getFrameCounters();
+
+		result.glCalls = LowRenderer::RenderBackend::getCallCount();
+		result.drawCalls = counters.drawCalls;
+		result.drawnMeshes = counters.drawnMeshes;
+		result.culledMeshes = counters.cameraPass.culled + counters.directionalPass.culled + counters.pointPass.culled;
+		result.occludedMeshes = counters.cameraPass.occluded;
+		result.occluders = counters.occluders;
+		result.occlusionRasterMilliseconds = counters.occlusionRasterMilliseconds;
+		result.programBinds = counters.programBinds;
+		result.materialBinds = counters.materialBinds;
+	}
+
+	bool HeadlessRunner::writeResults(const HeadlessOptions& options, const std::vector<HeadlessRunResult>& results)
+	{
+		std::filesystem::path outputPath(options.outputPath);
+
+		if (outputPath.has_parent_path())
+			std::filesystem::create_directories(outputPath.parent_path());
+
+		std::ofstream outputFile(outputPath);
+
+		if (!outputFile)
+		{
+			Log::error("Unable to write the headless benchmark at " + options.outputPath);
+			return false;
+		}
+
+		outputFile << "{\n\"scene\":" << toJSONString(options.scenePath) << ",\n\"runs\":" << results.size()
+			<< ",\n\"workers\":" << options.workerCount << ",\n\"peakResidentBytes\":" << getPeakResidentBytes()
+			<< ",\n\"allocationTracking\":" << (AllocationCounter::isEnabled() ? "true" : "false")
+			<< ",\n\"nullGLErrors\":" << LowRenderer::getNullGLErrorCount() << ",\n\"results\":[";
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const HeadlessRunResult& result = results[i];
+
+			outputFile << (i ? "," : "") << "\n{\"run\":" << i
+				<< ",\"instantiationMs\":" << result.instantiationMilliseconds
+				<< ",\"loadMs\":" << result.loadMilliseconds;
+
+			// Without the counting operator new, the allocations are unknown rather than zero
+			if (AllocationCounter::isEnabled())
+			{
+				outputFile << ",\"allocations\":" << result.allocationCount
+					<< ",\"allocatedBytes\":" << result.allocatedBytes
+					<< ",\"peakHeapBytes\":" << result.peakHeapBytes;
+			}
+			else
+				outputFile << ",\"allocations\":null,\"allocatedBytes\":null,\"peakHeapBytes\":null";
+
+			outputFile << ",\"stages\":{";
+
+			bool isFirstStage = true;
+			for (const auto& stagePair : result.stages)
+			{
+				outputFile << (isFirstStage ? "" : ",") << toJSONString(stagePair.first)
+					<< ":{\"count\":" << stagePair.second.count
+					<< ",\"totalMs\":" << stagePair.second.totalMilliseconds
+					<< ",\"maxMs\":" << stagePair.second.maxMilliseconds << '}';
+
+				isFirstStage = false;
+			}
+
+			outputFile << '}';
+
+			const HeadlessFrameResult& frames = result.frames;
+
+			if (frames.frameCount > 0)
+			{
+				outputFile << ",\"frames\":{\"count\":" << frames.frameCount
+					<< ",\"averageMs\":" << frames.totalMilliseconds / frames.frameCount
+					<< ",\"maxMs\":" << frames.maxMilliseconds
+					<< ",\"glCalls\":" << frames.glCalls
+					<< ",\"drawCalls\":" << frames.drawCalls
+					<< ",\"drawnMeshes\":" << frames.drawnMeshes
+					<< ",\"culledMeshes\":" << frames.culledMeshes
+					<< ",\"occludedMeshes\":" << frames.occludedMeshes
+					<< ",\"occluders\":" << frames.occluders
+					<< ",\"occlusionRasterMs\":" << frames.occlusionRasterMilliseconds
+					<< ",\"programBinds\":" << frames.programBinds
+					<< ",\"materialBinds\":" << frames.materialBinds << '}';
+			}
+
+			outputFile << '}';
+		}
+
+		outputFile << "\n]\n}\n";
+
+		Log::info("Headless benchmark saved at " + options.outputPath);
+
+		return true;
+	}
+
+	int HeadlessRunner::run(int argc, char** argv)
+	{
+		HeadlessOptions options;
+
+		if (!parseOptions(argc, argv, options))
+		{
+			std::cerr << "Usage: --headless <scene> [--runs <count>] [--workers <count>] [--frames <count>] [--backend null|recording] [--record <path>] [--output <json path>]" << std::endl;
+			Log::kill();
+			return 1;
+		}
+
+		Tracer::setThreadName("Main thread");
+		Tracer::setEnabled(true);
+
+		// No window nor context, the GPU calls are validated and counted but do nothing
+		if (!LowRenderer::RenderBackend::load(options.backend, options.recordPath))
+		{
+			Log::kill();
+			return 1;
+		}
+
+		// The frames are drawn at the size of the window of the engine
+		Core::Application::updateWindowSize(1440, 900);
+
+		Multithread::ThreadManager::setMonoThreaded(options.workerCount == 0u);
+		Resources::ResourcesManager::init(options.workerCount);
+
+		// Do not count the persistent resources in the first run
+		waitForLoad();
+		Tracer::popStageStatistics();
+
+		std::vector<HeadlessRunResult> results;
+		std::unique_ptr<Resources::Scene> scene;
+
+		int exitCode = 0;
+
+		try
+		{
+			for (int run = 0; run < options.runCount; run++)
+			{
+				unloadScene(scene);
+
+				HeadlessRunResult result;
+
+				unsigned long long allocationCount = AllocationCounter::getAllocationCount();
+				unsigned long long allocatedBytes = AllocationCounter::getAllocatedBytes();
+
+				// The peak of the process can not be reset, the one of the heap is measured from each run
+				AllocationCounter::resetPeakBytes();
+
+				auto loadStart = Tracer::now();
+
+				scene = std::make_unique<Resources::Scene>(options.scenePath);
+
+				auto instantiationEnd = Tracer::now();
+
+				waitForLoad();
+
+				auto loadEnd = Tracer::now();
+
+				result.instantiationMilliseconds = toMilliseconds(instantiationEnd - loadStart);
+				result.loadMilliseconds = toMilliseconds(loadEnd - loadStart);
+				result.allocationCount = AllocationCounter::getAllocationCount() - allocationCount;
+				result.allocatedBytes = AllocationCounter::getAllocatedBytes() - allocatedBytes;
+				result.peakHeapBytes = AllocationCounter::getPeakBytes();
+				result.stages = Tracer::popStageStatistics();
+
+				if (options.frameCount > 0)
+					drawFrames(*scene, options.frameCount, result.frames);
+
+				Log::info("Headless run " + std::to_string(run) + " loaded " + options.scenePath + " in " + std::to_string(result.loadMilliseconds) + " ms");
+
+				results.push_back(result);
+			}
+		}
+		catch (const std::exception& exception)
+		{
+			Log::assertion(exception.what());
+			exitCode = 1;
+		}
+		catch (...)
+		{
+			Log::assertion("Exception not supported.");
+			exitCode = 1;
+		}
+
+		unloadScene(scene);
+
+		if (!writeResults(options, results))
+			exitCode = 1;
+
+		Multithread::ThreadManager::kill();
+		Resources::ResourcesManager::kill();
+		Log::kill();
+
+		return exitCode;
+	}
+}
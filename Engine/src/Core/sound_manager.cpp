@@ -1,5 +1,9 @@
 #include "sound_manager.hpp"
 
+#ifndef ENGINE_HEADLESS
+#include <irrklang/irrklang.h>
+#endif
+
 #include "debug.hpp"
 
 namespace Core::Engine
@@ -14,23 +18,32 @@ namespace Core::Engine
 		Core::Debug::Log::info("Destroying the Sound Manager");
 	}
 
+	// The headless build has no sound device, its sounds are never played
 	void SoundManager::init()
 	{
+#ifndef ENGINE_HEADLESS
 		instance()->m_soundEngine = irrklang::createIrrKlangDevice();
+#endif
 	}
 
 	void SoundManager::play2D(const std::string& path, bool loop)
 	{
+#ifndef ENGINE_HEADLESS
 		irrklang::ISoundEngine* soundEngine = instance()->m_soundEngine;
 
 		if (soundEngine)
 			soundEngine->play2D(path.c_str(), loop);
+#endif
 	}
 
 	bool SoundManager::isPlaying(const std::string& path)
 	{
+#ifndef ENGINE_HEADLESS
 		irrklang::ISoundEngine* soundEngine = instance()->m_soundEngine;
 
 		return soundEngine && soundEngine->isCurrentlyPlaying(path.c_str());
+#else
+		return false;
+#endif
 	}
 }
\ No newline at end of file
@@ -38,6 +38,11 @@ namespace Multithread
         return instance()->monoThread;
     }
 
+    void ThreadManager::setMonoThreaded(bool isMonoThreaded)
+    {
+        instance()->monoThread = isMonoThreaded;
+    }
+
     void ThreadManager::stopAllThread(const std::string& poolKey)
     {
         instance()->pools[poolKey].stopAllThread();
@@ -61,6 +66,11 @@ namespace Multithread
         instance()->pools[poolKey].syncAndClean();
     }
 
+    void ThreadManager::discardCancelled(const std::string& poolKey)
+    {
+        instance()->pools[poolKey].discardCancelled();
+    }
+
     void ThreadManager::syncAll()
     {
         ThreadManager* TM = instance();
@@ -4,6 +4,7 @@
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 #include <algorithm>
+#include <chrono>
 
 #include "debug.hpp"
 
@@ -23,8 +24,13 @@ namespace Core
 	{
 		TimeManager* TM = instance();
 
-		// Update the Application Time
+		// Update the Application Time, from the start of the process in the headless build which has no GLFW
+#ifdef ENGINE_HEADLESS
+		static const auto startTime = std::chrono::steady_clock::now();
+		TM->time = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+#else
 		TM->time = (float)glfwGetTime();
+#endif
 
 		TM->unscaledDeltaTime = TM->time - TM->lastTime;
 		TM->deltaTime = TM->unscaledDeltaTime * TM->timeScale;
@@ -0,0 +1,212 @@
+#include "tracer.hpp"
+
+#include <imgui.h>
+
+#include <filesystem>
+#include <fstream>
+#include <climits>
+#include <algorithm>
+#include <cstdio>
+
+#include "debug.hpp"
+
+namespace Core::Debug
+{
+	// Escape the characters that are not allowed in a JSON string
+	std::string toJSONString(const std::string& str)
+	{
+		std::string escaped = "\"";
+
+		for (char c : str)
+		{
+			switch (c)
+			{
+			case '"':  escaped += "\\\""; break;
+			case '\\': escaped += "\\\\"; break;
+			case '\b': escaped += "\\b"; break;
+			case '\f': escaped += "\\f"; break;
+			case '\n': escaped += "\\n"; break;
+			case '\r': escaped += "\\r"; break;
+			case '\t': escaped += "\\t"; break;
+
+			default:
+				// The other control characters are written as unicode escapes
+				if ((unsigned char)c < 0x20)
+				{
+					char unicode[7];
+					std::snprintf(unicode, sizeof(unicode), "\\u%04x", (unsigned int)(unsigned char)c);
+					escaped += unicode;
+				}
+				else
+					escaped += c;
+			}
+		}
+
+		return escaped + '"';
+	}
+
+	unsigned int Tracer::getThreadIndex()
+	{
+		static thread_local unsigned int threadIndex = UINT_MAX;
+
+		// Give a small index to each thread, the first time it records something
+		if (threadIndex == UINT_MAX)
+			threadIndex = instance()->threadCount++;
+
+		return threadIndex;
+	}
+
+	Tracer::Clock::time_point Tracer::now()
+	{
+		return Clock::now();
+	}
+
+	void Tracer::setThreadName(const std::string& threadName)
+	{
+		Tracer* TR = instance();
+
+		unsigned int threadIndex = getThreadIndex();
+
+		while (TR->lockThreadNames.test_and_set());
+		TR->threadNames[threadIndex] = threadName;
+		TR->lockThreadNames.clear();
+	}
+
+	void Tracer::setEnabled(bool enabled)
+	{
+		instance()->enabled = enabled;
+	}
+
+	bool Tracer::isRecording()
+	{
+		return instance()->isTracing;
+	}
+
+	void Tracer::beginTrace()
+	{
+		Tracer* TR = instance();
+
+		if (!TR->enabled || TR->isTracing)
+			return;
+
+		TR->events.clear();
+		TR->stageStatistics.clear();
+		TR->traceStart = now();
+		TR->isTracing = true;
+	}
+
+	void Tracer::endTrace(const std::string& loadState)
+	{
+		Tracer* TR = instance();
+
+		if (!TR->isTracing)
+			return;
+
+		TR->isTracing = false;
+
+		std::filesystem::create_directories("logs/traces");
+
+		std::string tracePath = "logs/traces/load_" + std::to_string(TR->traceCount++) + ".json";
+		std::ofstream traceFile(tracePath);
+
+		if (!traceFile)
+		{
+			Log::error("Unable to write the load trace at " + tracePath);
+			TR->events.clear();
+			return;
+		}
+
+		traceFile << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"load\":" << toJSONString(loadState) << "},\"traceEvents\":[";
+
+		// Write the stages as complete events, in microseconds since the start of the load
+		TraceEvent event;
+		bool isFirst = true;
+		while (TR->events.tryPop(event))
+		{
+			auto timestamp = std::chrono::duration<double, std::micro>(event.start - TR->traceStart).count();
+			auto duration = std::chrono::duration<double, std::micro>(event.end - event.start).count();
+
+			StageStatistics& statistics = TR->stageStatistics[event.stage];
+			statistics.count++;
+			statistics.totalMilliseconds += duration / 1000.0;
+			statistics.maxMilliseconds = std::max(statistics.maxMilliseconds, duration / 1000.0);
+
+			if (!isFirst)
+				traceFile << ',';
+
+			traceFile << "\n{\"name\":" << toJSONString(event.stage) << ",\"cat\":\"load\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.threadIndex
+				<< ",\"ts\":" << timestamp << ",\"dur\":" << duration << ",\"args\":{\"resource\":" << toJSONString(event.resourceName) << "}}";
+
+			isFirst = false;
+		}
+
+		// Name the threads
+		unsigned int threadCount = TR->threadCount;
+		for (unsigned int threadIndex = 0u; threadIndex < threadCount; threadIndex++)
+		{
+			while (TR->lockThreadNames.test_and_set());
+			auto nameIt = TR->threadNames.find(threadIndex);
+			std::string threadName = nameIt != TR->threadNames.end() ? nameIt->second : "Worker thread " + std::to_string(threadIndex);
+			TR->lockThreadNames.clear();
+
+			if (!isFirst)
+				traceFile << ',';
+
+			traceFile << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << threadIndex << ",\"args\":{\"name\":" << toJSONString(threadName) << "}}";
+
+			isFirst = false;
+		}
+
+		traceFile << "\n]}\n";
+
+		TR->lastTracePath = tracePath;
+		Log::info("Load trace saved at " + tracePath);
+	}
+
+	void Tracer::addEvent(const std::string& stage, const std::string& resourceName, const Clock::time_point& start, const Clock::time_point& end)
+	{
+		Tracer* TR = instance();
+
+		if (!TR->isTracing)
+			return;
+
+		TR->events.tryPush({ stage, resourceName, start, end, getThreadIndex() });
+	}
+
+	std::unordered_map<std::string, StageStatistics> Tracer::popStageStatistics()
+	{
+		std::unordered_map<std::string, StageStatistics> statistics;
+		statistics.swap(instance()->stageStatistics);
+
+		return statistics;
+	}
+
+	void Tracer::drawImGui()
+	{
+		Tracer* TR = instance();
+
+		ImGui::Checkbox("Record load traces", &TR->enabled);
+
+		if (!TR->lastTracePath.empty())
+		{
+			std::string lastTraceString = "Last trace = " + TR->lastTracePath;
+			ImGui::Text(lastTraceString.c_str());
+		}
+	}
+
+	Tracer::Scope::Scope(const char* stage, const std::string& resourceName)
+		: stage(stage), isRecording(Tracer::isRecording())
+	{
+		if (!isRecording)
+			return;
+
+		this->resourceName = resourceName;
+		start = now();
+	}
+
+	Tracer::Scope::~Scope()
+	{
+		if (isRecording)
+			addEvent(stage, resourceName, start, now());
+	}
+}
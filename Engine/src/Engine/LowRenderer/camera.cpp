@@ -22,6 +22,13 @@ namespace LowRenderer
 		LowRenderer::RenderManager::linkComponent(this);
 	}
 
+	Core::Maths::vec3 Camera::getPosition() const
+	{
+		Core::Maths::mat4 model = m_transform->globalModel;
+
+		return Core::Maths::vec3(model.e[3], model.e[7], model.e[11]);
+	}
+
 	Core::Maths::mat4 Camera::getViewMatrix() const
 	{
 		auto globalPosition = -m_transform->getGlobalPosition();
@@ -81,22 +88,19 @@ namespace LowRenderer
 
 	void Camera::sendViewProjToProgram(const std::shared_ptr<Resources::ShaderProgram> program)
 	{
-		program->setUniform("viewProj", getViewProjection().e, true, 1, 1);
-
-		Core::Maths::mat4 model = m_transform->globalModel;
-		Core::Maths::vec3 viewPos = Core::Maths::vec3(model.e[3], model.e[7], model.e[11]);
+		program->setUniform(UniformIDs::viewProj, getViewProjection());
 
-		program->setUniform("viewPos", viewPos.e, true);
+		program->setUniform(UniformIDs::viewPos, getPosition());
 	}
 
 	void Camera::sendViewOrthoToProgram(const std::shared_ptr<Resources::ShaderProgram> program)
 	{
-		program->setUniform("viewOrtho", getViewOrthographic().e, true, 1, 1);
+		program->setUniform(UniformIDs::viewOrtho, getViewOrthographic());
 	}
 
 	void Camera::sendProjToProgram(const std::shared_ptr<Resources::ShaderProgram> program)
 	{
-		program->setUniform("viewProj", getViewProjection().e, true, 1, 1);
+		program->setUniform(UniformIDs::viewProj, getViewProjection());
 	}
 
 	void Camera::drawImGui()
@@ -118,7 +122,7 @@ namespace LowRenderer
 		return "COMP CAMERA " + std::to_string(near) + " " + std::to_string(far) + " " + std::to_string(fovY);
 	}
 
-	void Camera::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void Camera::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		owner.addComponent<Camera>();
 		auto cam = owner.getComponent<Camera>();
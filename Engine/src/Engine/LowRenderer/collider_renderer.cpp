@@ -3,19 +3,28 @@
 #include "imgui.h"
 
 #include "render_manager.hpp"
+#include "debug_draw.hpp"
+#include "sphere_collider.hpp"
 
 namespace LowRenderer
 {
-	ColliderRenderer::ColliderRenderer(Engine::Entity& owner, Physics::Collider* ptr, const std::string& modelFilePath)
-		: Renderer(owner, "colliderShader", false), collider(ptr), model(modelFilePath, nullptr)
+	ColliderRenderer::ColliderRenderer(Engine::Entity& owner, Physics::Collider* ptr)
+		: Renderer(owner, "debugLineShader", false), collider(ptr)
 	{
 		LowRenderer::RenderManager::linkComponent(this);
 	}
 
 	void ColliderRenderer::draw() const
 	{
-		Core::Maths::mat4 newModel = getModelCollider();
-		model.drawCollider(m_shaderProgram, newModel);
+		addLines();
+	}
+
+	void ColliderRenderer::addLines() const
+	{
+		if (dynamic_cast<Physics::SphereCollider*>(collider))
+			DebugDraw::sphere(collider->m_center, collider->extensions.x, MAT_COLLIDER_COLOR);
+		else
+			DebugDraw::box(getModelCollider(), MAT_COLLIDER_COLOR);
 	}
 
 	Core::Maths::mat4 ColliderRenderer::getModelCollider() const
@@ -0,0 +1,207 @@
+#include "debug_draw.hpp"
+
+#include <cmath>
+#include <cstddef>
+
+#include "resources_manager.hpp"
+#include "gl_state_cache.hpp"
+#include "shader.hpp"
+#include "uniform.hpp"
+
+namespace LowRenderer
+{
+	DebugDraw::~DebugDraw()
+	{
+		if (VBO)
+			glDeleteBuffers(1, &VBO);
+
+		if (VAO)
+			glDeleteVertexArrays(1, &VAO);
+	}
+
+	void DebugDraw::createBuffers()
+	{
+		glGenVertexArrays(1, &VAO);
+		GLStateCache::bindVertexArray(VAO);
+
+		glGenBuffers(1, &VBO);
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, VBO);
+
+		GLsizei stride = sizeof(DebugVertex);
+
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(DebugVertex, position)));
+		glEnableVertexAttribArray(0);
+
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(DebugVertex, color)));
+		glEnableVertexAttribArray(1);
+	}
+
+	void DebugDraw::addCircle(const Core::Maths::vec3& center, const Core::Maths::vec3& axis, float radius, const Core::Maths::vec3& color, int segmentCount)
+	{
+		// Any direction perpendicular to the axis starts the circle
+		Core::Maths::vec3 start = std::abs(axis.y) < 0.9f ? axis ^ Core::Maths::vec3(0.f, 1.f, 0.f) : axis ^ Core::Maths::vec3(1.f, 0.f, 0.f);
+		start.normalize();
+
+		addArc(center, axis, start, radius, color, segmentCount / 2);
+		addArc(center, axis, -start, radius, color, segmentCount / 2);
+	}
+
+	void DebugDraw::addArc(const Core::Maths::vec3& center, const Core::Maths::vec3& axis, const Core::Maths::vec3& start, float radius, const Core::Maths::vec3& color, int segmentCount)
+	{
+		Core::Maths::vec3 side = axis ^ start;
+		Core::Maths::vec3 previous = center + start * radius;
+
+		for (int i = 1; i <= segmentCount; i++)
+		{
+			float angle = Core::Maths::PI * (float)i / (float)segmentCount;
+			Core::Maths::vec3 current = center + (start * std::cos(angle) + side * std::sin(angle)) * radius;
+
+			vertices.push_back({ previous, color });
+			vertices.push_back({ current, color });
+
+			previous = current;
+		}
+	}
+
+	void DebugDraw::line(const Core::Maths::vec3& start, const Core::Maths::vec3& end, const Core::Maths::vec3& color)
+	{
+		DebugDraw* DD = instance();
+
+		DD->vertices.push_back({ start, color });
+		DD->vertices.push_back({ end, color });
+	}
+
+	void DebugDraw::ray(const Core::Maths::vec3& origin, const Core::Maths::vec3& direction, const Core::Maths::vec3& color)
+	{
+		line(origin, origin + direction, color);
+	}
+
+	void DebugDraw::box(const Core::Maths::mat4& transform, const Core::Maths::vec3& color)
+	{
+		Core::Maths::vec3 corners[8];
+
+		for (int i = 0; i < 8; i++)
+		{
+			Core::Maths::vec4 corner((i & 1) ? 1.f : -1.f, (i & 2) ? 1.f : -1.f, (i & 4) ? 1.f : -1.f, 1.f);
+			corners[i] = (transform * corner).xyz;
+		}
+
+		// The corners of an edge only differ by one bit of their index
+		for (int i = 0; i < 8; i++)
+		{
+			for (int bit = 1; bit < 8; bit <<= 1)
+			{
+				if (!(i & bit))
+					line(corners[i], corners[i | bit], color);
+			}
+		}
+	}
+
+	void DebugDraw::aabb(const Core::Maths::vec3& center, const Core::Maths::vec3& extents, const Core::Maths::vec3& color)
+	{
+		box(Core::Maths::translate(center) * Core::Maths::scale(extents), color);
+	}
+
+	void DebugDraw::sphere(const Core::Maths::vec3& center, float radius, const Core::Maths::vec3& color)
+	{
+		DebugDraw* DD = instance();
+
+		DD->addCircle(center, Core::Maths::vec3(1.f, 0.f, 0.f), radius, color, circleSegmentCount);
+		DD->addCircle(center, Core::Maths::vec3(0.f, 1.f, 0.f), radius, color, circleSegmentCount);
+		DD->addCircle(center, Core::Maths::vec3(0.f, 0.f, 1.f), radius, color, circleSegmentCount);
+	}
+
+	void DebugDraw::capsule(const Core::Maths::vec3& start, const Core::Maths::vec3& end, float radius, const Core::Maths::vec3& color)
+	{
+		DebugDraw* DD = instance();
+
+		Core::Maths::vec3 axis = end - start;
+
+		if (axis.squaredMagnitude() == 0.f)
+		{
+			sphere(start, radius, color);
+			return;
+		}
+
+		axis.normalize();
+
+		Core::Maths::vec3 right = std::abs(axis.y) < 0.9f ? axis ^ Core::Maths::vec3(0.f, 1.f, 0.f) : axis ^ Core::Maths::vec3(1.f, 0.f, 0.f);
+		right.normalize();
+		Core::Maths::vec3 forward = axis ^ right;
+
+		// Rings at both ends, joined by four lines
+		DD->addCircle(start, axis, radius, color, circleSegmentCount);
+		DD->addCircle(end, axis, radius, color, circleSegmentCount);
+
+		line(start + right * radius, end + right * radius, color);
+		line(start - right * radius, end - right * radius, color);
+		line(start + forward * radius, end + forward * radius, color);
+		line(start - forward * radius, end - forward * radius, color);
+
+		// Half circles closing the ends, in two perpendicular planes
+		DD->addArc(end, -forward, right, radius, color, circleSegmentCount / 2);
+		DD->addArc(end, right, forward, radius, color, circleSegmentCount / 2);
+		DD->addArc(start, forward, right, radius, color, circleSegmentCount / 2);
+		DD->addArc(start, -right, forward, radius, color, circleSegmentCount / 2);
+	}
+
+	void DebugDraw::point(const Core::Maths::vec3& position, float size, const Core::Maths::vec3& color)
+	{
+		float halfSize = size * 0.5f;
+
+		line(position - Core::Maths::vec3(halfSize, 0.f, 0.f), position + Core::Maths::vec3(halfSize, 0.f, 0.f), color);
+		line(position - Core::Maths::vec3(0.f, halfSize, 0.f), position + Core::Maths::vec3(0.f, halfSize, 0.f), color);
+		line(position - Core::Maths::vec3(0.f, 0.f, halfSize), position + Core::Maths::vec3(0.f, 0.f, halfSize), color);
+	}
+
+	void DebugDraw::contact(const Core::Maths::vec3& position, const Core::Maths::vec3& normal, const Core::Maths::vec3& color)
+	{
+		point(position, 0.2f, color);
+		ray(position, normal.normalized() * 0.5f, color);
+	}
+
+	unsigned int DebugDraw::flush(const Core::Maths::mat4& viewProjection)
+	{
+		DebugDraw* DD = instance();
+
+		if (DD->vertices.empty())
+			return 0u;
+
+		std::shared_ptr<Resources::ShaderProgram> program = Resources::ResourcesManager::loadShaderProgram("debugLineShader");
+
+		if (!program->bind())
+		{
+			DD->vertices.clear();
+			return 0u;
+		}
+
+		if (!DD->VAO)
+			DD->createBuffers();
+		else
+		{
+			GLStateCache::bindVertexArray(DD->VAO);
+			GLStateCache::bindBuffer(GL_ARRAY_BUFFER, DD->VBO);
+		}
+
+		program->setUniform(UniformIDs::viewProj, viewProjection);
+
+		// Orphan the previous buffer and upload all the lines of the frame
+		glBufferData(GL_ARRAY_BUFFER, DD->vertices.size() * sizeof(DebugVertex), DD->vertices.data(), GL_STREAM_DRAW);
+		glDrawArrays(GL_LINES, 0, (GLsizei)DD->vertices.size());
+
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, 0);
+		GLStateCache::bindVertexArray(0);
+
+		program->unbind();
+
+		unsigned int lineCount = (unsigned int)(DD->vertices.size() / 2u);
+		DD->vertices.clear();
+
+		return lineCount;
+	}
+
+	void DebugDraw::clear()
+	{
+		instance()->vertices.clear();
+	}
+}
@@ -0,0 +1,63 @@
+#include "frustum.hpp"
+
+#include <xmmintrin.h>
+#include <cfloat>
+
+namespace LowRenderer
+{
+	Frustum::Frustum(const Core::Maths::mat4& viewProjection)
+	{
+		const float* e = viewProjection.e;
+
+		// Combine the rows of the matrix to get the left, right, bottom, top, near and far planes
+		for (int i = 0; i < 6; i++)
+		{
+			int row = i / 2;
+			float sign = i % 2 == 0 ? 1.f : -1.f;
+
+			planeX[i] = e[12] + sign * e[row * 4 + 0];
+			planeY[i] = e[13] + sign * e[row * 4 + 1];
+			planeZ[i] = e[14] + sign * e[row * 4 + 2];
+			planeW[i] = e[15] + sign * e[row * 4 + 3];
+		}
+
+		for (int i = 6; i < 8; i++)
+		{
+			planeX[i] = planeY[i] = planeZ[i] = 0.f;
+			planeW[i] = FLT_MAX;
+		}
+	}
+
+	bool Frustum::intersects(const Core::Maths::vec3& center, const Core::Maths::vec3& extents) const
+	{
+		const __m128 signMask = _mm_set1_ps(-0.f);
+
+		const __m128 centerX = _mm_set1_ps(center.x);
+		const __m128 centerY = _mm_set1_ps(center.y);
+		const __m128 centerZ = _mm_set1_ps(center.z);
+
+		const __m128 extentX = _mm_set1_ps(extents.x);
+		const __m128 extentY = _mm_set1_ps(extents.y);
+		const __m128 extentZ = _mm_set1_ps(extents.z);
+
+		for (int i = 0; i < 8; i += 4)
+		{
+			__m128 x = _mm_load_ps(planeX + i);
+			__m128 y = _mm_load_ps(planeY + i);
+			__m128 z = _mm_load_ps(planeZ + i);
+			__m128 w = _mm_load_ps(planeW + i);
+
+			// Signed distance of the center to the planes
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, centerX), _mm_mul_ps(y, centerY)), _mm_add_ps(_mm_mul_ps(z, centerZ), w));
+
+			// Projection of the box extents on the plane normals
+			__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, x), extentX), _mm_mul_ps(_mm_andnot_ps(signMask, y), extentY)), _mm_mul_ps(_mm_andnot_ps(signMask, z), extentZ));
+
+			// The box is outside if it is entirely behind one of the planes
+			if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps())))
+				return false;
+		}
+
+		return true;
+	}
+}
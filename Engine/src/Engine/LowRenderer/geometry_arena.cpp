@@ -0,0 +1,267 @@
+#include "geometry_arena.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include <imgui.h>
+
+#include "mesh.hpp"
+#include "gl_state_cache.hpp"
+
+namespace LowRenderer
+{
+	ArenaBuffer::ArenaBuffer(GLsizeiptr elementSize, GLuint initialCapacity)
+		: elementSize(elementSize)
+	{
+		grow(initialCapacity);
+	}
+
+	ArenaBuffer::~ArenaBuffer()
+	{
+		if (ID)
+			glDeleteBuffers(1, &ID);
+	}
+
+	void ArenaBuffer::grow(GLuint minCapacity)
+	{
+		GLuint newCapacity = std::max(minCapacity, capacity * 2u);
+
+		GLuint newID = 0u;
+		glGenBuffers(1, &newID);
+
+		// The copy targets do not change the element buffer of the bound VAO
+		glBindBuffer(GL_COPY_WRITE_BUFFER, newID);
+		glBufferData(GL_COPY_WRITE_BUFFER, newCapacity * elementSize, nullptr, GL_STATIC_DRAW);
+
+		if (ID)
+		{
+			glBindBuffer(GL_COPY_READ_BUFFER, ID);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, capacity * elementSize);
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+			glDeleteBuffers(1, &ID);
+		}
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		// Add the new elements to the free-list, merged with the last free range if it ends the buffer
+		if (!freeRanges.empty() && freeRanges.back().first + freeRanges.back().count == capacity)
+			freeRanges.back().count += newCapacity - capacity;
+		else
+			freeRanges.push_back({ capacity, newCapacity - capacity });
+
+		ID = newID;
+		capacity = newCapacity;
+	}
+
+	bool ArenaBuffer::allocate(GLuint count, ArenaRange& range)
+	{
+		bool hasGrown = false;
+
+		auto freeIt = std::find_if(freeRanges.begin(), freeRanges.end(), [count](const ArenaRange& freeRange) { return freeRange.count >= count; });
+
+		if (freeIt == freeRanges.end())
+		{
+			// The free range at the end of the buffer is extended by the growth
+			GLuint tailCount = !freeRanges.empty() && freeRanges.back().first + freeRanges.back().count == capacity ? freeRanges.back().count : 0u;
+
+			grow(capacity + count - tailCount);
+			hasGrown = true;
+
+			freeIt = freeRanges.end() - 1;
+		}
+
+		range = { freeIt->first, count };
+
+		freeIt->first += count;
+		freeIt->count -= count;
+
+		if (freeIt->count == 0u)
+			freeRanges.erase(freeIt);
+
+		usedCount += count;
+
+		return hasGrown;
+	}
+
+	void ArenaBuffer::free(ArenaRange& range)
+	{
+		if (range.count == 0u)
+			return;
+
+		auto nextIt = std::lower_bound(freeRanges.begin(), freeRanges.end(), range, [](const ArenaRange& lhs, const ArenaRange& rhs) { return lhs.first < rhs.first; });
+		auto rangeIt = freeRanges.insert(nextIt, range);
+
+		// Merge with the next free range
+		auto followingIt = rangeIt + 1;
+		if (followingIt != freeRanges.end() && rangeIt->first + rangeIt->count == followingIt->first)
+		{
+			rangeIt->count += followingIt->count;
+			rangeIt = freeRanges.erase(followingIt) - 1;
+		}
+
+		// Merge with the previous free range
+		if (rangeIt != freeRanges.begin())
+		{
+			auto previousIt = rangeIt - 1;
+			if (previousIt->first + previousIt->count == rangeIt->first)
+			{
+				previousIt->count += rangeIt->count;
+				freeRanges.erase(rangeIt);
+			}
+		}
+
+		usedCount -= range.count;
+		range = {};
+	}
+
+	void ArenaBuffer::upload(const ArenaRange& range, const void* data)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, range.first * elementSize, range.count * elementSize, data);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	GLuint ArenaBuffer::getID() const
+	{
+		return ID;
+	}
+
+	GLuint ArenaBuffer::getCapacity() const
+	{
+		return capacity;
+	}
+
+	GLuint ArenaBuffer::getUsedCount() const
+	{
+		return usedCount;
+	}
+
+	size_t ArenaBuffer::getFreeRangeCount() const
+	{
+		return freeRanges.size();
+	}
+
+	GeometryArena::GeometryArena()
+		: vertices(sizeof(Resources::Vertex), 1u << 18), indices(sizeof(unsigned int), 1u << 20)
+	{
+		glGenVertexArrays(1, &VAO);
+		glGenBuffers(1, &drawIndexBuffer);
+
+		growDrawIndices(1024u);
+		setVertexFormat();
+	}
+
+	GeometryArena::~GeometryArena()
+	{
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &drawIndexBuffer);
+	}
+
+	void GeometryArena::setVertexFormat()
+	{
+		GLStateCache::bindVertexArray(VAO);
+
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, vertices.getID());
+
+		GLsizei stride = sizeof(Resources::Vertex);
+
+		// Set the attrib pointer to the positions
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(Resources::Vertex, position)));
+		glEnableVertexAttribArray(0);
+
+		// Set the attrib pointer to the texture coordinates
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(Resources::Vertex, texCoords)));
+		glEnableVertexAttribArray(1);
+
+		// Set the attrib pointer to the tangents
+		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(Resources::Vertex, tangent)));
+		glEnableVertexAttribArray(2);
+
+		// Set the attrib pointer to the bitangents
+		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(Resources::Vertex, bitangent)));
+		glEnableVertexAttribArray(3);
+
+		// Set the attrib pointer to the normals
+		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(Resources::Vertex, normal)));
+		glEnableVertexAttribArray(4);
+
+		// Set the attrib pointer to the draw indices, advanced once per instance
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, drawIndexBuffer);
+		glVertexAttribIPointer(5, 1, GL_UNSIGNED_INT, sizeof(GLuint), (GLvoid*)0);
+		glVertexAttribDivisor(5, 1);
+		glEnableVertexAttribArray(5);
+
+		GLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices.getID());
+
+		GLStateCache::bindVertexArray(0);
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void GeometryArena::allocate(GLuint vertexCount, GLuint indexCount, ArenaRange& vertexRange, ArenaRange& indexRange)
+	{
+		GeometryArena* GA = instance();
+
+		bool hasGrown = GA->vertices.allocate(vertexCount, vertexRange);
+		hasGrown |= GA->indices.allocate(indexCount, indexRange);
+
+		// Point the VAO to the new buffers
+		if (hasGrown)
+			GA->setVertexFormat();
+	}
+
+	void GeometryArena::free(ArenaRange& vertexRange, ArenaRange& indexRange)
+	{
+		GeometryArena* GA = instance();
+
+		GA->vertices.free(vertexRange);
+		GA->indices.free(indexRange);
+	}
+
+	void GeometryArena::upload(const ArenaRange& vertexRange, const Resources::Vertex* vertexData, const ArenaRange& indexRange, const unsigned int* indexData)
+	{
+		GeometryArena* GA = instance();
+
+		GA->vertices.upload(vertexRange, vertexData);
+		GA->indices.upload(indexRange, indexData);
+	}
+
+	void GeometryArena::growDrawIndices(GLuint drawCount)
+	{
+		drawIndexCapacity = std::max(drawCount, drawIndexCapacity * 2u);
+
+		std::vector<GLuint> drawIndices(drawIndexCapacity);
+		std::iota(drawIndices.begin(), drawIndices.end(), 0u);
+
+		// The VAO keeps pointing to the same buffer
+		glBindBuffer(GL_COPY_WRITE_BUFFER, drawIndexBuffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, drawIndices.size() * sizeof(GLuint), drawIndices.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	void GeometryArena::reserveDraws(GLuint drawCount)
+	{
+		GeometryArena* GA = instance();
+
+		if (drawCount > GA->drawIndexCapacity)
+			GA->growDrawIndices(drawCount);
+	}
+
+	void GeometryArena::bind()
+	{
+		GLStateCache::bindVertexArray(instance()->VAO);
+	}
+
+	void GeometryArena::unbind()
+	{
+		GLStateCache::bindVertexArray(0);
+	}
+
+	void GeometryArena::drawImGui()
+	{
+		GeometryArena* GA = instance();
+
+		ImGui::Text("Arena vertices: %u / %u (%zu free ranges)", GA->vertices.getUsedCount(), GA->vertices.getCapacity(), GA->vertices.getFreeRangeCount());
+		ImGui::Text("Arena indices: %u / %u (%zu free ranges)", GA->indices.getUsedCount(), GA->indices.getCapacity(), GA->indices.getFreeRangeCount());
+	}
+}
@@ -0,0 +1,175 @@
+#include "gl_state_cache.hpp"
+
+#include <imgui.h>
+
+namespace LowRenderer
+{
+	bool GLStateCache::count(GLCallCounter& counter, bool isElided)
+	{
+		isElided ? counter.elided++ : counter.issued++;
+
+		return isElided;
+	}
+
+	void GLStateCache::invalidate()
+	{
+		GLStateCache* GS = instance();
+
+		GS->program = unknownBinding;
+		GS->vertexArray = unknownBinding;
+		GS->framebuffer = unknownBinding;
+		GS->activeTextureUnit = unknownBinding;
+		GS->cullFaceMode = unknownBinding;
+
+		GS->textures.clear();
+		GS->buffers.clear();
+		GS->indexedBuffers.clear();
+		GS->caps.clear();
+	}
+
+	void GLStateCache::beginFrame()
+	{
+		GLStateCache* GS = instance();
+
+		GS->lastCounters = GS->counters;
+		GS->counters = {};
+
+		invalidate();
+	}
+
+	void GLStateCache::useProgram(GLuint program)
+	{
+		GLStateCache* GS = instance();
+
+		if (count(GS->counters.programs, GS->program == program))
+			return;
+
+		GS->program = program;
+		glUseProgram(program);
+	}
+
+	void GLStateCache::bindVertexArray(GLuint vertexArray)
+	{
+		GLStateCache* GS = instance();
+
+		if (count(GS->counters.vertexArrays, GS->vertexArray == vertexArray))
+			return;
+
+		GS->vertexArray = vertexArray;
+		glBindVertexArray(vertexArray);
+	}
+
+	void GLStateCache::bindFramebuffer(GLuint framebuffer)
+	{
+		GLStateCache* GS = instance();
+
+		if (count(GS->counters.framebuffers, GS->framebuffer == framebuffer))
+			return;
+
+		GS->framebuffer = framebuffer;
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	}
+
+	void GLStateCache::bindTexture(GLuint unit, GLenum target, GLuint texture)
+	{
+		GLStateCache* GS = instance();
+
+		uint64_t key = ((uint64_t)unit << 32) | target;
+
+		auto textureIt = GS->textures.find(key);
+		if (count(GS->counters.textures, textureIt != GS->textures.end() && textureIt->second == texture))
+			return;
+
+		GS->textures[key] = texture;
+
+		if (GS->activeTextureUnit != unit)
+		{
+			GS->activeTextureUnit = unit;
+			glActiveTexture(GL_TEXTURE0 + unit);
+		}
+
+		glBindTexture(target, texture);
+	}
+
+	void GLStateCache::bindBuffer(GLenum target, GLuint buffer)
+	{
+		GLStateCache* GS = instance();
+
+		// The element buffer belongs to the bound VAO
+		if (target == GL_ELEMENT_ARRAY_BUFFER)
+		{
+			count(GS->counters.buffers, false);
+			glBindBuffer(target, buffer);
+			return;
+		}
+
+		auto bufferIt = GS->buffers.find(target);
+		if (count(GS->counters.buffers, bufferIt != GS->buffers.end() && bufferIt->second == buffer))
+			return;
+
+		GS->buffers[target] = buffer;
+		glBindBuffer(target, buffer);
+	}
+
+	void GLStateCache::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+	{
+		GLStateCache* GS = instance();
+
+		uint64_t key = ((uint64_t)index << 32) | target;
+
+		auto bufferIt = GS->indexedBuffers.find(key);
+		if (count(GS->counters.buffers, bufferIt != GS->indexedBuffers.end() && bufferIt->second == buffer))
+			return;
+
+		// Binding an indexed buffer also binds the generic target
+		GS->indexedBuffers[key] = buffer;
+		GS->buffers[target] = buffer;
+		glBindBufferBase(target, index, buffer);
+	}
+
+	void GLStateCache::setCapState(GLenum cap, bool state)
+	{
+		GLStateCache* GS = instance();
+
+		auto capIt = GS->caps.find(cap);
+		if (count(GS->counters.caps, capIt != GS->caps.end() && capIt->second == state))
+			return;
+
+		GS->caps[cap] = state;
+		state ? glEnable(cap) : glDisable(cap);
+	}
+
+	void GLStateCache::cullFace(GLenum mode)
+	{
+		GLStateCache* GS = instance();
+
+		if (count(GS->counters.caps, GS->cullFaceMode == mode))
+			return;
+
+		GS->cullFaceMode = mode;
+		glCullFace(mode);
+	}
+
+	void GLStateCache::countUniform(bool isElided)
+	{
+		count(instance()->counters.uniforms, isElided);
+	}
+
+	const GLStateCounters& GLStateCache::getLastCounters()
+	{
+		return instance()->lastCounters;
+	}
+
+	void GLStateCache::drawImGui()
+	{
+		const GLStateCounters& counters = getLastCounters();
+
+		ImGui::Text("Programs: %u issued, %u elided", counters.programs.issued, counters.programs.elided);
+		ImGui::Text("Vertex arrays: %u issued, %u elided", counters.vertexArrays.issued, counters.vertexArrays.elided);
+		ImGui::Text("Framebuffers: %u issued, %u elided", counters.framebuffers.issued, counters.framebuffers.elided);
+		ImGui::Text("Textures: %u issued, %u elided", counters.textures.issued, counters.textures.elided);
+		ImGui::Text("Buffers: %u issued, %u elided", counters.buffers.issued, counters.buffers.elided);
+		ImGui::Text("Capabilities: %u issued, %u elided", counters.caps.issued, counters.caps.elided);
+		ImGui::Text("Uniforms: %u issued, %u elided", counters.uniforms.issued, counters.uniforms.elided);
+	}
+}
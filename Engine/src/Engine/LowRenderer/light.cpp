@@ -1,5 +1,9 @@
 ﻿#include "light.hpp"
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
 #include "imgui.h"
 
 #include "render_manager.hpp"
@@ -10,6 +14,7 @@
 #include "transform.hpp"
 #include "shadow_point.hpp"
 #include "shadow_map.hpp"
+#include "light_clusters.hpp"
 #include "utils.hpp"
 
 namespace LowRenderer
@@ -23,6 +28,11 @@ namespace LowRenderer
 		LowRenderer::RenderManager::linkComponent(this);
 	}
 
+	Light::~Light()
+	{
+
+	}
+
 	void Light::setAsDirectionnal()
 	{
 		isPoint = 0.f;
@@ -72,38 +82,65 @@ namespace LowRenderer
 		hasShadow = (float)(shadow != nullptr);
 		position = m_transform->position;
 
-		if (hasShadow == 0.f || isPoint != 0.f)
+		if (hasShadow == 0.f)
 			return;
 
-		Core::Maths::mat4 lightView = Core::Maths::lookAt(m_transform->position);
-		spaceMatrix = Core::Maths::orthographic(-90.f, 90.f, -90.f, 90.f, -90.f, 180.f) * lightView;
+		shadow->compute(this);
+
+		// The cascades share their light space, each of them only scales and moves it
+		if (ShadowMap* shadowMap = dynamic_cast<ShadowMap*>(shadow.get()))
+			spaceMatrix = shadowMap->getCascadeSpace();
 	}
 
-	void Light::sendToProgram(std::shared_ptr<Resources::ShaderProgram> program, int index) const
+	void Light::sendShadowToProgram(std::shared_ptr<Resources::ShaderProgram> program, int shadowIndex) const
 	{
-		// Send light parameters to the ShaderProgram packed into matrices
-		program->setUniform("lightAttribs1[" + std::to_string(index) + "][0]", &position, true);
-		program->setUniform("lightAttribs2[" + std::to_string(index) + "][0]", &attenuation, true);
+		if (shadow == nullptr)
+			return;
 
-		if (shadow != nullptr)
-		{
-			if (isPoint == 0.f)
-			{
-				program->setUniform("lightAttribs3[" + std::to_string(index) + "][0]", &spaceMatrix.e, true, 1, 1);
-				program->setSampler("shadowMaps[" + std::to_string(index) + "][0]", shadow->ID);
-			}
-			else
-			{
-				float farPlane = 25.f;
-				program->setUniform("farPlane", &farPlane, true);
-				program->setSampler("shadowCubeMaps[" + std::to_string(index) + "][0]", shadow->ID);
-			}
-		}
+		if (isPoint == 0.f)
+			program->setUniform(getElementID(UniformIDs::shadowSpaceMatrices, shadowIndex), spaceMatrix);
+
+		// The maps of all the lights are read from the shadow atlas
+		shadow->sendToLitProgram(program, shadowIndex);
 	}
 
-	void Light::addToLightBuffer(std::vector<LightData>& buffer)
+	void Light::addToLightBuffer(std::vector<ClusterLight>& buffer, int shadowIndex) const
 	{
-		buffer.push_back({position, isPoint, ambient, diffuse, specular, attenuation, cutoff, direction, outterCutoff, enable, hasShadow, spaceMatrix });
+		ClusterLight light;
+
+		light.position = position;
+		light.isPoint = isPoint;
+		light.diffuse = diffuse;
+		light.specular = specular;
+		light.attenuation = attenuation;
+		light.spotCutoff = std::cos(cutoff);
+		light.direction = direction;
+		light.spotOuterCutoff = std::cos(outterCutoff);
+		light.shadowIndex = (float)shadowIndex;
+		light.range = getRange();
+
+		buffer.push_back(light);
+	}
+
+	float Light::getRange() const
+	{
+		if (isPoint == 0.f)
+			return FLT_MAX;
+
+		// The light is divided by c + l * d + q * d^2, find the distance where it gets under the minimum intensity
+		float brightness = std::max({ diffuse.data.x, diffuse.data.y, diffuse.data.z, specular.data.x, specular.data.y, specular.data.z });
+		float maxAttenuation = brightness / minIntensity;
+
+		if (maxAttenuation <= attenuation.c)
+			return 0.f;
+
+		if (attenuation.q > 0.f)
+			return (-attenuation.l + std::sqrt(attenuation.l * attenuation.l + 4.f * attenuation.q * (maxAttenuation - attenuation.c))) / (2.f * attenuation.q);
+
+		if (attenuation.l > 0.f)
+			return (maxAttenuation - attenuation.c) / attenuation.l;
+
+		return FLT_MAX;
 	}
 
 	const Core::Maths::mat4& Light::getSpaceMatrix() const
@@ -134,6 +171,9 @@ namespace LowRenderer
 			ImGui::DragFloat("Cutoff: ", &cutoff);
 			ImGui::DragFloat("Outer cutoff: ", &outterCutoff);
 
+			if (ShadowMap* shadowMap = dynamic_cast<ShadowMap*>(shadow.get()))
+				shadowMap->drawImGui();
+
 			Component::drawImGui();
 
 			ImGui::TreePop();
@@ -153,7 +193,7 @@ namespace LowRenderer
 							   std::to_string(enable) + " " + std::to_string(shadow == nullptr);
 	}
 
-	void Light::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void Light::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		owner.addComponent<Light>();
 		auto light = owner.getComponent<Light>();
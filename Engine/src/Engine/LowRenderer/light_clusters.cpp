@@ -0,0 +1,278 @@
+#include "light_clusters.hpp"
+
+#include <xmmintrin.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "camera.hpp"
+#include "light.hpp"
+#include "shader.hpp"
+#include "gl_state_cache.hpp"
+
+namespace LowRenderer
+{
+	static_assert(sizeof(ClusterLight) == 96, "ClusterLight must match the std430 layout of the light buffer");
+
+	LightClusters::~LightClusters()
+	{
+		if (lightBuffer)
+		{
+			glDeleteBuffers(1, &lightBuffer);
+			glDeleteBuffers(1, &clusterBuffer);
+			glDeleteBuffers(1, &indexBuffer);
+		}
+	}
+
+	float LightClusters::getSliceDepth(int slice) const
+	{
+		return boundsNear * std::pow(boundsFar / boundsNear, (float)slice / (float)gridZ);
+	}
+
+	void LightClusters::computeBounds(const Camera& camera)
+	{
+		boundsFovY = camera.fovY;
+		boundsAspect = camera.aspect;
+		boundsNear = std::max(camera.near, 0.001f);
+		boundsFar = std::max(camera.far, boundsNear * 2.f);
+
+		clusterMins.resize(clusterCount);
+		clusterMaxs.resize(clusterCount);
+
+		float tanY = std::tan(camera.fovY * Core::Maths::DEG2RAD * 0.5f);
+		float tanX = tanY * camera.aspect;
+
+		for (int z = 0; z < gridZ; z++)
+		{
+			float sliceNear = getSliceDepth(z);
+			float sliceFar = getSliceDepth(z + 1);
+
+			for (int y = 0; y < gridY; y++)
+			{
+				float bottom = -1.f + 2.f * (float)y / (float)gridY;
+				float top = -1.f + 2.f * (float)(y + 1) / (float)gridY;
+
+				for (int x = 0; x < gridX; x++)
+				{
+					float left = -1.f + 2.f * (float)x / (float)gridX;
+					float right = -1.f + 2.f * (float)(x + 1) / (float)gridX;
+
+					// The sides of the tile are planes through the camera, the box holds its corners at both depths
+					int cluster = x + gridX * (y + gridY * z);
+
+					clusterMins[cluster] = Core::Maths::vec3(
+						std::min(left * sliceNear, left * sliceFar) * tanX,
+						std::min(bottom * sliceNear, bottom * sliceFar) * tanY,
+						-sliceFar);
+
+					clusterMaxs[cluster] = Core::Maths::vec3(
+						std::max(right * sliceNear, right * sliceFar) * tanX,
+						std::max(top * sliceNear, top * sliceFar) * tanY,
+						-sliceNear);
+				}
+			}
+		}
+	}
+
+	void LightClusters::begin(const Camera& camera, const Core::Maths::vec2& screenSize)
+	{
+		if (clusterMins.empty() || camera.fovY != boundsFovY || camera.aspect != boundsAspect || camera.near != boundsNear || camera.far != boundsFar)
+			computeBounds(camera);
+
+		view = camera.getViewMatrix();
+		tileScale = Core::Maths::vec2((float)gridX / std::max(screenSize.x, 1.f), (float)gridY / std::max(screenSize.y, 1.f));
+
+		lights.clear();
+		sphereX.clear();
+		sphereY.clear();
+		sphereZ.clear();
+		sphereRadius.clear();
+
+		ambient = Core::Maths::vec4();
+
+		clusterLightIndices.resize((size_t)clusterCount * maxLightsPerCluster);
+		clusterLightCounts.assign(clusterCount, 0u);
+		sliceDroppedCounts.assign(gridZ, 0u);
+	}
+
+	void LightClusters::addLight(const Light& light, int shadowIndex)
+	{
+		light.addToLightBuffer(lights, shadowIndex);
+
+		const ClusterLight& clusterLight = lights.back();
+
+		ambient.x += light.ambient.data.x;
+		ambient.y += light.ambient.data.y;
+		ambient.z += light.ambient.data.z;
+
+		// A directional light reaches every cluster
+		Core::Maths::vec4 center = view * Core::Maths::vec4(clusterLight.position, 1.f);
+		bool isPoint = clusterLight.isPoint != 0.f;
+
+		sphereX.push_back(isPoint ? center.x : 0.f);
+		sphereY.push_back(isPoint ? center.y : 0.f);
+		sphereZ.push_back(isPoint ? center.z : 0.f);
+		sphereRadius.push_back(isPoint ? clusterLight.range : FLT_MAX);
+	}
+
+	void LightClusters::assignSlices(int firstSlice, int endSlice)
+	{
+		// Spheres of the lights that reach a slice, padded to a multiple of four
+		std::vector<uint32_t> candidates;
+		std::vector<float> candidateX, candidateY, candidateZ, candidateRadius;
+
+		const __m128 zero = _mm_setzero_ps();
+
+		for (int slice = firstSlice; slice < endSlice; slice++)
+		{
+			float sliceNear = getSliceDepth(slice);
+			float sliceFar = getSliceDepth(slice + 1);
+
+			candidates.clear();
+
+			for (uint32_t light = 0u; light < (uint32_t)lights.size(); light++)
+			{
+				float depth = -sphereZ[light];
+
+				if (depth + sphereRadius[light] >= sliceNear && depth - sphereRadius[light] <= sliceFar)
+					candidates.push_back(light);
+			}
+
+			size_t paddedCount = (candidates.size() + 3u) & ~(size_t)3u;
+
+			candidateX.assign(paddedCount, 0.f);
+			candidateY.assign(paddedCount, 0.f);
+			candidateZ.assign(paddedCount, 0.f);
+			candidateRadius.assign(paddedCount, -1.f);
+
+			for (size_t i = 0; i < candidates.size(); i++)
+			{
+				candidateX[i] = sphereX[candidates[i]];
+				candidateY[i] = sphereY[candidates[i]];
+				candidateZ[i] = sphereZ[candidates[i]];
+				candidateRadius[i] = sphereRadius[candidates[i]];
+			}
+
+			uint32_t droppedCount = 0u;
+
+			for (int tile = 0; tile < gridX * gridY; tile++)
+			{
+				int cluster = tile + gridX * gridY * slice;
+
+				const __m128 minX = _mm_set1_ps(clusterMins[cluster].x);
+				const __m128 minY = _mm_set1_ps(clusterMins[cluster].y);
+				const __m128 minZ = _mm_set1_ps(clusterMins[cluster].z);
+				const __m128 maxX = _mm_set1_ps(clusterMaxs[cluster].x);
+				const __m128 maxY = _mm_set1_ps(clusterMaxs[cluster].y);
+				const __m128 maxZ = _mm_set1_ps(clusterMaxs[cluster].z);
+
+				uint32_t* indices = &clusterLightIndices[(size_t)cluster * maxLightsPerCluster];
+				uint32_t count = 0u;
+
+				// Test four spheres at a time against the box of the cluster
+				for (size_t i = 0; i < paddedCount; i += 4)
+				{
+					__m128 x = _mm_loadu_ps(&candidateX[i]);
+					__m128 y = _mm_loadu_ps(&candidateY[i]);
+					__m128 z = _mm_loadu_ps(&candidateZ[i]);
+					__m128 radius = _mm_loadu_ps(&candidateRadius[i]);
+
+					// Distance from the centers to the box, zero inside of it
+					__m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, x), _mm_sub_ps(x, maxX)), zero);
+					__m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, y), _mm_sub_ps(y, maxY)), zero);
+					__m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, z), _mm_sub_ps(z, maxZ)), zero);
+
+					__m128 squaredDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+					// The padding has a negative radius and never passes
+					__m128 isInside = _mm_and_ps(_mm_cmple_ps(squaredDistance, _mm_mul_ps(radius, radius)), _mm_cmpge_ps(radius, zero));
+
+					int mask = _mm_movemask_ps(isInside);
+
+					for (int lane = 0; mask != 0; lane++, mask >>= 1)
+					{
+						if ((mask & 1) == 0)
+							continue;
+
+						if (count < maxLightsPerCluster)
+							indices[count++] = candidates[i + lane];
+						else
+							droppedCount++;
+					}
+				}
+
+				clusterLightCounts[cluster] = count;
+			}
+
+			sliceDroppedCounts[slice] = droppedCount;
+		}
+	}
+
+	void LightClusters::upload()
+	{
+		clusterRanges.resize((size_t)clusterCount * 2u);
+		compactIndices.clear();
+
+		for (int cluster = 0; cluster < clusterCount; cluster++)
+		{
+			const uint32_t* indices = &clusterLightIndices[(size_t)cluster * maxLightsPerCluster];
+			uint32_t count = clusterLightCounts[cluster];
+
+			clusterRanges[cluster * 2] = (uint32_t)compactIndices.size();
+			clusterRanges[cluster * 2 + 1] = count;
+
+			compactIndices.insert(compactIndices.end(), indices, indices + count);
+		}
+
+		if (!lightBuffer)
+		{
+			glGenBuffers(1, &lightBuffer);
+			glGenBuffers(1, &clusterBuffer);
+			glGenBuffers(1, &indexBuffer);
+		}
+
+		// Orphan the previous buffers, an empty list keeps a single element to stay bindable
+		GLStateCache::bindBuffer(GL_SHADER_STORAGE_BUFFER, lightBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(lights.size(), 1u) * sizeof(ClusterLight), lights.empty() ? nullptr : lights.data(), GL_STREAM_DRAW);
+
+		GLStateCache::bindBuffer(GL_SHADER_STORAGE_BUFFER, clusterBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, clusterRanges.size() * sizeof(uint32_t), clusterRanges.data(), GL_STREAM_DRAW);
+
+		GLStateCache::bindBuffer(GL_SHADER_STORAGE_BUFFER, indexBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(compactIndices.size(), 1u) * sizeof(uint32_t), compactIndices.empty() ? nullptr : compactIndices.data(), GL_STREAM_DRAW);
+	}
+
+	void LightClusters::sendToProgram(const std::shared_ptr<Resources::ShaderProgram>& program) const
+	{
+		GLStateCache::bindBufferBase(GL_SHADER_STORAGE_BUFFER, lightBinding, lightBuffer);
+		GLStateCache::bindBufferBase(GL_SHADER_STORAGE_BUFFER, clusterBinding, clusterBuffer);
+		GLStateCache::bindBufferBase(GL_SHADER_STORAGE_BUFFER, indexBinding, indexBuffer);
+
+		// The tile of a fragment is its pixel times the tile scale, its slice is log(depth) * scale + bias
+		float logRatio = std::log(boundsFar / boundsNear);
+		float sliceScale = (float)gridZ / logRatio;
+		float sliceBias = -(float)gridZ * std::log(boundsNear) / logRatio;
+
+		program->setUniform(UniformIDs::clusterScale, Core::Maths::vec4(tileScale.x, tileScale.y, sliceScale, sliceBias));
+		program->setUniform(UniformIDs::ambientLight, ambient);
+	}
+
+	size_t LightClusters::getLightCount() const
+	{
+		return lights.size();
+	}
+
+	size_t LightClusters::getAssignedCount() const
+	{
+		return compactIndices.size();
+	}
+
+	size_t LightClusters::getDroppedCount() const
+	{
+		size_t droppedCount = 0u;
+		for (uint32_t count : sliceDroppedCounts)
+			droppedCount += count;
+
+		return droppedCount;
+	}
+}
@@ -28,6 +28,10 @@ namespace LowRenderer
 		// Load obj
 		Resources::ResourcesManager::loadObj(m_filePath);
 
+		// The model may be destroyed if the load has been cancelled
+		if (Resources::ResourcesManager::isLoadCancelled())
+			return;
+
 		setMeshes();
 	}
 
@@ -57,62 +61,45 @@ namespace LowRenderer
 		}
 	}
 
-	void Model::draw(std::shared_ptr<Resources::ShaderProgram> shaderProgram) const
+	size_t Model::selectLod(float screenSize) const
 	{
-		if (m_mesh)
-		{
-			RenderManager::GLSetCapState(GL_CULL_FACE, hasFaceCulling);
-
-			// Send model matrix to program
-			shaderProgram->setUniform("model", m_transform->getGlobalModel().e, false, 1, 1);
+		size_t lod = m_lod;
 
-			std::shared_ptr<Resources::Material> currentMat = m_material ? m_material : Resources::Material::defaultMaterial;
+		// Change the level only past the margin around a threshold, a mesh at the limit does not switch every frame
+		while (lod + 1 < Resources::Mesh::maxLodCount && screenSize < lodScreenSizes[lod] * (1.f - lodHysteresis))
+			lod++;
 
-			// Send and bind material to program
-			currentMat->sendToShader(shaderProgram);
+		while (lod > 0 && screenSize > lodScreenSizes[lod - 1] * (1.f + lodHysteresis))
+			lod--;
 
-			// Draw the mesh
-			m_mesh->draw();
-		}
-
-		// Draw children
-		for (const Model& child : m_children)
-			child.draw(shaderProgram);
+		return lod;
 	}
 
-	void Model::simpleDraw(std::shared_ptr<Resources::ShaderProgram> shaderProgram) const
+	void Model::addDraws(std::vector<ModelDraw>& draws, const Core::Maths::vec4& tilling, const LodView* lodView) const
 	{
-		if (m_mesh)
+		if (m_mesh && m_mesh->isUploaded())
 		{
-			// Send model matrix to program
-			shaderProgram->setUniform("model", m_transform->getGlobalModel().e, false, 1, 1);
+			const Resources::Material* currentMat = m_material ? m_material.get() : Resources::Material::defaultMaterial.get();
 
-			// Draw the mesh
-			m_mesh->draw();
-		}
+			Core::Maths::mat4 globalModel = m_transform->getGlobalModel();
+			Resources::Bounds worldBounds = m_mesh->getBounds().transform(globalModel);
 
-		// Draw children
-		for (const Model& child : m_children)
-			child.simpleDraw(shaderProgram);
-	}
+			if (lodView)
+			{
+				float distance = (worldBounds.center - lodView->position).magnitude();
+				float screenSize = distance > worldBounds.radius ? worldBounds.radius * lodView->projectionScale / distance : 1.f;
 
-	void Model::drawCollider(std::shared_ptr<Resources::ShaderProgram> shaderProgram, Core::Maths::mat4& modelCollider) const
-	{
-		if (m_mesh)
-		{
-			Core::Maths::vec3 color = Core::Maths::vec3(0.f, 1.f, 0.f);
+				m_lod = std::min(selectLod(screenSize), lodView->maxLod);
+			}
 
-			// Send model matrix to program
-			shaderProgram->setUniform("model", modelCollider.e, false, 1, 1);
-			shaderProgram->setUniform("color", color.e, true, 1, 1);
+			size_t lod = std::min(m_lod, m_mesh->getLodCount() - 1);
 
-			// Draw the mesh
-			m_mesh->draw();
+			draws.push_back({ m_mesh.get(), currentMat, hasFaceCulling, { globalModel, tilling }, worldBounds, false, (uint32_t)lod });
 		}
 
-		// Draw children
+		// Add children
 		for (const Model& child : m_children)
-			child.drawCollider(shaderProgram, modelCollider);
+			child.addDraws(draws, tilling, lodView);
 	}
 
 	const std::string& Model::getPath() const
@@ -34,14 +34,22 @@ namespace LowRenderer
 
 	void ModelRenderer::draw() const
 	{
-		m_shaderProgram->setUniform("tilling", Core::Maths::vec2(tillingMultiplier, tillingOffset).e, false);
+		// Draw the model alone, the render manager batches the models of a program instead
+		std::vector<ModelDraw> draws;
+		addDraws(draws);
 
-		model.draw(m_shaderProgram);
+		LowRenderer::RenderManager::drawModelDraws(m_shaderProgram, draws);
 	}
 
-	void ModelRenderer::simpleDraw(std::shared_ptr<Resources::ShaderProgram> program) const
+	void ModelRenderer::addDraws(std::vector<ModelDraw>& draws, const LodView* lodView) const
 	{
-		model.simpleDraw(program);
+		size_t firstDraw = draws.size();
+
+		model.addDraws(draws, Core::Maths::vec4(tillingMultiplier, tillingOffset, 0.f, 0.f), lodView);
+
+		bool isStatic = getHost().isStatic;
+		for (size_t i = firstDraw; i < draws.size(); i++)
+			draws[i].isStatic = isStatic;
 	}
 
 	void ModelRenderer::drawImGui()
@@ -65,7 +73,7 @@ namespace LowRenderer
 		return "COMP MODELRENDERER " + model.getPath() + " " + m_shaderProgram->getName() + " " + std::to_string(tillingMultiplier) + " " + std::to_string(tillingOffset);
 	}
 
-	void ModelRenderer::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void ModelRenderer::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		std::string modelPath, shaderProgramName;
 		Core::Maths::vec2 tilling;
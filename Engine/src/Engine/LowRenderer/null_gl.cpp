@@ -0,0 +1,570 @@
+#include "null_gl.hpp"
+
+#include <atomic>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cctype>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <glad/glad.h>
+
+#include "debug.hpp"
+
+namespace LowRenderer
+{
+	// Names given to the generated objects, never zero so they look valid to the engine
+	std::atomic<GLuint> nullObjectCount = 0u;
+
+	std::atomic<unsigned long long> nullErrorCount = 0ull;
+
+	// Uniform declared in the sources of a program, reported like a driver would
+	struct NullUniform
+	{
+		std::string name;
+		GLint location = 0;
+		GLint size = 1;
+		GLenum type = GL_FLOAT;
+	};
+
+	// Field of a struct or declaration of a uniform
+	struct NullDeclaration
+	{
+		std::string type;
+		std::string name;
+		std::vector<int> dimensions;
+	};
+
+	// Objects known by the null functions, only used by the context thread
+	struct NullState
+	{
+		std::unordered_map<GLuint, std::string> shaderSources;
+		std::unordered_map<GLuint, std::vector<GLuint>> programShaders;
+		std::unordered_map<GLuint, std::vector<NullUniform>> programUniforms;
+
+		GLuint program = 0u;
+		GLuint vertexArray = 0u;
+
+		std::unordered_set<std::string> reportedFunctions;
+	};
+
+	NullState nullState;
+
+	void reportNullError(const char* function, const std::string& message)
+	{
+		nullErrorCount++;
+
+		// Log the first error of each function only, the count keeps the others
+		if (nullState.reportedFunctions.insert(function).second)
+			Core::Debug::Log::error(std::string("Null GL: ") + function + " " + message);
+	}
+
+	void validateName(const char* function, GLuint name)
+	{
+		if (name > nullObjectCount)
+			reportNullError(function, "uses the name " + std::to_string(name) + " that has never been generated");
+	}
+
+	void validateDraw(const char* function)
+	{
+		if (!nullState.program)
+			reportNullError(function, "draws without any program");
+
+		if (!nullState.vertexArray)
+			reportNullError(function, "draws without any vertex array");
+	}
+
+	template <typename Ret, typename... Args>
+	Ret APIENTRY nullFunction(Args...)
+	{
+		return Ret();
+	}
+
+	template <typename Ret, typename... Args>
+	void setNull(Ret (APIENTRYP& function)(Args...))
+	{
+		function = &nullFunction<Ret, Args...>;
+	}
+
+	GLenum getUniformType(const std::string& type)
+	{
+		static const std::unordered_map<std::string, GLenum> types =
+		{
+			{ "float", GL_FLOAT }, { "vec2", GL_FLOAT_VEC2 }, { "vec3", GL_FLOAT_VEC3 }, { "vec4", GL_FLOAT_VEC4 },
+			{ "int", GL_INT }, { "ivec2", GL_INT_VEC2 }, { "ivec3", GL_INT_VEC3 }, { "ivec4", GL_INT_VEC4 },
+			{ "uint", GL_UNSIGNED_INT }, { "bool", GL_BOOL },
+			{ "mat2", GL_FLOAT_MAT2 }, { "mat3", GL_FLOAT_MAT3 }, { "mat4", GL_FLOAT_MAT4 },
+			{ "sampler2D", GL_SAMPLER_2D }, { "samplerCube", GL_SAMPLER_CUBE }, { "sampler2DArray", GL_SAMPLER_2D_ARRAY },
+			{ "sampler2DShadow", GL_SAMPLER_2D_SHADOW }, { "samplerCubeShadow", GL_SAMPLER_CUBE_SHADOW },
+		};
+
+		auto typeIt = types.find(type);
+		return typeIt != types.end() ? typeIt->second : GL_FLOAT;
+	}
+
+	// Split a source in identifiers, numbers and symbols, without the comments, and keep its defines
+	std::vector<std::string> tokenize(const std::string& source, std::unordered_map<std::string, std::string>& defines)
+	{
+		std::vector<std::string> tokens;
+
+		for (size_t i = 0; i < source.size();)
+		{
+			char c = source[i];
+
+			if (source.compare(i, 2, "//") == 0)
+				i = source.find('\n', i);
+			else if (source.compare(i, 2, "/*") == 0)
+			{
+				i = source.find("*/", i);
+				i = i == std::string::npos ? i : i + 2;
+			}
+			else if (c == '#')
+			{
+				// Only the defines of a name and a value are used, to read the sizes of the arrays
+				size_t lineEnd = source.find('\n', i);
+				std::string line = source.substr(i, lineEnd == std::string::npos ? std::string::npos : lineEnd - i);
+
+				std::vector<std::string> words;
+				for (size_t wordStart = line.find_first_not_of(" \t#"); wordStart != std::string::npos;)
+				{
+					size_t wordEnd = line.find_first_of(" \t\r", wordStart);
+					words.push_back(line.substr(wordStart, wordEnd == std::string::npos ? std::string::npos : wordEnd - wordStart));
+					wordStart = line.find_first_not_of(" \t\r", wordEnd == std::string::npos ? line.size() : wordEnd);
+				}
+
+				if (words.size() == 3 && words[0] == "define")
+					defines[words[1]] = words[2];
+
+				i = lineEnd;
+			}
+			else if (std::isalnum((unsigned char)c) || c == '_')
+			{
+				size_t end = i;
+				while (end < source.size() && (std::isalnum((unsigned char)source[end]) || source[end] == '_'))
+					end++;
+
+				tokens.push_back(source.substr(i, end - i));
+				i = end;
+			}
+			else
+			{
+				if (!std::isspace((unsigned char)c))
+					tokens.push_back(std::string(1, c));
+
+				i++;
+			}
+		}
+
+		return tokens;
+	}
+
+	// Read a name and its array dimensions, like shadowTiles[SHADOW_TILE_COUNT]
+	size_t parseDeclarator(const std::vector<std::string>& tokens, size_t i, NullDeclaration& declaration, const std::unordered_map<std::string, std::string>& defines)
+	{
+		if (i < tokens.size())
+			declaration.name = tokens[i++];
+
+		while (i + 2 < tokens.size() && tokens[i] == "[" && tokens[i + 2] == "]")
+		{
+			auto defineIt = defines.find(tokens[i + 1]);
+			const std::string& size = defineIt != defines.end() ? defineIt->second : tokens[i + 1];
+
+			declaration.dimensions.push_back(std::isdigit((unsigned char)size[0]) ? std::stoi(size) : 1);
+			i += 3;
+		}
+
+		return i;
+	}
+
+	// Read the fields of a struct, from its opening brace to its closing one
+	size_t parseFields(const std::vector<std::string>& tokens, size_t i, std::vector<NullDeclaration>& fields, const std::unordered_map<std::string, std::string>& defines)
+	{
+		for (i++; i < tokens.size() && tokens[i] != "}";)
+		{
+			NullDeclaration field;
+			field.type = tokens[i];
+
+			i = parseDeclarator(tokens, i + 1, field, defines);
+			fields.push_back(field);
+
+			// Skip the qualifiers and the initializers that are not read
+			while (i < tokens.size() && tokens[i] != ";" && tokens[i] != "}")
+				i++;
+
+			if (i < tokens.size() && tokens[i] == ";")
+				i++;
+		}
+
+		return i + 1;
+	}
+
+	// Add the entries of a declaration, an array of basic types is a single entry like with a driver
+	void addUniforms(std::vector<NullUniform>& uniforms, const std::string& name, const NullDeclaration& declaration, size_t dimension,
+		const std::unordered_map<std::string, std::vector<NullDeclaration>>& structs)
+	{
+		auto structIt = structs.find(declaration.type);
+
+		if (structIt == structs.end() && dimension + 1 == declaration.dimensions.size())
+		{
+			uniforms.push_back({ name + "[0]", 0, declaration.dimensions[dimension], getUniformType(declaration.type) });
+			return;
+		}
+
+		if (dimension < declaration.dimensions.size())
+		{
+			for (int i = 0; i < declaration.dimensions[dimension]; i++)
+				addUniforms(uniforms, name + "[" + std::to_string(i) + "]", declaration, dimension + 1, structs);
+
+			return;
+		}
+
+		if (structIt != structs.end())
+		{
+			for (const NullDeclaration& field : structIt->second)
+				addUniforms(uniforms, name + "." + field.name, field, 0u, structs);
+
+			return;
+		}
+
+		uniforms.push_back({ name, 0, 1, getUniformType(declaration.type) });
+	}
+
+	// Find the uniforms of the sources of a program, without any compiler
+	std::vector<NullUniform> reflectUniforms(const std::vector<GLuint>& shaders)
+	{
+		std::vector<NullUniform> uniforms;
+		std::unordered_set<std::string> uniformNames;
+
+		for (GLuint shader : shaders)
+		{
+			std::unordered_map<std::string, std::string> defines;
+			std::vector<std::string> tokens = tokenize(nullState.shaderSources[shader], defines);
+
+			std::unordered_map<std::string, std::vector<NullDeclaration>> structs;
+
+			for (size_t i = 0; i < tokens.size(); i++)
+			{
+				// Named structs can be the type of the next uniforms
+				if (tokens[i] == "struct" && i + 2 < tokens.size() && tokens[i + 2] == "{" && (i == 0 || tokens[i - 1] != "uniform"))
+				{
+					i = parseFields(tokens, i + 2, structs[tokens[i + 1]], defines) - 1;
+					continue;
+				}
+
+				if (tokens[i] != "uniform" || i + 2 >= tokens.size())
+					continue;
+
+				NullDeclaration declaration;
+				size_t next = i + 1;
+
+				if (tokens[next] == "struct")
+				{
+					// Struct declared with its uniform, like uniform struct Material { ... } material;
+					declaration.type = tokens[next + 1];
+					next = parseFields(tokens, next + 2, structs[declaration.type], defines);
+				}
+				else
+				{
+					declaration.type = tokens[next++];
+
+					// Skip the precision qualifiers
+					while (next + 1 < tokens.size() && (declaration.type == "highp" || declaration.type == "mediump" || declaration.type == "lowp"))
+						declaration.type = tokens[next++];
+
+					// The uniform blocks are not uniforms of the default block
+					if (next < tokens.size() && tokens[next] == "{")
+					{
+						int depth = 0;
+						do
+						{
+							depth += tokens[next] == "{" ? 1 : tokens[next] == "}" ? -1 : 0;
+							next++;
+						} while (next < tokens.size() && depth > 0);
+
+						i = next;
+						continue;
+					}
+				}
+
+				i = parseDeclarator(tokens, next, declaration, defines);
+
+				// The stages of a program share their uniforms
+				std::vector<NullUniform> declarationUniforms;
+				addUniforms(declarationUniforms, declaration.name, declaration, 0u, structs);
+
+				for (const NullUniform& uniform : declarationUniforms)
+				{
+					if (uniformNames.insert(uniform.name).second)
+						uniforms.push_back(uniform);
+				}
+			}
+		}
+
+		// Each element of an array has its own location
+		GLint location = 0;
+		for (NullUniform& uniform : uniforms)
+		{
+			uniform.location = location;
+			location += uniform.size;
+		}
+
+		return uniforms;
+	}
+
+	void APIENTRY nullGenerate(GLsizei count, GLuint* objects)
+	{
+		for (GLsizei i = 0; i < count; i++)
+			objects[i] = ++nullObjectCount;
+	}
+
+	GLuint APIENTRY nullCreateShader(GLenum type)
+	{
+		return ++nullObjectCount;
+	}
+
+	GLuint APIENTRY nullCreateProgram()
+	{
+		return ++nullObjectCount;
+	}
+
+	// Keep the sources to find the uniforms of the programs
+	void APIENTRY nullShaderSource(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths)
+	{
+		std::string& source = nullState.shaderSources[shader];
+		source.clear();
+
+		for (GLsizei i = 0; i < count; i++)
+		{
+			if (lengths && lengths[i] >= 0)
+				source.append(strings[i], lengths[i]);
+			else
+				source.append(strings[i]);
+		}
+	}
+
+	void APIENTRY nullAttachShader(GLuint program, GLuint shader)
+	{
+		validateName("glAttachShader", program);
+		validateName("glAttachShader", shader);
+
+		nullState.programShaders[program].push_back(shader);
+	}
+
+	void APIENTRY nullLinkProgram(GLuint program)
+	{
+		validateName("glLinkProgram", program);
+
+		nullState.programUniforms[program] = reflectUniforms(nullState.programShaders[program]);
+	}
+
+	void APIENTRY nullDeleteShader(GLuint shader)
+	{
+		nullState.shaderSources.erase(shader);
+	}
+
+	void APIENTRY nullDeleteProgram(GLuint program)
+	{
+		nullState.programShaders.erase(program);
+		nullState.programUniforms.erase(program);
+	}
+
+	// Compilations and links always succeed
+	void APIENTRY nullGetShaderiv(GLuint shader, GLenum parameterName, GLint* parameters)
+	{
+		*parameters = parameterName == GL_COMPILE_STATUS ? GL_TRUE : 0;
+	}
+
+	void APIENTRY nullGetProgramiv(GLuint program, GLenum parameterName, GLint* parameters)
+	{
+		if (parameterName == GL_ACTIVE_UNIFORMS)
+			*parameters = (GLint)nullState.programUniforms[program].size();
+		else
+			*parameters = parameterName == GL_LINK_STATUS ? GL_TRUE : 0;
+	}
+
+	void APIENTRY nullGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+	{
+		const std::vector<NullUniform>& uniforms = nullState.programUniforms[program];
+
+		if (index >= uniforms.size())
+		{
+			reportNullError("glGetActiveUniform", "reads the uniform " + std::to_string(index) + " of a program that has less uniforms");
+			return;
+		}
+
+		const NullUniform& uniform = uniforms[index];
+
+		GLsizei nameLength = std::min((GLsizei)uniform.name.size(), bufSize - 1);
+		uniform.name.copy(name, nameLength);
+		name[nameLength] = '\0';
+
+		if (length)
+			*length = nameLength;
+
+		*size = uniform.size;
+		*type = uniform.type;
+	}
+
+	GLint APIENTRY nullGetUniformLocation(GLuint program, const GLchar* name)
+	{
+		for (const NullUniform& uniform : nullState.programUniforms[program])
+		{
+			if (uniform.name == name)
+				return uniform.location;
+		}
+
+		return -1;
+	}
+
+	void APIENTRY nullUseProgram(GLuint program)
+	{
+		validateName("glUseProgram", program);
+		nullState.program = program;
+	}
+
+	void APIENTRY nullBindVertexArray(GLuint vertexArray)
+	{
+		validateName("glBindVertexArray", vertexArray);
+		nullState.vertexArray = vertexArray;
+	}
+
+	void APIENTRY nullBindBuffer(GLenum target, GLuint buffer)
+	{
+		validateName("glBindBuffer", buffer);
+	}
+
+	void APIENTRY nullBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+	{
+		validateName("glBindBufferBase", buffer);
+	}
+
+	void APIENTRY nullBindFramebuffer(GLenum target, GLuint framebuffer)
+	{
+		validateName("glBindFramebuffer", framebuffer);
+	}
+
+	void APIENTRY nullBindTexture(GLenum target, GLuint texture)
+	{
+		validateName("glBindTexture", texture);
+	}
+
+	void APIENTRY nullDrawArrays(GLenum mode, GLint first, GLsizei count)
+	{
+		validateDraw("glDrawArrays");
+	}
+
+	void APIENTRY nullDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+	{
+		validateDraw("glDrawElements");
+	}
+
+	void APIENTRY nullDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint baseVertex)
+	{
+		validateDraw("glDrawElementsBaseVertex");
+	}
+
+	void APIENTRY nullDrawElementsInstancedBaseVertexBaseInstance(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount, GLint baseVertex, GLuint baseInstance)
+	{
+		validateDraw("glDrawElementsInstancedBaseVertexBaseInstance");
+	}
+
+	void APIENTRY nullMultiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawCount, GLsizei stride)
+	{
+		validateDraw("glMultiDrawElementsIndirect");
+	}
+
+	unsigned long long getNullGLErrorCount()
+	{
+		return nullErrorCount;
+	}
+
+	void loadNullGL()
+	{
+		glGenBuffers = &nullGenerate;
+		glGenFramebuffers = &nullGenerate;
+		glGenTextures = &nullGenerate;
+		glGenVertexArrays = &nullGenerate;
+
+		glCreateShader = &nullCreateShader;
+		glCreateProgram = &nullCreateProgram;
+
+		glShaderSource = &nullShaderSource;
+		glAttachShader = &nullAttachShader;
+		glLinkProgram = &nullLinkProgram;
+		glDeleteShader = &nullDeleteShader;
+		glDeleteProgram = &nullDeleteProgram;
+
+		glGetShaderiv = &nullGetShaderiv;
+		glGetProgramiv = &nullGetProgramiv;
+		glGetActiveUniform = &nullGetActiveUniform;
+		glGetUniformLocation = &nullGetUniformLocation;
+
+		// The binds and the draws are validated
+		glUseProgram = &nullUseProgram;
+		glBindVertexArray = &nullBindVertexArray;
+		glBindBuffer = &nullBindBuffer;
+		glBindBufferBase = &nullBindBufferBase;
+		glBindFramebuffer = &nullBindFramebuffer;
+		glBindTexture = &nullBindTexture;
+
+		glDrawArrays = &nullDrawArrays;
+		glDrawElements = &nullDrawElements;
+		glDrawElementsBaseVertex = &nullDrawElementsBaseVertex;
+		glDrawElementsInstancedBaseVertexBaseInstance = &nullDrawElementsInstancedBaseVertexBaseInstance;
+		glMultiDrawElementsIndirect = &nullMultiDrawElementsIndirect;
+
+		setNull(glActiveTexture);
+		setNull(glBindBufferRange);
+		setNull(glBlendFunc);
+		setNull(glBufferData);
+		setNull(glBufferSubData);
+		setNull(glClear);
+		setNull(glClearColor);
+		setNull(glCompileShader);
+		setNull(glCopyBufferSubData);
+		setNull(glCopyImageSubData);
+		setNull(glCullFace);
+		setNull(glDeleteBuffers);
+		setNull(glDeleteFramebuffers);
+		setNull(glDeleteTextures);
+		setNull(glDeleteVertexArrays);
+		setNull(glDepthFunc);
+		setNull(glDisable);
+		setNull(glDrawBuffer);
+		setNull(glEnable);
+		setNull(glEnableVertexAttribArray);
+		setNull(glFramebufferTexture);
+		setNull(glFramebufferTexture2D);
+		setNull(glGenerateMipmap);
+		setNull(glGetProgramInfoLog);
+		setNull(glGetShaderInfoLog);
+		setNull(glGetUniformBlockIndex);
+		setNull(glPixelStorei);
+		setNull(glPolygonMode);
+		setNull(glReadBuffer);
+		setNull(glScissor);
+		setNull(glTexImage2D);
+		setNull(glTexParameterfv);
+		setNull(glTexParameteri);
+		setNull(glUniform1f);
+		setNull(glUniform1fv);
+		setNull(glUniform1i);
+		setNull(glUniform1iv);
+		setNull(glUniform2fv);
+		setNull(glUniform2iv);
+		setNull(glUniform3fv);
+		setNull(glUniform3iv);
+		setNull(glUniform4fv);
+		setNull(glUniform4iv);
+		setNull(glUniformBlockBinding);
+		setNull(glUniformMatrix2fv);
+		setNull(glUniformMatrix3fv);
+		setNull(glUniformMatrix4fv);
+		setNull(glVertexAttribDivisor);
+		setNull(glVertexAttribIPointer);
+		setNull(glVertexAttribPointer);
+		setNull(glViewport);
+		setNull(glViewportIndexedf);
+	}
+}
@@ -0,0 +1,325 @@
+#include "occlusion_buffer.hpp"
+
+#include <xmmintrin.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "mesh.hpp"
+
+namespace LowRenderer
+{
+	OcclusionBuffer::OcclusionBuffer()
+		: pixelDepths((size_t)width * height, 0.f), tileDepths((size_t)tileCountX * tileCountY + 4u, 0.f)
+	{
+
+	}
+
+	void OcclusionBuffer::begin(const Core::Maths::mat4& newViewProjection, float newNearDepth)
+	{
+		viewProjection = newViewProjection;
+		nearDepth = newNearDepth;
+
+		occluders.clear();
+		triangles.clear();
+	}
+
+	void OcclusionBuffer::addOccluder(const std::vector<Core::Maths::vec3>& positions, const std::vector<unsigned int>& indices, const Core::Maths::mat4& model)
+	{
+		occluders.push_back({ &positions, &indices, model, triangles.size() });
+		triangles.resize(triangles.size() + indices.size() / 3u);
+	}
+
+	void OcclusionBuffer::setupOccluders(size_t firstOccluder, size_t endOccluder)
+	{
+		// Position of each vertex in the pixels of the buffer, with its inverse view depth
+		std::vector<Core::Maths::vec3> screenPositions;
+
+		for (size_t occluderIndex = firstOccluder; occluderIndex < endOccluder; occluderIndex++)
+		{
+			const Occluder& occluder = occluders[occluderIndex];
+			const std::vector<Core::Maths::vec3>& positions = *occluder.positions;
+			const std::vector<unsigned int>& indices = *occluder.indices;
+
+			Core::Maths::mat4 modelViewProjection = viewProjection * occluder.model;
+			const float* e = modelViewProjection.e;
+
+			screenPositions.resize(positions.size());
+			for (size_t i = 0; i < positions.size(); i++)
+			{
+				const Core::Maths::vec3& position = positions[i];
+
+				float clipX = e[0] * position.x + e[1] * position.y + e[2] * position.z + e[3];
+				float clipY = e[4] * position.x + e[5] * position.y + e[6] * position.z + e[7];
+				float clipW = e[12] * position.x + e[13] * position.y + e[14] * position.z + e[15];
+
+				// The vertices behind the near plane have no depth, their triangles are dropped
+				if (clipW < nearDepth)
+				{
+					screenPositions[i] = Core::Maths::vec3(0.f, 0.f, -1.f);
+					continue;
+				}
+
+				float invDepth = 1.f / clipW;
+
+				screenPositions[i] = Core::Maths::vec3((clipX * invDepth * 0.5f + 0.5f) * width, (clipY * invDepth * 0.5f + 0.5f) * height, invDepth);
+			}
+
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				OccluderTriangle& triangle = triangles[occluder.firstTriangle + i / 3u];
+				triangle.minY = 0;
+				triangle.maxY = -1;
+
+				bool isClipped = false;
+				for (int corner = 0; corner < 3; corner++)
+				{
+					const Core::Maths::vec3& screenPosition = screenPositions[indices[i + corner]];
+
+					triangle.x[corner] = screenPosition.x;
+					triangle.y[corner] = screenPosition.y;
+					triangle.invDepth[corner] = screenPosition.z;
+
+					isClipped |= screenPosition.z < 0.f;
+				}
+
+				// Dropping a triangle only hides less, the buffer stays conservative without any clipping
+				if (isClipped)
+					continue;
+
+				float minX = std::min({ triangle.x[0], triangle.x[1], triangle.x[2] });
+				float maxX = std::max({ triangle.x[0], triangle.x[1], triangle.x[2] });
+
+				if (maxX < 0.f || minX > (float)width)
+					continue;
+
+				// Rows whose pixel centers are between the top and the bottom of the triangle
+				float minY = std::min({ triangle.y[0], triangle.y[1], triangle.y[2] });
+				float maxY = std::max({ triangle.y[0], triangle.y[1], triangle.y[2] });
+
+				triangle.minY = (int)std::ceil(std::max(minY, 0.f) - 0.5f);
+				triangle.maxY = (int)std::floor(std::min(maxY, (float)height) - 0.5f);
+			}
+		}
+	}
+
+	void OcclusionBuffer::rasterizeTriangle(const OccluderTriangle& triangle, int firstRow, int endRow)
+	{
+		int i1 = 1;
+		int i2 = 2;
+
+		float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) - (triangle.x[2] - triangle.x[0]) * (triangle.y[1] - triangle.y[0]);
+
+		// Both faces of an occluder hide what is behind it, the clockwise triangles are turned around
+		if (area < 0.f)
+		{
+			std::swap(i1, i2);
+			area = -area;
+		}
+
+		if (area < FLT_EPSILON)
+			return;
+
+		float xA = triangle.x[0], yA = triangle.y[0], zA = triangle.invDepth[0];
+		float xB = triangle.x[i1], yB = triangle.y[i1], zB = triangle.invDepth[i1];
+		float xC = triangle.x[i2], yC = triangle.y[i2], zC = triangle.invDepth[i2];
+
+		// Edge functions, positive inside, each one is the weight of the opposite vertex times the area
+		float a0 = yB - yC, b0 = xC - xB, c0 = xB * yC - xC * yB;
+		float a1 = yC - yA, b1 = xA - xC, c1 = xC * yA - xA * yC;
+		float a2 = yA - yB, b2 = xB - xA, c2 = xA * yB - xB * yA;
+
+		// The inverse depth is linear on the screen
+		float invArea = 1.f / area;
+		float zStepX = (a0 * zA + a1 * zB + a2 * zC) * invArea;
+		float zStepY = (b0 * zA + b1 * zB + b2 * zC) * invArea;
+		float zOffset = (c0 * zA + c1 * zB + c2 * zC) * invArea;
+
+		// The bounds are clamped before their conversion, the triangles close to the near plane go far out of the buffer
+		int minX = (int)std::ceil(std::max(std::min({ xA, xB, xC }), 0.f) - 0.5f);
+		int maxX = (int)std::floor(std::min(std::max({ xA, xB, xC }), (float)width) - 0.5f);
+
+		if (minX > maxX)
+			return;
+
+		// Blocks of four pixels, the width of the buffer is a multiple of four
+		int firstX = minX & ~3;
+
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 laneCenters = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+		const __m128 edgeStep0 = _mm_set1_ps(a0);
+		const __m128 edgeStep1 = _mm_set1_ps(a1);
+		const __m128 edgeStep2 = _mm_set1_ps(a2);
+		const __m128 depthStep = _mm_set1_ps(zStepX);
+
+		for (int y = firstRow; y < endRow; y++)
+		{
+			float pixelY = (float)y + 0.5f;
+
+			const __m128 edgeRow0 = _mm_set1_ps(b0 * pixelY + c0);
+			const __m128 edgeRow1 = _mm_set1_ps(b1 * pixelY + c1);
+			const __m128 edgeRow2 = _mm_set1_ps(b2 * pixelY + c2);
+			const __m128 depthRow = _mm_set1_ps(zStepY * pixelY + zOffset);
+
+			float* row = pixelDepths.data() + (size_t)y * width;
+
+			for (int x = firstX; x <= maxX; x += 4)
+			{
+				__m128 pixelX = _mm_add_ps(_mm_set1_ps((float)x), laneCenters);
+
+				__m128 edge0 = _mm_add_ps(_mm_mul_ps(edgeStep0, pixelX), edgeRow0);
+				__m128 edge1 = _mm_add_ps(_mm_mul_ps(edgeStep1, pixelX), edgeRow1);
+				__m128 edge2 = _mm_add_ps(_mm_mul_ps(edgeStep2, pixelX), edgeRow2);
+
+				__m128 isInside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)), _mm_cmpge_ps(edge2, zero));
+
+				if (!_mm_movemask_ps(isInside))
+					continue;
+
+				// Keep the closest occluder of the covered pixels
+				__m128 depth = _mm_add_ps(_mm_mul_ps(depthStep, pixelX), depthRow);
+				__m128 previousDepth = _mm_loadu_ps(row + x);
+				__m128 closestDepth = _mm_max_ps(previousDepth, depth);
+
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(isInside, closestDepth), _mm_andnot_ps(isInside, previousDepth)));
+			}
+		}
+	}
+
+	void OcclusionBuffer::rasterizeTileRows(int firstTileRow, int endTileRow)
+	{
+		int firstRow = firstTileRow * tileSize;
+		int endRow = endTileRow * tileSize;
+
+		std::fill(pixelDepths.begin() + (size_t)firstRow * width, pixelDepths.begin() + (size_t)endRow * width, 0.f);
+
+		for (const OccluderTriangle& triangle : triangles)
+		{
+			int triangleFirstRow = std::max(triangle.minY, firstRow);
+			int triangleEndRow = std::min(triangle.maxY + 1, endRow);
+
+			if (triangleFirstRow < triangleEndRow)
+				rasterizeTriangle(triangle, triangleFirstRow, triangleEndRow);
+		}
+
+		// Farthest depth of each tile, from two blocks of four pixels per row
+		for (int tileY = firstTileRow; tileY < endTileRow; tileY++)
+		{
+			for (int tileX = 0; tileX < tileCountX; tileX++)
+			{
+				__m128 farthestDepth = _mm_set1_ps(FLT_MAX);
+
+				for (int y = tileY * tileSize; y < (tileY + 1) * tileSize; y++)
+				{
+					const float* pixels = pixelDepths.data() + (size_t)y * width + tileX * tileSize;
+
+					farthestDepth = _mm_min_ps(farthestDepth, _mm_min_ps(_mm_loadu_ps(pixels), _mm_loadu_ps(pixels + 4)));
+				}
+
+				farthestDepth = _mm_min_ps(farthestDepth, _mm_shuffle_ps(farthestDepth, farthestDepth, _MM_SHUFFLE(1, 0, 3, 2)));
+				farthestDepth = _mm_min_ps(farthestDepth, _mm_shuffle_ps(farthestDepth, farthestDepth, _MM_SHUFFLE(2, 3, 0, 1)));
+
+				tileDepths[(size_t)tileY * tileCountX + tileX] = _mm_cvtss_f32(farthestDepth);
+			}
+		}
+	}
+
+	bool OcclusionBuffer::isOccluded(const Resources::Bounds& bounds) const
+	{
+		if (triangles.empty())
+			return false;
+
+		const float* e = viewProjection.e;
+
+		// Corners of the box, four at a time, the near ones then the far ones along z
+		const __m128 signX = _mm_setr_ps(-1.f, 1.f, -1.f, 1.f);
+		const __m128 signY = _mm_setr_ps(-1.f, -1.f, 1.f, 1.f);
+
+		__m128 cornerX = _mm_add_ps(_mm_set1_ps(bounds.center.x), _mm_mul_ps(signX, _mm_set1_ps(bounds.extents.x)));
+		__m128 cornerY = _mm_add_ps(_mm_set1_ps(bounds.center.y), _mm_mul_ps(signY, _mm_set1_ps(bounds.extents.y)));
+
+		__m128 minX = _mm_set1_ps(FLT_MAX);
+		__m128 minY = _mm_set1_ps(FLT_MAX);
+		__m128 maxX = _mm_set1_ps(-FLT_MAX);
+		__m128 maxY = _mm_set1_ps(-FLT_MAX);
+		__m128 closestDepth = _mm_setzero_ps();
+
+		for (float signZ : { -1.f, 1.f })
+		{
+			__m128 cornerZ = _mm_set1_ps(bounds.center.z + signZ * bounds.extents.z);
+
+			__m128 clipX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(e[0]), cornerX), _mm_mul_ps(_mm_set1_ps(e[1]), cornerY)), _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e[2]), cornerZ), _mm_set1_ps(e[3])));
+			__m128 clipY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(e[4]), cornerX), _mm_mul_ps(_mm_set1_ps(e[5]), cornerY)), _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e[6]), cornerZ), _mm_set1_ps(e[7])));
+			__m128 clipW = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(e[12]), cornerX), _mm_mul_ps(_mm_set1_ps(e[13]), cornerY)), _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e[14]), cornerZ), _mm_set1_ps(e[15])));
+
+			// A box that crosses the near plane covers the camera, it is kept
+			if (_mm_movemask_ps(_mm_cmplt_ps(clipW, _mm_set1_ps(nearDepth))))
+				return false;
+
+			__m128 invDepth = _mm_div_ps(_mm_set1_ps(1.f), clipW);
+
+			__m128 screenX = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(clipX, invDepth), _mm_set1_ps(0.5f)), _mm_set1_ps(0.5f)), _mm_set1_ps((float)width));
+			__m128 screenY = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(clipY, invDepth), _mm_set1_ps(0.5f)), _mm_set1_ps(0.5f)), _mm_set1_ps((float)height));
+
+			minX = _mm_min_ps(minX, screenX);
+			minY = _mm_min_ps(minY, screenY);
+			maxX = _mm_max_ps(maxX, screenX);
+			maxY = _mm_max_ps(maxY, screenY);
+			closestDepth = _mm_max_ps(closestDepth, invDepth);
+		}
+
+		alignas(16) float lanes[5][4];
+		_mm_store_ps(lanes[0], minX);
+		_mm_store_ps(lanes[1], minY);
+		_mm_store_ps(lanes[2], maxX);
+		_mm_store_ps(lanes[3], maxY);
+		_mm_store_ps(lanes[4], closestDepth);
+
+		float boxMinX = std::min({ lanes[0][0], lanes[0][1], lanes[0][2], lanes[0][3] });
+		float boxMinY = std::min({ lanes[1][0], lanes[1][1], lanes[1][2], lanes[1][3] });
+		float boxMaxX = std::max({ lanes[2][0], lanes[2][1], lanes[2][2], lanes[2][3] });
+		float boxMaxY = std::max({ lanes[3][0], lanes[3][1], lanes[3][2], lanes[3][3] });
+		float boxDepth = std::max({ lanes[4][0], lanes[4][1], lanes[4][2], lanes[4][3] });
+
+		// The boxes outside of the buffer are left to the frustum culling
+		if (boxMaxX < 0.f || boxMaxY < 0.f || boxMinX >= (float)width || boxMinY >= (float)height)
+			return false;
+
+		int firstTileX = (int)std::max(0.f, boxMinX) / tileSize;
+		int firstTileY = (int)std::max(0.f, boxMinY) / tileSize;
+		int lastTileX = (int)std::min((float)(width - 1), boxMaxX) / tileSize;
+		int lastTileY = (int)std::min((float)(height - 1), boxMaxY) / tileSize;
+
+		const __m128 boxDepths = _mm_set1_ps(boxDepth);
+		const __m128 lastTile = _mm_set1_ps((float)lastTileX);
+		const __m128 laneIndices = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+
+		// The box is visible in a tile where the farthest occluder is not in front of its closest corner
+		for (int tileY = firstTileY; tileY <= lastTileY; tileY++)
+		{
+			const float* row = tileDepths.data() + (size_t)tileY * tileCountX;
+
+			for (int tileX = firstTileX; tileX <= lastTileX; tileX += 4)
+			{
+				__m128 isInBox = _mm_cmple_ps(_mm_add_ps(_mm_set1_ps((float)tileX), laneIndices), lastTile);
+				__m128 isVisible = _mm_and_ps(isInBox, _mm_cmple_ps(_mm_loadu_ps(row + tileX), boxDepths));
+
+				if (_mm_movemask_ps(isVisible))
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	size_t OcclusionBuffer::getOccluderCount() const
+	{
+		return occluders.size();
+	}
+
+	size_t OcclusionBuffer::getTriangleCount() const
+	{
+		return triangles.size();
+	}
+}
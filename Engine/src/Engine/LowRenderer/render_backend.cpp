@@ -0,0 +1,308 @@
+#include "render_backend.hpp"
+
+#include <sstream>
+#include <filesystem>
+#include <type_traits>
+
+#include <glad/glad.h>
+#include <imgui.h>
+
+#include "null_gl.hpp"
+#include "debug.hpp"
+
+namespace LowRenderer
+{
+	template <typename T>
+	void writeArgument(std::ostringstream& stream, T argument)
+	{
+		// The pointers are written as addresses, the small integers as numbers
+		if constexpr (std::is_pointer_v<T>)
+			stream << ' ' << (const void*)argument;
+		else if constexpr (std::is_integral_v<T>)
+			stream << ' ' << +argument;
+		else
+			stream << ' ' << argument;
+	}
+
+	// Replacement of a GL function, that counts and records its calls before calling it
+	template <auto& function, typename Ret, typename... Args>
+	struct GLFunctionWrapper
+	{
+		static inline Ret (APIENTRYP next)(Args...) = nullptr;
+
+		static inline const char* name = nullptr;
+		static inline size_t index = 0u;
+
+		static Ret APIENTRY call(Args... args)
+		{
+			RenderBackend::countCall(index);
+
+			if (RenderBackend::isRecording())
+			{
+				std::ostringstream stream;
+				stream << name;
+				(writeArgument(stream, args), ...);
+
+				RenderBackend::recordCall(stream.str());
+			}
+
+			return next(args...);
+		}
+	};
+
+	template <auto& function, typename Ret, typename... Args>
+	void wrapFunction(Ret (APIENTRYP)(Args...), const char* name, std::vector<GLFunctionCalls>& calls)
+	{
+		using Wrapper = GLFunctionWrapper<function, Ret, Args...>;
+
+		Wrapper::next = function;
+		Wrapper::name = name;
+		Wrapper::index = calls.size();
+
+		calls.emplace_back(name);
+
+		function = &Wrapper::call;
+	}
+
+#define WRAP_GL_FUNCTION(function) wrapFunction<function>(function, #function, calls)
+
+	GLFunctionCalls::GLFunctionCalls(const char* name)
+		: name(name)
+	{
+
+	}
+
+	RenderBackend::~RenderBackend()
+	{
+		if (recordFile.is_open())
+			recordFile.close();
+	}
+
+	void RenderBackend::installWrappers()
+	{
+		if (areWrappersInstalled)
+			return;
+
+		areWrappersInstalled = true;
+
+		// Functions called by the engine, the ones of ImGui are left untouched
+		WRAP_GL_FUNCTION(glActiveTexture);
+		WRAP_GL_FUNCTION(glAttachShader);
+		WRAP_GL_FUNCTION(glBindBuffer);
+		WRAP_GL_FUNCTION(glBindBufferBase);
+		WRAP_GL_FUNCTION(glBindBufferRange);
+		WRAP_GL_FUNCTION(glBindFramebuffer);
+		WRAP_GL_FUNCTION(glBindTexture);
+		WRAP_GL_FUNCTION(glBindVertexArray);
+		WRAP_GL_FUNCTION(glBlendFunc);
+		WRAP_GL_FUNCTION(glBufferData);
+		WRAP_GL_FUNCTION(glBufferSubData);
+		WRAP_GL_FUNCTION(glClear);
+		WRAP_GL_FUNCTION(glClearColor);
+		WRAP_GL_FUNCTION(glCompileShader);
+		WRAP_GL_FUNCTION(glCopyBufferSubData);
+		WRAP_GL_FUNCTION(glCopyImageSubData);
+		WRAP_GL_FUNCTION(glCreateProgram);
+		WRAP_GL_FUNCTION(glCreateShader);
+		WRAP_GL_FUNCTION(glCullFace);
+		WRAP_GL_FUNCTION(glDeleteBuffers);
+		WRAP_GL_FUNCTION(glDeleteFramebuffers);
+		WRAP_GL_FUNCTION(glDeleteProgram);
+		WRAP_GL_FUNCTION(glDeleteShader);
+		WRAP_GL_FUNCTION(glDeleteTextures);
+		WRAP_GL_FUNCTION(glDeleteVertexArrays);
+		WRAP_GL_FUNCTION(glDepthFunc);
+		WRAP_GL_FUNCTION(glDisable);
+		WRAP_GL_FUNCTION(glDrawArrays);
+		WRAP_GL_FUNCTION(glDrawBuffer);
+		WRAP_GL_FUNCTION(glDrawElements);
+		WRAP_GL_FUNCTION(glDrawElementsBaseVertex);
+		WRAP_GL_FUNCTION(glDrawElementsInstancedBaseVertexBaseInstance);
+		WRAP_GL_FUNCTION(glEnable);
+		WRAP_GL_FUNCTION(glEnableVertexAttribArray);
+		WRAP_GL_FUNCTION(glFramebufferTexture);
+		WRAP_GL_FUNCTION(glFramebufferTexture2D);
+		WRAP_GL_FUNCTION(glGenBuffers);
+		WRAP_GL_FUNCTION(glGenFramebuffers);
+		WRAP_GL_FUNCTION(glGenTextures);
+		WRAP_GL_FUNCTION(glGenVertexArrays);
+		WRAP_GL_FUNCTION(glGenerateMipmap);
+		WRAP_GL_FUNCTION(glGetActiveUniform);
+		WRAP_GL_FUNCTION(glGetProgramInfoLog);
+		WRAP_GL_FUNCTION(glGetProgramiv);
+		WRAP_GL_FUNCTION(glGetShaderInfoLog);
+		WRAP_GL_FUNCTION(glGetShaderiv);
+		WRAP_GL_FUNCTION(glGetUniformBlockIndex);
+		WRAP_GL_FUNCTION(glGetUniformLocation);
+		WRAP_GL_FUNCTION(glLinkProgram);
+		WRAP_GL_FUNCTION(glMultiDrawElementsIndirect);
+		WRAP_GL_FUNCTION(glPixelStorei);
+		WRAP_GL_FUNCTION(glPolygonMode);
+		WRAP_GL_FUNCTION(glReadBuffer);
+		WRAP_GL_FUNCTION(glScissor);
+		WRAP_GL_FUNCTION(glShaderSource);
+		WRAP_GL_FUNCTION(glTexImage2D);
+		WRAP_GL_FUNCTION(glTexParameterfv);
+		WRAP_GL_FUNCTION(glTexParameteri);
+		WRAP_GL_FUNCTION(glUniform1f);
+		WRAP_GL_FUNCTION(glUniform1fv);
+		WRAP_GL_FUNCTION(glUniform1i);
+		WRAP_GL_FUNCTION(glUniform1iv);
+		WRAP_GL_FUNCTION(glUniform2fv);
+		WRAP_GL_FUNCTION(glUniform2iv);
+		WRAP_GL_FUNCTION(glUniform3fv);
+		WRAP_GL_FUNCTION(glUniform3iv);
+		WRAP_GL_FUNCTION(glUniform4fv);
+		WRAP_GL_FUNCTION(glUniform4iv);
+		WRAP_GL_FUNCTION(glUniformBlockBinding);
+		WRAP_GL_FUNCTION(glUniformMatrix2fv);
+		WRAP_GL_FUNCTION(glUniformMatrix3fv);
+		WRAP_GL_FUNCTION(glUniformMatrix4fv);
+		WRAP_GL_FUNCTION(glUseProgram);
+		WRAP_GL_FUNCTION(glVertexAttribDivisor);
+		WRAP_GL_FUNCTION(glVertexAttribIPointer);
+		WRAP_GL_FUNCTION(glVertexAttribPointer);
+		WRAP_GL_FUNCTION(glViewport);
+		WRAP_GL_FUNCTION(glViewportIndexedf);
+	}
+
+#undef WRAP_GL_FUNCTION
+
+	bool RenderBackend::load(RenderBackendType type, const std::string& recordPath)
+	{
+		RenderBackend* RB = instance();
+
+		if (RB->areWrappersInstalled)
+		{
+			Core::Debug::Log::error("The render backend can only be loaded once");
+			return false;
+		}
+
+		if (type == RenderBackendType::OPENGL)
+		{
+			RB->type = type;
+			return true;
+		}
+
+		// Without any context, the recording backend records the stubs
+		if (type == RenderBackendType::NULL_GL || !glDrawArrays)
+			loadNullGL();
+
+		if (type == RenderBackendType::RECORDING)
+		{
+			std::filesystem::path path(recordPath);
+
+			if (path.has_parent_path())
+				std::filesystem::create_directories(path.parent_path());
+
+			RB->recordFile.open(path);
+
+			if (!RB->recordFile)
+			{
+				Core::Debug::Log::error("Unable to record the GL calls at " + recordPath);
+				return false;
+			}
+		}
+
+		RB->installWrappers();
+		RB->type = type;
+
+		return true;
+	}
+
+	RenderBackendType RenderBackend::getType()
+	{
+		return instance()->type;
+	}
+
+	bool RenderBackend::parseArguments(int argc, char** argv, RenderBackendType& type, std::string& recordPath)
+	{
+		for (int i = 1; i + 1 < argc; i++)
+		{
+			std::string option = argv[i];
+			std::string value = argv[i + 1];
+
+			if (option == "--record")
+				recordPath = value;
+			else if (option != "--backend")
+				continue;
+			else if (value == "opengl")
+				type = RenderBackendType::OPENGL;
+			else if (value == "null")
+				type = RenderBackendType::NULL_GL;
+			else if (value == "recording")
+				type = RenderBackendType::RECORDING;
+			else
+				return false;
+		}
+
+		return true;
+	}
+
+	void RenderBackend::countCall(size_t functionIndex)
+	{
+		// The render workers only record commands, the GL calls are all replayed on the context thread
+		instance()->calls[functionIndex].count++;
+	}
+
+	bool RenderBackend::isRecording()
+	{
+		return instance()->type == RenderBackendType::RECORDING;
+	}
+
+	void RenderBackend::recordCall(const std::string& call)
+	{
+		RenderBackend* RB = instance();
+
+		while (RB->recordFlag.test_and_set());
+
+		RB->recordFile << call << '\n';
+
+		RB->recordFlag.clear();
+	}
+
+	const std::vector<GLFunctionCalls>& RenderBackend::getCalls()
+	{
+		return instance()->calls;
+	}
+
+	unsigned long long RenderBackend::getCallCount()
+	{
+		unsigned long long callCount = 0ull;
+
+		for (const GLFunctionCalls& functionCalls : instance()->calls)
+			callCount += functionCalls.count;
+
+		return callCount;
+	}
+
+	void RenderBackend::resetCalls()
+	{
+		for (GLFunctionCalls& functionCalls : instance()->calls)
+			functionCalls.count = 0ull;
+	}
+
+	void RenderBackend::drawImGui()
+	{
+		RenderBackend* RB = instance();
+
+		if (!RB->areWrappersInstalled)
+			return;
+
+		const char* typeNames[] = { "OpenGL", "Null", "Recording" };
+		ImGui::Text("Render backend: %s", typeNames[(int)RB->type]);
+		ImGui::Text("GL calls since reset: %llu", getCallCount());
+
+		if (RB->type != RenderBackendType::OPENGL)
+			ImGui::Text("Null GL errors: %llu", getNullGLErrorCount());
+
+		if (ImGui::Button("Reset GL calls"))
+			resetCalls();
+
+		for (const GLFunctionCalls& functionCalls : RB->calls)
+		{
+			if (functionCalls.count)
+				ImGui::Text("%s: %llu", functionCalls.name, functionCalls.count);
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#include "render_command.hpp"
+
+namespace LowRenderer
+{
+	void RenderCommandBuffer::push(RenderCommandType type, uint32_t arg0, uint32_t arg1, uint32_t arg2)
+	{
+		commands.push_back({ type, { arg0, arg1, arg2 } });
+	}
+
+	void RenderCommandBuffer::clear()
+	{
+		commands.clear();
+
+		programs.clear();
+		materials.clear();
+		lights.clear();
+	}
+
+	void RenderCommandBuffer::bindProgram(const std::shared_ptr<Resources::ShaderProgram>& program)
+	{
+		push(RenderCommandType::BIND_PROGRAM, (uint32_t)programs.size());
+		programs.push_back(program);
+	}
+
+	void RenderCommandBuffer::sendFrameUniforms()
+	{
+		push(RenderCommandType::SEND_FRAME_UNIFORMS);
+	}
+
+	void RenderCommandBuffer::bindShadowMap(Light* light, size_t pass, ShadowTarget target)
+	{
+		push(RenderCommandType::BIND_SHADOW_MAP, (uint32_t)lights.size(), (uint32_t)target, (uint32_t)pass);
+		lights.push_back(light);
+	}
+
+	void RenderCommandBuffer::setFaceCulling(bool hasFaceCulling)
+	{
+		push(RenderCommandType::SET_FACE_CULLING, hasFaceCulling ? 1u : 0u);
+	}
+
+	void RenderCommandBuffer::bindMaterial(const Resources::Material* material)
+	{
+		push(RenderCommandType::BIND_MATERIAL, (uint32_t)materials.size());
+		materials.push_back(material);
+	}
+
+	void RenderCommandBuffer::drawIndirect(uint32_t firstCommand, uint32_t commandCount, uint32_t meshCount)
+	{
+		push(RenderCommandType::DRAW_INDIRECT, firstCommand, commandCount, meshCount);
+	}
+
+	const std::vector<RenderCommand>& RenderCommandBuffer::getCommands() const
+	{
+		return commands;
+	}
+
+	const std::shared_ptr<Resources::ShaderProgram>& RenderCommandBuffer::getProgram(uint32_t index) const
+	{
+		return programs[index];
+	}
+
+	const Resources::Material* RenderCommandBuffer::getMaterial(uint32_t index) const
+	{
+		return materials[index];
+	}
+
+	Light* RenderCommandBuffer::getLight(uint32_t index) const
+	{
+		return lights[index];
+	}
+}
@@ -1,6 +1,9 @@
 #include "render_manager.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <thread>
 
 #include <imgui.h>
 
@@ -9,16 +12,23 @@
 
 #include "shader.hpp"
 #include "shadow.hpp"
+#include "shadow_point.hpp"
+#include "shadow_atlas.hpp"
 
 #include "uniform.hpp"
 
 #include "application.hpp"
+#include "thread_manager.hpp"
+#include "render_backend.hpp"
 
 namespace LowRenderer
 {
 	RenderManager::RenderManager()
 	{
 		Core::Debug::Log::info("Creating the Render Manager");
+
+		// The context thread records its part of the passes with the workers
+		Multithread::ThreadManager::init(renderPool, std::max(std::thread::hardware_concurrency(), 2u) - 1u);
 	}
 
 	RenderManager::~RenderManager()
@@ -26,19 +36,26 @@ namespace LowRenderer
 		models.clear();
 		lights.clear();
 		sprites.clear();
+		texts.clear();
+
+		if (textVBO)
+			glDeleteBuffers(1, &textVBO);
+
+		if (textVAO)
+			glDeleteVertexArrays(1, &textVAO);
+
+		if (drawBuffer)
+			glDeleteBuffers(1, &drawBuffer);
+
+		if (indirectBuffer)
+			glDeleteBuffers(1, &indirectBuffer);
 
 		Core::Debug::Log::info("Destroying the Render Manager");
 	}
 
 	void RenderManager::GLSetCapState(const GLenum cap, bool state)
 	{
-		RenderManager* renderManager = instance();
-
-		if (renderManager->enabledCaps[cap] == state)
-			return;
-
-		renderManager->enabledCaps[cap] = state;
-		state ? glEnable(cap) : glDisable(cap);
+		GLStateCache::setCapState(cap, state);
 	}
 
 
@@ -52,46 +69,511 @@ namespace LowRenderer
 		GLSetCapState(cap, false);
 	}
 
-	void RenderManager::drawShadows()
+	void RenderManager::uploadDraws(const RenderQueue& queue)
 	{
-		std::shared_ptr<Resources::ShaderProgram> program;
+		const std::vector<ModelDraw>& draws = queue.getDraws();
+
+		drawDatas.clear();
+		drawCommands.clear();
+		drawCommandIndices.clear();
 
-		glCullFace(GL_FRONT);
+		// The base instance of each command is the index of its data
+		for (size_t i = 0; i < draws.size(); i++)
+		{
+			drawDatas.push_back(draws[i].data);
 
-		// Number of lights to render (8 max)
-		int lightCount = std::min((int)lights.size(), 8);
+			const ModelDraw& draw = draws[i];
+			const ModelDraw* previousDraw = i > 0 ? &draws[i - 1] : nullptr;
 
-		int i = 0;
-		for (auto& light : lights)
+			counters.drawnTriangles += draw.mesh->getTriangleCount(draw.lod);
+			counters.fullDetailTriangles += draw.mesh->getTriangleCount(0u);
+
+			// Draw the repeated meshes as more instances of the previous command, their data follow each other
+			if (useInstancing && previousDraw && queue.isSameRun(i - 1, i) && draw.mesh == previousDraw->mesh && draw.lod == previousDraw->lod
+				&& draw.material == previousDraw->material && draw.hasFaceCulling == previousDraw->hasFaceCulling)
+			{
+				drawCommands.back().instanceCount++;
+				counters.instancedDraws++;
+			}
+			else
+			{
+				drawCommands.push_back(draw.mesh->getDrawCommand((GLuint)i, draw.lod));
+			}
+
+			drawCommandIndices.push_back(drawCommands.size() - 1);
+		}
+
+		GeometryArena::reserveDraws((GLuint)draws.size());
+
+		if (!drawBuffer)
+		{
+			glGenBuffers(1, &drawBuffer);
+			glGenBuffers(1, &indirectBuffer);
+		}
+
+		// Orphan the previous buffers and fill them with the new draws
+		GLStateCache::bindBuffer(GL_SHADER_STORAGE_BUFFER, drawBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, drawDatas.size() * sizeof(DrawData), drawDatas.data(), GL_STREAM_DRAW);
+
+		GLStateCache::bindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, drawCommands.size() * sizeof(DrawElementsIndirectCommand), drawCommands.data(), GL_STREAM_DRAW);
+	}
+
+	void RenderManager::recordDraws(RenderCommandBuffer& commands, const RenderQueue& queue, size_t firstDraw, size_t endDraw, bool useMaterials) const
+	{
+		const std::vector<ModelDraw>& draws = queue.getDraws();
+
+		const Resources::Material* boundMaterial = nullptr;
+		bool isCullingRecorded = false;
+		bool hasFaceCulling = false;
+
+		for (size_t first = firstDraw; first < endDraw;)
+		{
+			// Find the run of draws that share the same states
+			size_t last = first + 1;
+			while (last < endDraw && (!useMaterials || (draws[last].material == draws[first].material && draws[last].hasFaceCulling == draws[first].hasFaceCulling)))
+				last++;
+
+			if (useMaterials)
+			{
+				if (!isCullingRecorded || draws[first].hasFaceCulling != hasFaceCulling)
+				{
+					isCullingRecorded = true;
+					hasFaceCulling = draws[first].hasFaceCulling;
+					commands.setFaceCulling(hasFaceCulling);
+				}
+
+				// Send and bind material to program, unless only the face culling has changed
+				if (draws[first].material != boundMaterial)
+				{
+					boundMaterial = draws[first].material;
+					commands.bindMaterial(boundMaterial);
+				}
+			}
+
+			// Commands of the run, the instanced draws share the command of their first instance
+			size_t firstCommand = drawCommandIndices[first];
+			size_t commandCount = drawCommandIndices[last - 1] + 1 - firstCommand;
+
+			commands.drawIndirect((uint32_t)firstCommand, (uint32_t)commandCount, (uint32_t)(last - first));
+
+			first = last;
+		}
+	}
+
+	void RenderManager::executeCommands(const RenderCommandBuffer& commands)
+	{
+		if (commands.getCommands().empty())
+			return;
+
+		// The buffers and the VAO stay bound, the next buffers skip their binds
+		GLStateCache::bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, drawBuffer);
+		GLStateCache::bindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+
+		GeometryArena::bind();
+		counters.vaoBinds++;
+
+		const std::shared_ptr<Resources::ShaderProgram>* program = nullptr;
+
+		// The draws of a program that can not be bound or of a missing shadow map are skipped
+		bool isProgramBound = false;
+		bool isTargetBound = true;
+
+		for (const RenderCommand& command : commands.getCommands())
 		{
-			if (i >= lightCount)
+			switch (command.type)
+			{
+			case RenderCommandType::BIND_PROGRAM:
+				program = &commands.getProgram(command.args[0]);
+
+				isProgramBound = (*program)->bind();
+				if (isProgramBound)
+					counters.programBinds++;
 				break;
 
-			light->compute();
-			i++;
+			case RenderCommandType::SEND_FRAME_UNIFORMS:
+				if (isProgramBound)
+					sendFrameUniforms(*program);
+				break;
+
+			case RenderCommandType::BIND_SHADOW_MAP:
+			{
+				Light* light = commands.getLight(command.args[0]);
+
+				if (isProgramBound)
+					light->shadow->sendToShader(light, command.args[2]);
+
+				isTargetBound = light->shadow->bindTarget(command.args[2], (ShadowTarget)command.args[1]);
+				break;
+			}
+
+			case RenderCommandType::SET_FACE_CULLING:
+				GLSetCapState(GL_CULL_FACE, command.args[0] != 0u);
+				break;
+
+			case RenderCommandType::BIND_MATERIAL:
+				if (isProgramBound)
+				{
+					commands.getMaterial(command.args[0])->sendToShader(*program);
+					counters.materialBinds++;
+				}
+				break;
+
+			case RenderCommandType::DRAW_INDIRECT:
+			{
+				if (!isProgramBound || !isTargetBound)
+					break;
+
+				size_t firstCommand = command.args[0];
+				GLsizei commandCount = (GLsizei)command.args[1];
+
+				if (useMultiDrawIndirect)
+				{
+					glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (GLvoid*)(firstCommand * sizeof(DrawElementsIndirectCommand)), commandCount, 0);
+					counters.drawCalls++;
+				}
+				else
+				{
+					for (size_t i = firstCommand; i < firstCommand + commandCount; i++)
+					{
+						const DrawElementsIndirectCommand& drawCommand = drawCommands[i];
+						glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, drawCommand.count, GL_UNSIGNED_INT, (GLvoid*)(drawCommand.firstIndex * sizeof(unsigned int)), drawCommand.instanceCount, drawCommand.baseVertex, drawCommand.baseInstance);
+					}
+
+					counters.drawCalls += commandCount;
+				}
+
+				counters.drawnMeshes += command.args[2];
+				break;
+			}
+			}
+		}
+
+		counters.recordedCommands += (unsigned int)commands.getCommands().size();
+	}
+
+	void RenderManager::sendFrameUniforms(const std::shared_ptr<Resources::ShaderProgram>& program)
+	{
+		program->setUniform(UniformIDs::minBias, minBias);
+		program->setUniform(UniformIDs::maxBias, maxBias);
+		program->setSampler(UniformIDs::shadowAtlas, ShadowAtlas::getID());
+
+		getCurrentCamera()->sendViewProjToProgram(program);
+
+		// The lights are read from the clusters, only the shadows have uniforms
+		lightClusters.sendToProgram(program);
+
+		for (size_t shadowIndex = 0; shadowIndex < shadowLights.size(); shadowIndex++)
+			shadowLights[shadowIndex]->sendShadowToProgram(program, (int)shadowIndex);
+
+		for (auto& skyBox : skyBoxes)
+			skyBox->sendToProgram(program);
+	}
+
+	size_t RenderManager::getTaskCount(size_t itemCount) const
+	{
+		if (!parallelRecording)
+			return 1u;
+
+		// The calling thread takes a part of the work with the workers
+		size_t threadCount = Multithread::ThreadManager::getWorkerCount(renderPool) + 1u;
+
+		return std::clamp<size_t>(itemCount / minItemsPerTask, 1u, threadCount);
+	}
+
+	void RenderManager::runTasks(size_t taskCount, const std::function<void(size_t)>& task)
+	{
+		if (taskCount == 0u)
+			return;
+
+		std::atomic<size_t> remainingTasks = taskCount - 1;
+
+		for (size_t i = 1; i < taskCount; i++)
+		{
+			Multithread::ThreadManager::manageTask(renderPool, [&task, &remainingTasks, i]()
+			{
+				// Count the task as done even if it throws, the pool keeps its exception
+				struct TaskEnd
+				{
+					std::atomic<size_t>& remainingTasks;
+					~TaskEnd() { remainingTasks--; }
+				} taskEnd{ remainingTasks };
+
+				task(i);
+			});
 		}
+
+		task(0);
+
+		while (remainingTasks > 0)
+			std::this_thread::yield();
+	}
+
+	void RenderManager::cullDraws(std::vector<ModelDraw>& draws, size_t firstDraw, const Frustum& frustum, PassCounters& passCounters) const
+	{
+		size_t drawCount = draws.size();
+
+		if (frustumCulling)
+		{
+			auto culledBegin = std::remove_if(draws.begin() + firstDraw, draws.end(), [&frustum](const ModelDraw& draw)
+			{
+				return !frustum.intersects(draw.bounds.center, draw.bounds.extents);
+			});
+
+			draws.erase(culledBegin, draws.end());
+		}
+
+		passCounters.drawn += (unsigned int)(draws.size() - firstDraw);
+		passCounters.culled += (unsigned int)(drawCount - draws.size());
+	}
+
+	void RenderManager::drawModelDraws(const std::shared_ptr<Resources::ShaderProgram>& program, const std::vector<ModelDraw>& draws, bool useMaterials)
+	{
+		RenderManager* RM = instance();
+
+		// Sort the draws by material and mesh, to batch them like the draws of the passes
+		RM->immediateQueue.clear(1.f);
+
+		for (const ModelDraw& draw : draws)
+			RM->immediateQueue.push(0u, program, draw, 0.f);
+
+		RM->immediateQueue.sort();
+
+		RM->uploadDraws(RM->immediateQueue);
+
+		RM->immediateCommands.clear();
+		RM->immediateCommands.bindProgram(program);
+		RM->recordDraws(RM->immediateCommands, RM->immediateQueue, 0, RM->immediateQueue.size(), useMaterials);
+
+		RM->executeCommands(RM->immediateCommands);
+	}
+
+	float RenderManager::getShadowImportance(const Light* light) const
+	{
+		Camera* camera = getCurrentCamera();
+
+		// A directional light shadows everything that the camera sees
+		if (light->isPoint == 0.f || !camera)
+			return 1.f;
+
+		// The shadows of a light outside of the view can not be seen
+		Core::Maths::vec3 range = Core::Maths::vec3(ShadowPoint::farPlane, ShadowPoint::farPlane, ShadowPoint::farPlane);
+		if (frustumCulling && !Frustum(camera->getViewProjection()).intersects(light->position, range))
+			return 0.f;
+
+		// Part of the height of the screen covered by the range of the light
+		float distance = (light->position - camera->getPosition()).magnitude();
+		float viewHeight = distance * std::tan(camera->fovY * Core::Maths::DEG2RAD * 0.5f);
+
+		return viewHeight > ShadowPoint::farPlane ? ShadowPoint::farPlane / viewHeight : 1.f;
+	}
+
+	void RenderManager::drawShadows()
+	{
+		GLStateCache::cullFace(GL_FRONT);
+
+		for (auto& light : lights)
+			light->compute();
+
+		// The draws are shared by all the shadow maps
+		shadowDraws.clear();
+
+		for (auto& model : models)
+			model->addDraws(shadowDraws);
+
+		shadowLights.clear();
 		for (const auto& light : lights)
 		{
-			if (!light->isActive() || light->shadow == nullptr)
-				continue;
+			if (shadowLights.size() < maxShadowLights && light->isActive() && light->shadow != nullptr)
+				shadowLights.push_back(light);
+		}
+
+		// Give a tile of the atlas to each view, the lights that cover more of the screen get bigger tiles
+		ShadowAtlas::begin();
+
+		for (Light* light : shadowLights)
+			ShadowAtlas::request(light->shadow.get(), getShadowImportance(light));
+
+		ShadowAtlas::pack();
+
+		// Each pass of a shadow culls its own casters, the cascades of a directional light are separate passes
+		struct ShadowPass
+		{
+			Light* light;
+			size_t pass;
+		};
+
+		std::vector<ShadowPass> shadowPasses;
+		for (Light* light : shadowLights)
+		{
+			for (size_t pass = 0; pass < light->shadow->getPassCount(); pass++)
+				shadowPasses.push_back({ light, pass });
+		}
+
+		// Gather the draws inside the volume of each pass on the render pool, a task per pass
+		if (visibleDraws.size() < shadowPasses.size())
+			visibleDraws.resize(shadowPasses.size());
+
+		auto gatherPassDraws = [this, &shadowPasses](size_t passIndex)
+		{
+			const ShadowPass& shadowPass = shadowPasses[passIndex];
+			VisibleDraws& visible = visibleDraws[passIndex];
+
+			visible.draws.clear();
+			visible.depths.clear();
+
+			for (const ModelDraw& draw : shadowDraws)
+			{
+				float depth = 0.f;
+				bool isCaster = shadowPass.light->shadow->isCaster(shadowPass.pass, draw, depth);
+
+				if (!frustumCulling || isCaster)
+				{
+					visible.draws.push_back(draw);
+					visible.depths.push_back(depth);
+				}
+			}
+
+			// The hashes of the casters tell if the cached map is still valid
+			visible.staticCasterCount = 0u;
+			visible.staticCastersHash = Shadow::emptyCastersHash;
+			visible.dynamicCastersHash = Shadow::emptyCastersHash;
+
+			for (const ModelDraw& draw : visible.draws)
+			{
+				uint64_t& castersHash = draw.isStatic ? visible.staticCastersHash : visible.dynamicCastersHash;
+				castersHash = Shadow::hashCaster(castersHash, draw.mesh, draw.lod, draw.data.model);
+
+				visible.staticCasterCount += draw.isStatic ? 1u : 0u;
+			}
+		};
 
-			program = light->shadow->program;
+		if (parallelRecording && !shadowPasses.empty() && shadowDraws.size() >= minItemsPerTask)
+			runTasks(shadowPasses.size(), gatherPassDraws);
+		else
+		{
+			for (size_t passIndex = 0; passIndex < shadowPasses.size(); passIndex++)
+				gatherPassDraws(passIndex);
+		}
 
-			program->bind();
+		// Queue the casters of the maps that have changed, each shadow pass has a queue pass for its static casters and one for its dynamic casters
+		std::vector<ShadowUpdate> shadowUpdates;
+		shadowQueue.clear(ShadowPoint::farPlane);
 
-			light->shadow->sendToShader(light);
+		for (uint32_t passIndex = 0u; passIndex < shadowPasses.size(); passIndex++)
+		{
+			const ShadowPass& shadowPass = shadowPasses[passIndex];
+			const Light* light = shadowPass.light;
+			const VisibleDraws& visible = visibleDraws[passIndex];
 
-			if (!light->shadow->bindAndSetViewport())
+			unsigned int drawn = (unsigned int)visible.draws.size();
+			unsigned int culled = (unsigned int)(shadowDraws.size() - visible.draws.size());
+
+			PassCounters& passCounters = light->isPoint != 0.f ? counters.pointPass : counters.directionalPass;
+			passCounters.drawn += drawn;
+			passCounters.culled += culled;
+
+			if (light->isPoint == 0.f && shadowPass.pass < (size_t)ShadowMap::maxCascadeCount)
+			{
+				counters.cascadePasses[shadowPass.pass].drawn += drawn;
+				counters.cascadePasses[shadowPass.pass].culled += culled;
+			}
+
+			if (!cacheShadows)
+				light->shadow->invalidateCache();
+
+			ShadowUpdate update = light->shadow->getUpdate(shadowPass.pass, visible.staticCastersHash, visible.staticCasterCount,
+				visible.dynamicCastersHash, visible.draws.size() - visible.staticCasterCount);
+
+			shadowUpdates.push_back(update);
+
+			if (update == ShadowUpdate::NONE)
+			{
+				counters.cachedShadowMaps++;
 				continue;
+			}
+
+			counters.drawnShadowMaps++;
+
+			for (size_t drawIndex = 0; drawIndex < visible.draws.size(); drawIndex++)
+			{
+				const ModelDraw& draw = visible.draws[drawIndex];
+
+				// The baked static casters are not drawn again
+				if (update == ShadowUpdate::DYNAMIC_CASTERS && draw.isStatic)
+					continue;
+
+				uint32_t pass = passIndex * 2u + (update != ShadowUpdate::ALL_CASTERS && !draw.isStatic ? 1u : 0u);
+				shadowQueue.push(pass, light->shadow->program, draw, visible.depths[drawIndex]);
+			}
+		}
+
+		shadowQueue.sort();
+		uploadDraws(shadowQueue);
+
+		// Find the draws of each queue pass, then record the shadow passes on the render pool
+		std::vector<size_t> passEnds;
+
+		size_t endDraw = 0u;
+		for (uint32_t pass = 0u; pass < shadowPasses.size() * 2u; pass++)
+		{
+			while (endDraw < shadowQueue.size() && shadowQueue.getPass(endDraw) == pass)
+				endDraw++;
 
-			glClear(GL_DEPTH_BUFFER_BIT);
+			passEnds.push_back(endDraw);
+		}
+
+		if (commandBuffers.size() < shadowPasses.size())
+			commandBuffers.resize(shadowPasses.size());
+
+		auto recordShadowPass = [this, &shadowPasses, &shadowUpdates, &passEnds](size_t passIndex)
+		{
+			Light* light = shadowPasses[passIndex].light;
+			size_t shadowPass = shadowPasses[passIndex].pass;
+			ShadowUpdate update = shadowUpdates[passIndex];
+
+			RenderCommandBuffer& commands = commandBuffers[passIndex];
+			commands.clear();
+
+			if (update == ShadowUpdate::NONE)
+				return;
+
+			size_t staticPass = passIndex * 2u;
+			size_t staticPassStart = staticPass > 0 ? passEnds[staticPass - 1] : 0u;
+
+			commands.bindProgram(light->shadow->program);
+
+			if (update == ShadowUpdate::ALL_CASTERS)
+			{
+				commands.bindShadowMap(light, shadowPass, ShadowTarget::MAP);
+				recordDraws(commands, shadowQueue, staticPassStart, passEnds[staticPass], false);
+				return;
+			}
+
+			if (update == ShadowUpdate::STATIC_THEN_DYNAMIC_CASTERS)
+			{
+				commands.bindShadowMap(light, shadowPass, ShadowTarget::STATIC_MAP);
+				recordDraws(commands, shadowQueue, staticPassStart, passEnds[staticPass], false);
+			}
 
-			for (auto& model : models)
-				model->simpleDraw(program);
+			// Composite the dynamic casters over a copy of the static map
+			commands.bindShadowMap(light, shadowPass, ShadowTarget::MAP_FROM_STATIC);
+			recordDraws(commands, shadowQueue, passEnds[staticPass], passEnds[staticPass + 1], false);
+		};
 
+		if (parallelRecording && !shadowPasses.empty() && shadowQueue.size() >= minItemsPerTask)
+			runTasks(shadowPasses.size(), recordShadowPass);
+		else
+		{
+			for (size_t passIndex = 0; passIndex < shadowPasses.size(); passIndex++)
+				recordShadowPass(passIndex);
 		}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		// Replay the recorded passes on the thread of the context
+		for (size_t passIndex = 0; passIndex < shadowPasses.size(); passIndex++)
+			executeCommands(commandBuffers[passIndex]);
+
+		GLStateCache::bindFramebuffer(0);
 
 		Core::Maths::vec2 windowSize = Core::Application::getWindowSize();
 		glViewport(0, 0, (GLsizei)windowSize.x, (GLsizei)windowSize.y);
@@ -101,7 +583,7 @@ namespace LowRenderer
 
 	void RenderManager::drawSkybox()
 	{
-		glCullFace(GL_FRONT);
+		GLStateCache::cullFace(GL_FRONT);
 
 		for (auto& skyBox : skyBoxes)
 		{
@@ -110,135 +592,469 @@ namespace LowRenderer
 		}
 	}
 
-	void RenderManager::drawModels()
+	void RenderManager::assignLights(const Camera& camera)
 	{
-		std::shared_ptr<Resources::ShaderProgram> program;
+		using Clock = std::chrono::high_resolution_clock;
+		Clock::time_point assignStart = Clock::now();
 
-		GLEnable(GL_FRAMEBUFFER_SRGB);
+		lightClusters.begin(camera, Core::Application::getWindowSize());
 
-		glCullFace(GL_BACK);
+		for (Light* light : lights)
+		{
+			if (!light->isActive())
+				continue;
 
-		// Number of lights to render (8 max)
-		int lightCount = std::min((int)lights.size(), 8);
+			// The shadowed lights read their maps from their slot
+			auto shadowIt = std::find(shadowLights.begin(), shadowLights.end(), light);
+			int shadowIndex = shadowIt != shadowLights.end() ? (int)(shadowIt - shadowLights.begin()) : -1;
 
-		// Draw renderers
-		for (const auto& model : models)
+			lightClusters.addLight(*light, shadowIndex);
+		}
+
+		// Assign the lights to the clusters on the render pool, each task takes a range of slices
+		size_t assignTaskCount = std::min<size_t>(getTaskCount(lightClusters.getLightCount() * LightClusters::gridZ), LightClusters::gridZ);
+
+		runTasks(assignTaskCount, [this, assignTaskCount](size_t task)
 		{
-			if (!model->isActive())
-				continue;
+			int firstSlice = (int)(LightClusters::gridZ * task / assignTaskCount);
+			int endSlice = (int)(LightClusters::gridZ * (task + 1) / assignTaskCount);
 
-			// If the ShaderProgram has changed, bind it and send shared informations
-			if (program != model->getProgram())
+			lightClusters.assignSlices(firstSlice, endSlice);
+		});
+
+		lightClusters.upload();
+
+		counters.clusteredLights = (unsigned int)lightClusters.getLightCount();
+		counters.clusterLightIndices = (unsigned int)lightClusters.getAssignedCount();
+		counters.droppedClusterLights = (unsigned int)lightClusters.getDroppedCount();
+		counters.lightAssignMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - assignStart).count();
+	}
+
+	void RenderManager::cullOccluded(const Camera& camera, const Core::Maths::mat4& viewProjection, float projectionScale, size_t gatherTaskCount)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		Clock::time_point rasterStart = Clock::now();
+
+		occlusionBuffer.begin(viewProjection, camera.near);
+
+		// The opaque draws with an occluder that cover the most of the screen hide the others
+		struct OccluderCandidate
+		{
+			float screenSize;
+			const ModelDraw* draw;
+		};
+
+		std::vector<OccluderCandidate> candidates;
+
+		for (size_t task = 0; task < gatherTaskCount; task++)
+		{
+			const VisibleDraws& visible = visibleDraws[task];
+
+			for (size_t drawIndex = 0; drawIndex < visible.draws.size(); drawIndex++)
 			{
-				program = model->getProgram();
+				const ModelDraw& draw = visible.draws[drawIndex];
+
+				// The transparency holds the dissolve of the mtl, opaque at 1 and left at 0 when it is not given
+				bool isDissolved = draw.material->transparency > 0.f && draw.material->transparency < 1.f;
 
-				if (!program->bind())
+				if (!draw.mesh->isOccluder() || isDissolved
+					|| draw.material->textures[Resources::Material::ALPHA_TEXTURE] != Resources::Texture::defaultAlpha)
 					continue;
 
-				program->setUniform("minBias", (void*)&minBias, true);
-				program->setUniform("maxBias", (void*)&maxBias, true);
+				float screenSize = draw.bounds.radius * projectionScale / std::max(visible.depths[drawIndex], camera.near);
 
-				getCurrentCamera()->sendViewProjToProgram(program);
+				if (screenSize >= OcclusionBuffer::minOccluderScreenSize)
+					candidates.push_back({ screenSize, &draw });
+			}
+		}
 
-				std::vector<LightData> lightDatas;
+		size_t occluderCount = std::min(candidates.size(), OcclusionBuffer::maxOccluderCount);
 
-				int i = 0;
-				for (auto& light : lights)
-				{
-					if (i >= lightCount)
-						break;
+		std::partial_sort(candidates.begin(), candidates.begin() + occluderCount, candidates.end(), [](const OccluderCandidate& lhs, const OccluderCandidate& rhs)
+		{
+			return lhs.screenSize > rhs.screenSize;
+		});
+
+		for (size_t i = 0; i < occluderCount; i++)
+		{
+			const ModelDraw& draw = *candidates[i].draw;
+			occlusionBuffer.addOccluder(draw.mesh->getOccluderPositions(), draw.mesh->getOccluderIndices(), draw.data.model);
+		}
+
+		counters.occluders = (unsigned int)occluderCount;
+		counters.occluderTriangles = (unsigned int)occlusionBuffer.getTriangleCount();
+
+		if (occluderCount == 0u)
+			return;
+
+		// Project the occluders, then rasterize them on the render pool, each task takes a range of tile rows
+		size_t setupTaskCount = std::min(getTaskCount(occlusionBuffer.getTriangleCount()), occluderCount);
+
+		runTasks(setupTaskCount, [this, setupTaskCount, occluderCount](size_t task)
+		{
+			occlusionBuffer.setupOccluders(occluderCount * task / setupTaskCount, occluderCount * (task + 1) / setupTaskCount);
+		});
 
-					light->sendToProgram(program, i);
+		size_t rasterTaskCount = std::min<size_t>(getTaskCount(occlusionBuffer.getTriangleCount()), OcclusionBuffer::tileCountY);
 
-					light->addToLightBuffer(lightDatas);
+		runTasks(rasterTaskCount, [this, rasterTaskCount](size_t task)
+		{
+			int firstTileRow = (int)(OcclusionBuffer::tileCountY * task / rasterTaskCount);
+			int endTileRow = (int)(OcclusionBuffer::tileCountY * (task + 1) / rasterTaskCount);
+
+			occlusionBuffer.rasterizeTileRows(firstTileRow, endTileRow);
+		});
 
-					i++;
+		counters.occlusionRasterMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - rasterStart).count();
+
+		// Test the bounds of the visible draws on the tasks that gathered them
+		runTasks(gatherTaskCount, [this](size_t task)
+		{
+			VisibleDraws& visible = visibleDraws[task];
+
+			size_t keptCount = 0u;
+			for (size_t drawIndex = 0; drawIndex < visible.draws.size(); drawIndex++)
+			{
+				if (occlusionBuffer.isOccluded(visible.draws[drawIndex].bounds))
+					continue;
+
+				if (keptCount != drawIndex)
+				{
+					visible.draws[keptCount] = visible.draws[drawIndex];
+					visible.depths[keptCount] = visible.depths[drawIndex];
+					visible.renderers[keptCount] = visible.renderers[drawIndex];
 				}
 
-				glActiveTexture(0);
+				keptCount++;
+			}
+
+			unsigned int occludedCount = (unsigned int)(visible.draws.size() - keptCount);
+
+			visible.draws.erase(visible.draws.begin() + keptCount, visible.draws.end());
+			visible.depths.erase(visible.depths.begin() + keptCount, visible.depths.end());
+			visible.renderers.erase(visible.renderers.begin() + keptCount, visible.renderers.end());
+
+			visible.counters.drawn -= occludedCount;
+			visible.counters.occluded += occludedCount;
+		});
+	}
+
+	void RenderManager::drawModels()
+	{
+		GLEnable(GL_FRAMEBUFFER_SRGB);
+
+		GLStateCache::cullFace(GL_BACK);
+
+		Camera* camera = getCurrentCamera();
+		Core::Maths::mat4 viewProjection = camera->getViewProjection();
+		Frustum frustum(viewProjection);
+
+		// The camera pass chooses the levels of detail, the shadow passes of the next frame keep them
+		LodView lodView;
+		lodView.position = camera->getPosition();
+		lodView.projectionScale = 1.f / std::tan(camera->fovY * Core::Maths::DEG2RAD * 0.5f);
+		lodView.maxLod = useLods ? Resources::Mesh::maxLodCount - 1u : 0u;
+
+		activeModels.clear();
+		for (const auto& model : models)
+		{
+			if (model->isActive())
+				activeModels.push_back(model);
+		}
+
+		// Gather and cull the draws of the renderers on the render pool, each task takes a range of renderers
+		size_t gatherTaskCount = getTaskCount(activeModels.size());
 
-				auto& lightBlock = uniformBlocks["lightBlock"];
+		if (visibleDraws.size() < gatherTaskCount)
+			visibleDraws.resize(gatherTaskCount);
 
-				lightBlock->bind();
-				glBufferSubData(GL_UNIFORM_BUFFER, 0, lightDatas.size() * sizeof(LightData), lightDatas.data());
-				lightBlock->unbind();
+		runTasks(gatherTaskCount, [this, gatherTaskCount, &frustum, &viewProjection, &lodView](size_t task)
+		{
+			VisibleDraws& visible = visibleDraws[task];
+
+			visible.draws.clear();
+			visible.depths.clear();
+			visible.renderers.clear();
+			visible.counters = {};
+
+			size_t firstModel = activeModels.size() * task / gatherTaskCount;
+			size_t endModel = activeModels.size() * (task + 1) / gatherTaskCount;
+
+			for (size_t modelIndex = firstModel; modelIndex < endModel; modelIndex++)
+			{
+				const ModelRenderer* model = activeModels[modelIndex];
+
+				size_t firstDraw = visible.draws.size();
+				model->addDraws(visible.draws, &lodView);
+
+				cullDraws(visible.draws, firstDraw, frustum, visible.counters);
 
-				for (auto& skyBox : skyBoxes)
-					skyBox->sendToProgram(program);
+				for (size_t drawIndex = firstDraw; drawIndex < visible.draws.size(); drawIndex++)
+				{
+					// Clip space w is the view depth of the mesh
+					const Core::Maths::vec3& center = visible.draws[drawIndex].bounds.center;
+					float depth = viewProjection.e[12] * center.x + viewProjection.e[13] * center.y + viewProjection.e[14] * center.z + viewProjection.e[15];
+
+					visible.depths.push_back(depth);
+					visible.renderers.push_back(model);
+				}
 			}
+		});
+
+		if (occlusionCulling)
+			cullOccluded(*camera, viewProjection, lodView.projectionScale, gatherTaskCount);
+
+		// Queue the visible draws of all the renderers, sorted by program, material, mesh and depth
+		cameraQueue.clear(camera->far);
+
+		for (size_t task = 0; task < gatherTaskCount; task++)
+		{
+			const VisibleDraws& visible = visibleDraws[task];
+
+			for (size_t drawIndex = 0; drawIndex < visible.draws.size(); drawIndex++)
+				cameraQueue.push(0u, visible.renderers[drawIndex]->getProgram(), visible.draws[drawIndex], visible.depths[drawIndex]);
 
-			model->draw();
+			counters.cameraPass.drawn += visible.counters.drawn;
+			counters.cameraPass.culled += visible.counters.culled;
+			counters.cameraPass.occluded += visible.counters.occluded;
 		}
 
-		program->unbind();
+		cameraQueue.sort();
+
+		assignLights(*camera);
+
+		uploadDraws(cameraQueue);
+
+		// Record the sorted draws on the render pool, each task takes a range that starts on a new command
+		size_t recordTaskCount = getTaskCount(cameraQueue.size());
+
+		if (commandBuffers.size() < recordTaskCount)
+			commandBuffers.resize(recordTaskCount);
+
+		std::vector<size_t> rangeStarts;
+		for (size_t task = 0; task <= recordTaskCount; task++)
+		{
+			size_t start = cameraQueue.size() * task / recordTaskCount;
+
+			// The instances of a command are drawn by the same task
+			while (start > 0 && start < cameraQueue.size() && drawCommandIndices[start] == drawCommandIndices[start - 1])
+				start++;
+
+			rangeStarts.push_back(task > 0 ? std::max(start, rangeStarts.back()) : 0u);
+		}
+
+		runTasks(recordTaskCount, [this, &rangeStarts](size_t task)
+		{
+			RenderCommandBuffer& commands = commandBuffers[task];
+			commands.clear();
+
+			size_t endDraw = rangeStarts[task + 1];
+
+			// Bind each program once per range, then draw its meshes with one call per material
+			for (size_t first = rangeStarts[task]; first < endDraw;)
+			{
+				size_t last = std::min(cameraQueue.getRunEnd(first), endDraw);
 
-		drawColliders();
+				commands.bindProgram(cameraQueue.getProgram(first));
+				commands.sendFrameUniforms();
+
+				recordDraws(commands, cameraQueue, first, last, true);
+
+				first = last;
+			}
+		});
+
+		// Replay the recorded ranges in order on the thread of the context
+		for (size_t task = 0; task < recordTaskCount; task++)
+			executeCommands(commandBuffers[task]);
+
+		drawDebugLines(viewProjection);
 	}
 
-	void RenderManager::drawSprites()
+	void RenderManager::drawSpriteBatch(const std::shared_ptr<Resources::ShaderProgram>& program, const std::vector<const SpriteRenderer*>& sprites)
 	{
-		std::shared_ptr<Resources::ShaderProgram> program;
+		RenderManager* RM = instance();
+
+		RM->spriteBatch.begin();
+
+		for (const SpriteRenderer* sprite : sprites)
+			RM->spriteBatch.addSprite(*sprite);
 
-		glCullFace(GL_BACK);
+		RM->counters.batchedSprites += (unsigned int)RM->spriteBatch.getSpriteCount();
+		RM->counters.spriteDrawCalls += RM->spriteBatch.draw(program);
+	}
+
+	void RenderManager::drawSprites()
+	{
+		GLStateCache::cullFace(GL_BACK);
 
 		glClear(GL_DEPTH_BUFFER_BIT);
 
-		// Draw renderers
+		// Release the textures of the sprites drawn no more
+		spriteBatch.pruneEntries();
+
+		// Draw the sprites in order, a batch ends where the program changes
+		auto drawSpriteRun = [this]()
+		{
+			if (spriteRun.empty())
+				return;
+
+			std::shared_ptr<Resources::ShaderProgram> program = spriteRun.front()->getProgram();
+
+			if (program->bind())
+			{
+				getCurrentCamera()->sendViewOrthoToProgram(program);
+
+				drawSpriteBatch(program, spriteRun);
+
+				program->unbind();
+			}
+
+			spriteRun.clear();
+		};
+
 		for (const auto& sprite : sprites)
 		{
 			if (!sprite->isActive())
 				continue;
 
-			// If the ShaderProgram has changed, bind it and send shared informations
-			if (program != sprite->getProgram())
-			{
-				program = sprite->getProgram();
+			if (!spriteRun.empty() && spriteRun.front()->getProgram() != sprite->getProgram())
+				drawSpriteRun();
 
-				if (!program->bind())
-					continue;
+			spriteRun.push_back(sprite);
+		}
 
-				getCurrentCamera()->sendViewOrthoToProgram(program);
-			}
+		drawSpriteRun();
+
+		GLDisable(GL_FRAMEBUFFER_SRGB);
+	}
+
+	void RenderManager::drawTexts()
+	{
+		if (texts.empty())
+			return;
+
+		// Group the strings by font, to draw each font with a single call
+		for (auto& [font, fontVertices] : textBatches)
+			fontVertices.clear();
+
+		for (const auto& text : texts)
+		{
+			if (!text->isActive() || !text->getFont())
+				continue;
+
+			const std::vector<Resources::TextVertex>& textVertices = text->getVertices();
+
+			std::vector<Resources::TextVertex>& batch = textBatches[text->getFont().get()];
+			batch.insert(batch.end(), textVertices.begin(), textVertices.end());
+		}
+
+		std::shared_ptr<Resources::ShaderProgram> program = Resources::ResourcesManager::loadShaderProgram("textShader");
+
+		if (!program->bind())
+			return;
+
+		// Create the streamed buffer the first time
+		if (!textVAO)
+		{
+			glGenVertexArrays(1, &textVAO);
+			GLStateCache::bindVertexArray(textVAO);
+
+			glGenBuffers(1, &textVBO);
+			GLStateCache::bindBuffer(GL_ARRAY_BUFFER, textVBO);
+
+			GLsizei stride = sizeof(Resources::TextVertex);
+
+			// Set the attrib pointer to the positions and the texture coordinates
+			glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(Resources::TextVertex, positionUV)));
+			glEnableVertexAttribArray(0);
+
+			// Set the attrib pointer to the colors
+			glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(Resources::TextVertex, color)));
+			glEnableVertexAttribArray(1);
+		}
+		else
+		{
+			GLStateCache::bindVertexArray(textVAO);
+			GLStateCache::bindBuffer(GL_ARRAY_BUFFER, textVBO);
+		}
+
+		// The texts are positioned in pixels
+		Core::Maths::vec2 windowSize = Core::Application::getWindowSize();
+		Core::Maths::mat4 projection = Core::Maths::orthographic(0.f, windowSize.x, 0.f, windowSize.y, -1.f, 1.f);
+		program->setUniform(UniformIDs::proj, projection);
+
+		GLDisable(GL_DEPTH_TEST);
+		GLEnable(GL_BLEND);
+
+		for (const auto& [font, fontVertices] : textBatches)
+		{
+			if (fontVertices.empty())
+				continue;
 
-			sprite->draw();
+			int isSDF = font->isDistanceField();
+			program->setUniform(UniformIDs::sdf, isSDF);
+			program->setSampler(UniformIDs::text, font->getID());
+
+			// Orphan the previous buffer and upload all the strings of the font
+			glBufferData(GL_ARRAY_BUFFER, fontVertices.size() * sizeof(Resources::TextVertex), fontVertices.data(), GL_STREAM_DRAW);
+			glDrawArrays(GL_TRIANGLES, 0, (GLsizei)fontVertices.size());
 		}
 
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, 0);
+		GLStateCache::bindVertexArray(0);
+
 		program->unbind();
 
-		GLDisable(GL_FRAMEBUFFER_SRGB);
+		GLEnable(GL_DEPTH_TEST);
 	}
 
 	void RenderManager::draw()
 	{
 		RenderManager* RM = instance();
 
+		RM->lastCounters = RM->counters;
+		RM->counters = {};
+
+		// The resources created since the last frame may have changed the bindings
+		GLStateCache::beginFrame();
+
+		using Clock = std::chrono::high_resolution_clock;
+
+		// Measure the CPU time spent to submit the passes drawing the models
+		Clock::time_point shadowStart = Clock::now();
 		RM->drawShadows();
+
+		Clock::time_point modelStart = Clock::now();
 		RM->drawModels();
+
+		Clock::time_point modelEnd = Clock::now();
+
+		RM->counters.shadowMilliseconds = std::chrono::duration<double, std::milli>(modelStart - shadowStart).count();
+		RM->counters.modelMilliseconds = std::chrono::duration<double, std::milli>(modelEnd - modelStart).count();
+
 		RM->drawSkybox();
 		RM->drawSprites();
+		RM->drawTexts();
 	}
 
-	void RenderManager::drawColliders() const
+	const RenderCounters& RenderManager::getFrameCounters()
 	{
-		if (colliders.size() == 0)
-			return;
-
-		GLDisable(GL_DEPTH_TEST);
-
-		std::shared_ptr<Resources::ShaderProgram> program = (*colliders.begin())->getProgram();
-
-		if (!program->bind())
-			return;
-
-		getCurrentCamera()->sendProjToProgram(program);
+		return instance()->counters;
+	}
 
+	void RenderManager::drawDebugLines(const Core::Maths::mat4& viewProjection)
+	{
 		for (const auto& rendererCollider : colliders)
 		{
 			if (rendererCollider->canBeDraw())
-				rendererCollider->draw();
+				rendererCollider->addLines();
 		}
 
-		program->unbind();
+		// The gizmos are seen through the models
+		GLDisable(GL_DEPTH_TEST);
+
+		counters.debugLines += DebugDraw::flush(viewProjection);
 
 		GLEnable(GL_DEPTH_TEST);
 	}
@@ -279,6 +1095,12 @@ namespace LowRenderer
 		instance()->colliders.insert(compToLink);
 	}
 
+	void RenderManager::linkComponent(Resources::Text* compToLink)
+	{
+		// Insert text to render
+		instance()->texts.insert(compToLink);
+	}
+
 	void RenderManager::removeComponent(ColliderRenderer* compToRemove)
 	{
 		instance()->colliders.erase(compToRemove);
@@ -294,6 +1116,11 @@ namespace LowRenderer
 		instance()->models.erase(compToRemove);
 	}
 
+	void RenderManager::removeComponent(Resources::Text* compToRemove)
+	{
+		instance()->texts.erase(compToRemove);
+	}
+
 	void RenderManager::clearAll()
 	{
 		clearComponents<LowRenderer::SpriteRenderer>();
@@ -302,6 +1129,7 @@ namespace LowRenderer
 		clearComponents<LowRenderer::Camera>();
 		clearComponents<LowRenderer::Light>();
 		clearComponents<LowRenderer::SkyBox>();
+		clearComponents<Resources::Text>();
 	}
 
 	Camera* RenderManager::getCurrentCamera()
@@ -314,36 +1142,6 @@ namespace LowRenderer
 		return nullptr;
 	}
 
-	void RenderManager::bindUBO(Resources::ShaderProgram* program, const std::string& UBOName)
-	{
-		RenderManager* RM = instance();
-
-		GLuint UBIndex = program->getUBOLocation(UBOName);
-
-		// Uniform Block not include in the current shader
-		if (UBIndex < -1)
-			return;
-
-		auto uniformBlockIt = RM->uniformBlocks.find(UBOName);
-
-		GLuint bindingPoint;
-
-		// If the Uniform block already exists, return its binding point
-		if (uniformBlockIt != RM->uniformBlocks.end())
-		{
-			auto [uniformBlockName, uniformBlock] = *uniformBlockIt;
-			bindingPoint = uniformBlock->getBindingPoint();
-		}
-		// else create a new one, then return its binding point
-		else
-		{
-			bindingPoint = RM->uniformBlocks.size();
-			RM->uniformBlocks[UBOName] = std::make_shared<UniformBlock>(bindingPoint, sizeof(LightData) * 8);
-		}
-
-		program->bindToUBO(UBOName, UBIndex, bindingPoint);
-	}
-
 	void RenderManager::drawImGui()
 	{
 		auto RM = instance();
@@ -354,5 +1152,53 @@ namespace LowRenderer
 			ImGui::SliderFloat("Max bias", &RM->maxBias, 0.f, 1.f, "%.6f", 0.001f);
 		}
 		ImGui::End();
+
+		if (ImGui::Begin("Render counters"))
+		{
+			ImGui::Checkbox("Multi-draw indirect", &RM->useMultiDrawIndirect);
+			ImGui::Checkbox("Frustum culling", &RM->frustumCulling);
+			ImGui::Checkbox("Instancing", &RM->useInstancing);
+			ImGui::Checkbox("Parallel recording", &RM->parallelRecording);
+			ImGui::Checkbox("Cache shadow maps", &RM->cacheShadows);
+			ImGui::Checkbox("Levels of detail", &RM->useLods);
+			ImGui::Checkbox("Occlusion culling", &RM->occlusionCulling);
+
+			const RenderCounters& counters = RM->lastCounters;
+
+			ImGui::Text("Draw calls: %u", counters.drawCalls);
+			ImGui::Text("Drawn meshes: %u", counters.drawnMeshes);
+			ImGui::Text("Instanced meshes: %u", counters.instancedDraws);
+			ImGui::Text("Triangles: %u drawn, %u at full detail", counters.drawnTriangles, counters.fullDetailTriangles);
+			ImGui::Text("Program switches: %u", counters.programBinds);
+			ImGui::Text("Material switches: %u", counters.materialBinds);
+			ImGui::Text("VAO switches: %u", counters.vaoBinds);
+			ImGui::Text("Recorded commands: %u", counters.recordedCommands);
+			ImGui::Text("Sprites: %u in %u draw calls", counters.batchedSprites, counters.spriteDrawCalls);
+			ImGui::Text("Debug lines: %u", counters.debugLines);
+			ImGui::Text("Shadow pass CPU time: %.3f ms", counters.shadowMilliseconds);
+			ImGui::Text("Model pass CPU time: %.3f ms", counters.modelMilliseconds);
+			ImGui::Text("Light assignment CPU time: %.3f ms", counters.lightAssignMilliseconds);
+			ImGui::Text("Occluders: %u, %u triangles rasterized in %.3f ms", counters.occluders, counters.occluderTriangles, counters.occlusionRasterMilliseconds);
+			ImGui::Text("Clustered lights: %u, %u cluster indices, %u dropped", counters.clusteredLights, counters.clusterLightIndices, counters.droppedClusterLights);
+
+			// Drawn and culled meshes of each pass
+			ImGui::Text("Camera pass: %u drawn, %u culled, %u occluded", counters.cameraPass.drawn, counters.cameraPass.culled, counters.cameraPass.occluded);
+			ImGui::Text("Directional shadows: %u drawn, %u culled", counters.directionalPass.drawn, counters.directionalPass.culled);
+			ImGui::Text("Point shadows: %u drawn, %u culled", counters.pointPass.drawn, counters.pointPass.culled);
+
+			for (int cascade = 0; cascade < ShadowMap::maxCascadeCount; cascade++)
+				ImGui::Text("Cascade %d: %u drawn, %u culled", cascade, counters.cascadePasses[cascade].drawn, counters.cascadePasses[cascade].culled);
+
+			ImGui::Text("Shadow maps: %u drawn, %u cached", counters.drawnShadowMaps, counters.cachedShadowMaps);
+
+			GeometryArena::drawImGui();
+			ShadowAtlas::drawImGui();
+
+			ImGui::Text("GL calls:");
+			GLStateCache::drawImGui();
+
+			RenderBackend::drawImGui();
+		}
+		ImGui::End();
 	}
 }
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "render_queue.hpp"
+
+#include <algorithm>
+
+#include "shader.hpp"
+
+namespace LowRenderer
+{
+	// Bits of each field of the sort keys
+	constexpr uint64_t passBits = 8u;
+	constexpr uint64_t programBits = 10u;
+	constexpr uint64_t materialBits = 14u;
+	constexpr uint64_t cullingBits = 1u;
+	constexpr uint64_t meshBits = 15u;
+	constexpr uint64_t depthBits = 16u;
+
+	static_assert(passBits + programBits + materialBits + cullingBits + meshBits + depthBits == 64u, "The sort key fields must fill 64 bits");
+
+	constexpr uint64_t mask(uint64_t bits)
+	{
+		return (1ull << bits) - 1ull;
+	}
+
+	template <typename T>
+	uint32_t getStateID(std::unordered_map<T, uint32_t>& IDs, T state)
+	{
+		auto [it, isNew] = IDs.try_emplace(state, (uint32_t)IDs.size());
+
+		return it->second;
+	}
+
+	void RenderQueue::clear(float maxDepth)
+	{
+		this->maxDepth = std::max(maxDepth, 0.0001f);
+
+		items.clear();
+		draws.clear();
+
+		programs.clear();
+		programIDs.clear();
+		materialIDs.clear();
+		meshIDs.clear();
+	}
+
+	void RenderQueue::push(uint32_t pass, const std::shared_ptr<Resources::ShaderProgram>& program, const ModelDraw& draw, float depth)
+	{
+		uint32_t programIndex = getStateID(programIDs, program.get());
+		if (programIndex == programs.size())
+			programs.push_back(program);
+
+		uint64_t materialID = getStateID(materialIDs, draw.material);
+		// The levels of detail of a mesh follow each other
+		uint64_t meshID = getStateID(meshIDs, draw.mesh) * Resources::Mesh::maxLodCount + draw.lod;
+
+		// Draw the closest meshes first to reject the hidden fragments early
+		uint64_t quantizedDepth = (uint64_t)(std::clamp(depth / maxDepth, 0.f, 1.f) * mask(depthBits));
+
+		uint64_t key = pass & mask(passBits);
+		key = (key << programBits) | (programIndex & mask(programBits));
+		key = (key << materialBits) | (materialID & mask(materialBits));
+		key = (key << cullingBits) | (draw.hasFaceCulling ? 1u : 0u);
+		key = (key << meshBits) | (meshID & mask(meshBits));
+		key = (key << depthBits) | quantizedDepth;
+
+		items.push_back({ key, (uint32_t)draws.size(), programIndex, pass });
+		draws.push_back(draw);
+	}
+
+	void RenderQueue::sort()
+	{
+		size_t itemCount = items.size();
+
+		// Count the items of each byte value, for the eight bytes at once
+		std::vector<size_t> counts(8 * 256, 0u);
+		for (const RenderQueueItem& item : items)
+		{
+			for (int digit = 0; digit < 8; digit++)
+				counts[digit * 256 + ((item.key >> (digit * 8)) & 0xFF)]++;
+		}
+
+		sortedItems.resize(itemCount);
+
+		// Least significant digit first, each pass is stable
+		for (int digit = 0; digit < 8; digit++)
+		{
+			size_t* digitCounts = &counts[digit * 256];
+
+			// Skip the bytes that are the same for all the items
+			if (std::find(digitCounts, digitCounts + 256, itemCount) != digitCounts + 256)
+				continue;
+
+			size_t offset = 0u;
+			for (int value = 0; value < 256; value++)
+			{
+				size_t count = digitCounts[value];
+				digitCounts[value] = offset;
+				offset += count;
+			}
+
+			for (const RenderQueueItem& item : items)
+				sortedItems[digitCounts[(item.key >> (digit * 8)) & 0xFF]++] = item;
+
+			items.swap(sortedItems);
+		}
+
+		sortedDraws.clear();
+		for (const RenderQueueItem& item : items)
+			sortedDraws.push_back(draws[item.drawIndex]);
+	}
+
+	const std::vector<ModelDraw>& RenderQueue::getDraws() const
+	{
+		return sortedDraws;
+	}
+
+	size_t RenderQueue::size() const
+	{
+		return items.size();
+	}
+
+	uint32_t RenderQueue::getPass(size_t index) const
+	{
+		return items[index].pass;
+	}
+
+	const std::shared_ptr<Resources::ShaderProgram>& RenderQueue::getProgram(size_t index) const
+	{
+		return programs[items[index].programIndex];
+	}
+
+	bool RenderQueue::isSameRun(size_t lhs, size_t rhs) const
+	{
+		return items[lhs].pass == items[rhs].pass && items[lhs].programIndex == items[rhs].programIndex;
+	}
+
+	size_t RenderQueue::getRunEnd(size_t first) const
+	{
+		size_t last = first + 1;
+		while (last < items.size() && isSameRun(first, last))
+			last++;
+
+		return last;
+	}
+}
@@ -1,52 +1,135 @@
 #include "shadow.hpp"
 
 #include "resources_manager.hpp"
-#include "application.hpp"
+#include "gl_state_cache.hpp"
+#include "hash.hpp"
 
 namespace LowRenderer
 {
 	Shadow::Shadow(const std::string& shaderProgramName)
 	{
-		shadowWidth = (unsigned int)((float)shadowWidth * superSample);
-		shadowHeight = (unsigned int)((float)shadowHeight * superSample);
+		program = Resources::ResourcesManager::loadShaderProgram(shaderProgramName);
+	}
 
-		aspect = (float)shadowWidth / (float)shadowHeight;
+	uint64_t Shadow::hashCaster(uint64_t castersHash, const void* mesh, uint32_t lod, const Core::Maths::mat4& model)
+	{
+		// A caster which changes its level of detail changes its depth too
+		castersHash = Utils::hashBytes(&mesh, sizeof(mesh), castersHash);
+		castersHash = Utils::hashBytes(&lod, sizeof(lod), castersHash);
+		return Utils::hashBytes(model.e, sizeof(model.e), castersHash);
+	}
 
-		program = Resources::ResourcesManager::loadShaderProgram(shaderProgramName);
+	ShadowUpdate Shadow::getUpdate(size_t pass, uint64_t staticCastersHash, size_t staticCasterCount, uint64_t dynamicCastersHash, size_t dynamicCasterCount)
+	{
+		if (caches.size() != getPassCount())
+			caches.assign(getPassCount(), ShadowCache());
+
+		ShadowCache& cache = caches[pass];
+
+		// The map depends on the matrices of the views
+		uint64_t viewHash = getPassHash(pass);
+
+		bool isViewChanged = !cache.isCached || viewHash != cache.viewHash;
+		bool isStaticChanged = isViewChanged || staticCastersHash != cache.staticHash;
+		bool isDynamicChanged = isViewChanged || dynamicCastersHash != cache.dynamicHash;
+
+		cache.isCached = true;
+		cache.viewHash = viewHash;
+		cache.staticHash = staticCastersHash;
+		cache.dynamicHash = dynamicCastersHash;
+
+		if (!isStaticChanged && !isDynamicChanged)
+			return ShadowUpdate::NONE;
+
+		// With a single kind of casters, there is nothing to composite
+		if (staticCasterCount == 0 || dynamicCasterCount == 0)
+		{
+			cache.isStaticMapValid = false;
+			return ShadowUpdate::ALL_CASTERS;
+		}
+
+		if (isStaticChanged || !cache.isStaticMapValid)
+		{
+			cache.isStaticMapValid = true;
+			return ShadowUpdate::STATIC_THEN_DYNAMIC_CASTERS;
+		}
+
+		return ShadowUpdate::DYNAMIC_CASTERS;
 	}
 
-	Shadow::~Shadow()
+	void Shadow::invalidateCache()
 	{
-		if (FBO)
-			glDeleteFramebuffers(1, &FBO);
+		caches.clear();
+	}
 
-		if (ID)
-			glDeleteTextures(1, &ID);
+	void Shadow::setTiles(const std::vector<AtlasTile>& newTiles)
+	{
+		// The cached map stays in the old tiles, that may now belong to other lights
+		if (newTiles != tiles)
+			invalidateCache();
 
-		unbindAndResetViewport();
+		tiles = newTiles;
 	}
 
-	float Shadow::getAspect() const
+	const std::vector<AtlasTile>& Shadow::getTiles() const
 	{
-		return aspect;
+		return tiles;
 	}
 
-	bool Shadow::bindAndSetViewport()
+	void Shadow::sendToLitProgram(const std::shared_ptr<Resources::ShaderProgram>& program, int lightIndex) const
 	{
-		if (!FBO)
-			return false;
+		// Offset and size of each tile in texture coordinates, a size of zero means no map
+		Core::Maths::vec4 textureTiles[maxViewCount];
 
-		glViewport(0, 0, shadowWidth, shadowHeight);
-		glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+		float texelSize = 1.f / (float)ShadowAtlas::atlasSize;
 
-		return true;
+		for (size_t view = 0; view < tiles.size() && view < maxViewCount; view++)
+		{
+			const AtlasTile& tile = tiles[view];
+			textureTiles[view] = Core::Maths::vec4((float)tile.x * texelSize, (float)tile.y * texelSize, (float)tile.size * texelSize, 0.f);
+		}
+
+		program->setUniform(getElementID(UniformIDs::shadowTiles, lightIndex * maxViewCount), textureTiles, maxViewCount);
 	}
 
-	void Shadow::unbindAndResetViewport()
+	bool Shadow::bindTarget(size_t pass, ShadowTarget target)
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		size_t passViewCount = tiles.size() / getPassCount();
+		if (passViewCount == 0)
+			return false;
+
+		std::vector<AtlasTile> passTiles(tiles.begin() + pass * passViewCount, tiles.begin() + (pass + 1) * passViewCount);
 
-		Core::Maths::vec2 windowSize = Core::Application::getWindowSize();
-		glViewport(0, 0, (GLsizei)windowSize.x, (GLsizei)windowSize.y);
+		if (target == ShadowTarget::MAP_FROM_STATIC)
+		{
+			// Start from the baked static casters instead of empty tiles
+			for (const AtlasTile& tile : passTiles)
+				ShadowAtlas::copyFromStatic(tile);
+		}
+
+		GLStateCache::bindFramebuffer(ShadowAtlas::getFramebuffer(target == ShadowTarget::STATIC_MAP));
+
+		// Clear the tiles of the pass only, the other passes keep their maps
+		if (target != ShadowTarget::MAP_FROM_STATIC)
+		{
+			GLStateCache::setCapState(GL_SCISSOR_TEST, true);
+
+			for (const AtlasTile& tile : passTiles)
+			{
+				glScissor(tile.x, tile.y, tile.size, tile.size);
+				glClear(GL_DEPTH_BUFFER_BIT);
+			}
+
+			GLStateCache::setCapState(GL_SCISSOR_TEST, false);
+		}
+
+		// A viewport per view, the geometry shader of the point shadows chooses one for each face
+		for (GLuint view = 0; view < (GLuint)passTiles.size(); view++)
+		{
+			const AtlasTile& tile = passTiles[view];
+			glViewportIndexedf(view, (GLfloat)tile.x, (GLfloat)tile.y, (GLfloat)tile.size, (GLfloat)tile.size);
+		}
+
+		return true;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,209 @@
+#include "shadow_atlas.hpp"
+
+#include <algorithm>
+
+#include <imgui.h>
+
+#include "shadow.hpp"
+#include "gl_state_cache.hpp"
+
+namespace LowRenderer
+{
+	bool operator==(const AtlasTile& lhs, const AtlasTile& rhs)
+	{
+		return lhs.x == rhs.x && lhs.y == rhs.y && lhs.size == rhs.size;
+	}
+
+	bool operator!=(const AtlasTile& lhs, const AtlasTile& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	ShadowAtlas::ShadowAtlas()
+	{
+		createTexture(FBO, ID);
+	}
+
+	ShadowAtlas::~ShadowAtlas()
+	{
+		if (FBO)
+			glDeleteFramebuffers(1, &FBO);
+
+		if (ID)
+			glDeleteTextures(1, &ID);
+
+		if (staticFBO)
+			glDeleteFramebuffers(1, &staticFBO);
+
+		if (staticID)
+			glDeleteTextures(1, &staticID);
+	}
+
+	void ShadowAtlas::createTexture(GLuint& framebuffer, GLuint& texture)
+	{
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, atlasSize, atlasSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+
+		// The lit programs keep their samples inside the tiles
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		glGenFramebuffers(1, &framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		// The atlases may be created during a frame, after the cache has recorded some bindings
+		GLStateCache::invalidate();
+	}
+
+	bool ShadowAtlas::allocate(GLsizei size, AtlasTile& tile)
+	{
+		// Take the smallest free square that can hold the tile, the first one in the atlas for a stable packing
+		auto bestIt = freeTiles.end();
+		for (auto it = freeTiles.begin(); it != freeTiles.end(); it++)
+		{
+			if (it->size >= size && (bestIt == freeTiles.end() || it->size < bestIt->size))
+				bestIt = it;
+		}
+
+		if (bestIt == freeTiles.end())
+			return false;
+
+		tile = *bestIt;
+		freeTiles.erase(bestIt);
+
+		// Split the square in four until it has the size of the tile, the other quarters stay free
+		while (tile.size > size)
+		{
+			tile.size /= 2;
+
+			freeTiles.push_back({ tile.x + tile.size, tile.y, tile.size });
+			freeTiles.push_back({ tile.x, tile.y + tile.size, tile.size });
+			freeTiles.push_back({ tile.x + tile.size, tile.y + tile.size, tile.size });
+		}
+
+		return true;
+	}
+
+	bool ShadowAtlas::allocateRequests(int downscale, std::vector<AtlasTile>& tiles)
+	{
+		freeTiles.clear();
+		freeTiles.push_back({ 0, 0, atlasSize });
+
+		tiles.clear();
+
+		bool areAllocated = true;
+		for (const AtlasRequest& request : requests)
+		{
+			GLsizei size = std::max(request.tileSize >> downscale, minTileSize);
+
+			for (GLsizei view = 0; view < request.shadow->getViewCount(); view++)
+			{
+				AtlasTile tile;
+				areAllocated &= allocate(size, tile);
+
+				// The views without a tile are not drawn and do not shadow anything
+				tiles.push_back(tile);
+			}
+		}
+
+		return areAllocated;
+	}
+
+	void ShadowAtlas::begin()
+	{
+		instance()->requests.clear();
+	}
+
+	void ShadowAtlas::request(Shadow* shadow, float importance)
+	{
+		GLsizei maxTileSize = shadow->getMaxTileSize();
+
+		// Smallest power of two that keeps the resolution asked by the importance
+		GLsizei size = maxTileSize;
+		while (size / 2 >= minTileSize && (float)(size / 2) >= importance * (float)maxTileSize)
+			size /= 2;
+
+		instance()->requests.push_back({ shadow, size });
+	}
+
+	void ShadowAtlas::pack()
+	{
+		ShadowAtlas* SA = instance();
+
+		// Splitting the biggest squares first leaves no gap between the tiles of a same size
+		std::stable_sort(SA->requests.begin(), SA->requests.end(), [](const AtlasRequest& lhs, const AtlasRequest& rhs)
+		{
+			return lhs.tileSize > rhs.tileSize;
+		});
+
+		// Halve all the tiles until they fit, the smallest tiles stop at the minimum size
+		std::vector<AtlasTile> tiles;
+
+		SA->downscale = 0;
+		while (!SA->allocateRequests(SA->downscale, tiles) && (ShadowAtlas::atlasSize >> SA->downscale) > minTileSize)
+			SA->downscale++;
+
+		SA->usedArea = 0u;
+
+		auto tileIt = tiles.begin();
+		for (const AtlasRequest& request : SA->requests)
+		{
+			std::vector<AtlasTile> shadowTiles(tileIt, tileIt + request.shadow->getViewCount());
+			tileIt += request.shadow->getViewCount();
+
+			for (const AtlasTile& tile : shadowTiles)
+				SA->usedArea += (size_t)tile.size * (size_t)tile.size;
+
+			request.shadow->setTiles(shadowTiles);
+		}
+	}
+
+	GLuint ShadowAtlas::getID()
+	{
+		return instance()->ID;
+	}
+
+	GLuint ShadowAtlas::getFramebuffer(bool isStatic)
+	{
+		ShadowAtlas* SA = instance();
+
+		if (!isStatic)
+			return SA->FBO;
+
+		// Only the scenes with cached shadows need the static atlas
+		if (!SA->staticFBO)
+			SA->createTexture(SA->staticFBO, SA->staticID);
+
+		return SA->staticFBO;
+	}
+
+	void ShadowAtlas::copyFromStatic(const AtlasTile& tile)
+	{
+		ShadowAtlas* SA = instance();
+
+		if (!SA->staticID)
+			return;
+
+		glCopyImageSubData(SA->staticID, GL_TEXTURE_2D, 0, tile.x, tile.y, 0, SA->ID, GL_TEXTURE_2D, 0, tile.x, tile.y, 0, tile.size, tile.size, 1);
+	}
+
+	void ShadowAtlas::drawImGui()
+	{
+		ShadowAtlas* SA = instance();
+
+		size_t atlasArea = (size_t)atlasSize * (size_t)atlasSize;
+
+		ImGui::Text("Shadow atlas: %d x %d, %zu shadows", atlasSize, atlasSize, SA->requests.size());
+		ImGui::Text("Shadow atlas used: %.1f%%, tiles halved %d times", 100.f * (float)SA->usedArea / (float)atlasArea, SA->downscale);
+	}
+}
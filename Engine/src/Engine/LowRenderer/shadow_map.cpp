@@ -1,8 +1,15 @@
 #include "shadow_map.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+#include <imgui.h>
+
 #include "resources_manager.hpp"
 #include "render_manager.hpp"
 #include "debug.hpp"
+#include "hash.hpp"
 
 namespace LowRenderer
 {
@@ -10,55 +17,189 @@ namespace LowRenderer
 		: Shadow("depthShader")
 	{
 		Core::Debug::Log::info("Create ShadowMap");
+	}
+
+	void ShadowMap::compute(const LowRenderer::Light* light)
+	{
+		Camera* camera = RenderManager::getCurrentCamera();
+
+		cascadeSpheres.clear();
+		cascadeMatrices.clear();
+		cascadeFrustums.clear();
+
+		if (!camera)
+			return;
+
+		int count = std::clamp(cascadeCount, 1, maxCascadeCount);
+
+		// The light looks at the origin from its position, its plane only turns with it
+		Core::Maths::vec3 lightDirection = light->position.normalized();
+		Core::Maths::vec3 lightUp = std::abs(lightDirection.y) > 0.99f ? Core::Maths::vec3(0.f, 0.f, 1.f) : Core::Maths::vec3(0.f, 1.f, 0.f);
+		Core::Maths::mat4 lightView = Core::Maths::lookAt(Core::Maths::vec3(), -lightDirection, lightUp);
+
+		// Axes of the camera, from the rows of its view
+		Core::Maths::mat4 view = camera->getViewMatrix();
+		Core::Maths::vec3 cameraRight = Core::Maths::vec3(view.e[0], view.e[1], view.e[2]);
+		Core::Maths::vec3 cameraUp = Core::Maths::vec3(view.e[4], view.e[5], view.e[6]);
+		Core::Maths::vec3 cameraForward = -Core::Maths::vec3(view.e[8], view.e[9], view.e[10]);
+		Core::Maths::vec3 cameraPosition = camera->getPosition();
+
+		float tanY = std::tan(camera->fovY * Core::Maths::DEG2RAD * 0.5f);
+		float tanX = tanY * camera->aspect;
+
+		float nearPlane = std::max(camera->near, 0.001f);
+		float farPlane = std::max(std::min(camera->far, shadowDistance), nearPlane);
+
+		// Bounding sphere of each slice of the camera frustum, in light space
+		std::vector<Core::Maths::vec3> centers;
+		std::vector<float> radii;
+
+		float sliceNear = nearPlane;
+		for (int cascade = 0; cascade < count; cascade++)
+		{
+			float ratio = (float)(cascade + 1) / (float)count;
+			float logSplit = nearPlane * std::pow(farPlane / nearPlane, ratio);
+			float uniformSplit = nearPlane + (farPlane - nearPlane) * ratio;
+			float sliceFar = splitLambda * logSplit + (1.f - splitLambda) * uniformSplit;
+
+			Core::Maths::vec3 corners[8];
+			Core::Maths::vec3 center;
+
+			for (int corner = 0; corner < 8; corner++)
+			{
+				float depth = corner < 4 ? sliceNear : sliceFar;
+				float signX = (corner & 1) ? 1.f : -1.f;
+				float signY = (corner & 2) ? 1.f : -1.f;
+
+				corners[corner] = cameraPosition + cameraForward * depth + cameraRight * (signX * depth * tanX) + cameraUp * (signY * depth * tanY);
+				center += corners[corner];
+			}
+
+			center = center / 8.f;
+
+			// A sphere keeps the same size when the camera turns, rounded to ignore the float noise
+			float radius = 0.f;
+			for (const Core::Maths::vec3& corner : corners)
+				radius = std::max(radius, (corner - center).magnitude());
+
+			radius = std::ceil(radius * 16.f) / 16.f;
+
+			// Snap the center to the texels of the tile, a moving camera does not make the edges shimmer
+			GLsizei tileSize = (size_t)cascade < tiles.size() && tiles[cascade].size > 0 ? tiles[cascade].size : getMaxTileSize();
+			float texelSize = 2.f * radius / (float)tileSize;
 
-		create();
+			Core::Maths::vec4 lightCenter = lightView * Core::Maths::vec4(center, 1.f);
+			lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+			lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+			centers.push_back(lightCenter.xyz);
+			radii.push_back(radius);
+
+			cascadeSpheres.push_back(Core::Maths::vec4(lightCenter.x, lightCenter.y, radius, sliceFar));
+
+			sliceNear = sliceFar;
+		}
+
+		// Depth range shared by the cascades, from the casters in front of the first one to the end of the last one
+		float depthNear = FLT_MAX;
+		float depthFar = -FLT_MAX;
+
+		for (size_t cascade = 0; cascade < centers.size(); cascade++)
+		{
+			depthNear = std::min(depthNear, -centers[cascade].z - radii[cascade]);
+			depthFar = std::max(depthFar, -centers[cascade].z + radii[cascade]);
+		}
+
+		// Move the range by steps, the maps stay the same while the camera moves a little
+		float depthStep = radii.back() / 8.f;
+		depthNear = std::floor((depthNear - casterDistance) / depthStep) * depthStep;
+		depthFar = std::ceil(depthFar / depthStep) * depthStep;
+
+		float depthRange = depthFar - depthNear;
+
+		// Position on the light plane, and depth from zero to one
+		const float* e = lightView.e;
+		cascadeSpace =
+		{
+			e[0], e[1], e[2], e[3],
+			e[4], e[5], e[6], e[7],
+			-e[8] / depthRange, -e[9] / depthRange, -e[10] / depthRange, (-e[11] - depthNear) / depthRange,
+			0.f, 0.f, 0.f, 1.f
+		};
+
+		for (size_t cascade = 0; cascade < centers.size(); cascade++)
+		{
+			float radius = radii[cascade];
+
+			// Orthographic projection of the square around the sphere, the depth goes from [0, 1] to [-1, 1]
+			Core::Maths::mat4 cascadeProjection =
+			{
+				1.f / radius, 0.f, 0.f, -centers[cascade].x / radius,
+				0.f, 1.f / radius, 0.f, -centers[cascade].y / radius,
+				0.f, 0.f, 2.f, -1.f,
+				0.f, 0.f, 0.f, 1.f
+			};
+
+			cascadeMatrices.push_back(cascadeProjection * cascadeSpace);
+			cascadeFrustums.emplace_back(cascadeMatrices.back());
+		}
 	}
 
-	void ShadowMap::generateBuffer()
+	const Core::Maths::mat4& ShadowMap::getCascadeSpace() const
 	{
-		glGenFramebuffers(1, &FBO);
+		return cascadeSpace;
 	}
 
-	void ShadowMap::generateTexture()
+	void ShadowMap::sendToShader(const LowRenderer::Light* light, size_t pass) const
 	{
-		glGenTextures(1, &ID);
-		glBindTexture(GL_TEXTURE_2D, ID);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, shadowWidth, shadowHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+		program->setUniform(UniformIDs::lightSpaceMatrix, cascadeMatrices[pass]);
+	}
 
-		// Clamp to border for deactivate frustum shadows
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	void ShadowMap::sendToLitProgram(const std::shared_ptr<Resources::ShaderProgram>& program, int lightIndex) const
+	{
+		Shadow::sendToLitProgram(program, lightIndex);
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+		// The unused cascades end at a depth of zero
+		Core::Maths::vec4 spheres[maxViewCount];
+		std::copy(cascadeSpheres.begin(), cascadeSpheres.end(), spheres);
+
+		program->setUniform(getElementID(UniformIDs::shadowCascades, lightIndex * maxViewCount), spheres, maxViewCount);
+	}
 
+	GLsizei ShadowMap::getViewCount() const
+	{
+		return (GLsizei)cascadeMatrices.size();
+	}
 
-		float borderColor[] = { 1.f, 1.f, 1.f, 1.f };
-		glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+	GLsizei ShadowMap::getMaxTileSize() const
+	{
+		// The cascades are small, four of them take the place of a single map of 4096
+		return 2048;
+	}
 
-		glBindTexture(GL_TEXTURE_2D, 0);
+	size_t ShadowMap::getPassCount() const
+	{
+		// Each cascade culls its own casters
+		return cascadeMatrices.size();
 	}
 
-	void ShadowMap::attachTextureToBuffer()
+	bool ShadowMap::isCaster(size_t pass, const ModelDraw& draw, float& depth) const
 	{
-		Core::Debug::Log::info("ShadowMap : Attach texture and depth buffer");
+		depth = 0.f;
 
-		glBindFramebuffer(GL_FRAMEBUFFER, FBO);
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, ID, 0);
-		glDrawBuffer(GL_NONE);
-		glReadBuffer(GL_NONE);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		return cascadeFrustums[pass].intersects(draw.bounds.center, draw.bounds.extents);
 	}
 
-	void ShadowMap::create()
+	uint64_t ShadowMap::getPassHash(size_t pass) const
 	{
-		generateBuffer();
-		generateTexture();
-		attachTextureToBuffer();
+		return Utils::hashBytes(cascadeMatrices[pass].e, sizeof(cascadeMatrices[pass].e), emptyCastersHash);
 	}
 
-	void ShadowMap::sendToShader(const LowRenderer::Light* light) const
+	void ShadowMap::drawImGui()
 	{
-		program->setUniform("lightSpaceMatrix", light->getSpaceMatrix().e, false, 1, 1);
+		ImGui::SliderInt("Cascades", &cascadeCount, 1, maxCascadeCount);
+		ImGui::DragFloat("Shadow distance", &shadowDistance, 1.f, 1.f, 1000.f);
+		ImGui::SliderFloat("Split lambda", &splitLambda, 0.f, 1.f);
+		ImGui::DragFloat("Caster distance", &casterDistance, 1.f, 0.f, 1000.f);
 	}
 }
\ No newline at end of file
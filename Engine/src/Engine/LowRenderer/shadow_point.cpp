@@ -2,6 +2,7 @@
 
 #include "debug.hpp"
 #include "resources_manager.hpp"
+#include "hash.hpp"
 
 namespace LowRenderer
 {
@@ -9,75 +10,91 @@ namespace LowRenderer
 		: Shadow("depthCubeShader")
 	{
 		Core::Debug::Log::info("Create ShadowPoint");
-
-		create();
 	}
 
-	void ShadowPoint::generateBuffer()
+	const Core::Maths::mat4* ShadowPoint::getFaceMatrices()
 	{
-		glGenFramebuffers(1, &FBO);
+		static const Core::Maths::mat4* faceMatrices = []()
+		{
+			static Core::Maths::mat4 matrices[6];
+
+			// Direction and up vector of each face of the cube
+			const Core::Maths::vec3 faceDirections[6][2] =
+			{
+				{ Core::Maths::vec3(1.f, 0.f, 0.f), Core::Maths::vec3(0.f, -1.f, 0.f) },
+				{ Core::Maths::vec3(-1.f, 0.f, 0.f), Core::Maths::vec3(0.f, -1.f, 0.f) },
+				{ Core::Maths::vec3(0.f, 1.f, 0.f), Core::Maths::vec3(0.f, 0.f, 1.f) },
+				{ Core::Maths::vec3(0.f, -1.f, 0.f), Core::Maths::vec3(0.f, 0.f, -1.f) },
+				{ Core::Maths::vec3(0.f, 0.f, 1.f), Core::Maths::vec3(0.f, -1.f, 0.f) },
+				{ Core::Maths::vec3(0.f, 0.f, -1.f), Core::Maths::vec3(0.f, -1.f, 0.f) },
+			};
+
+			Core::Maths::mat4 shadowProjection = Core::Maths::perspective(Core::Maths::DEG2RAD * 90.f, 1.f, 0.001f, farPlane);
+
+			for (int i = 0; i < 6; i++)
+				matrices[i] = shadowProjection * Core::Maths::lookAt(Core::Maths::vec3(), faceDirections[i][0], faceDirections[i][1]);
+
+			return matrices;
+		}();
+
+		return faceMatrices;
 	}
 
-	void ShadowPoint::generateTexture()
+	void ShadowPoint::compute(const LowRenderer::Light* light)
 	{
-		glGenTextures(1, &ID);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, ID);
+		Core::Maths::vec3 lightPos = light->position;
+
+		if (hasMatrices && lightPos == matricesPosition)
+			return;
+
+		hasMatrices = true;
+		matricesPosition = lightPos;
+
+		// The lit programs only need the faces at the origin, the position is removed from the fragments instead
+		const Core::Maths::mat4* faceMatrices = getFaceMatrices();
 
 		for (int i = 0; i < 6; i++)
-			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_DEPTH_COMPONENT, 
-						 shadowWidth, shadowHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+			shadowTransforms[i] = faceMatrices[i] * Core::Maths::translate(-lightPos);
+	}
 
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	void ShadowPoint::sendToShader(const LowRenderer::Light* light, size_t pass) const
+	{
+		for (int i = 0; i < 6; i++)
+			program->setUniform(getElementID(UniformIDs::shadowMatrices, i), shadowTransforms[i]);
 
-		glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+		program->setUniform(UniformIDs::farPlane, farPlane);
+		program->setUniform(UniformIDs::lightPos, light->position);
 	}
 
-	void ShadowPoint::attachTextureToBuffer()
+	void ShadowPoint::sendToLitProgram(const std::shared_ptr<Resources::ShaderProgram>& program, int lightIndex) const
 	{
-		Core::Debug::Log::info("ShadowPoint : Attach texture and depth buffer");
+		program->setUniform(UniformIDs::farPlane, farPlane);
+		program->setUniform(getElementID(UniformIDs::pointFaceMatrices, 0), getFaceMatrices(), 6);
 
-		glBindFramebuffer(GL_FRAMEBUFFER, FBO);
-		glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, ID, 0);
-		glDrawBuffer(GL_NONE);
-		glReadBuffer(GL_NONE);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		Shadow::sendToLitProgram(program, lightIndex);
 	}
 
-	void ShadowPoint::create()
+	GLsizei ShadowPoint::getViewCount() const
 	{
-		generateBuffer();
-		generateTexture();
-		attachTextureToBuffer();
+		return 6;
 	}
 
-	void ShadowPoint::sendToShader(const LowRenderer::Light* light) const
+	GLsizei ShadowPoint::getMaxTileSize() const
 	{
-		Core::Maths::vec3 lightPos = light->position;
-		float farPlane = 25.f;
-
-		Core::Maths::mat4 shadowProjection = Core::Maths::perspective(Core::Maths::DEG2RAD * 90.f, getAspect(), 0.001f, farPlane);
-		std::vector<Core::Maths::mat4> shadowTransforms;
-		shadowTransforms.push_back(shadowProjection * Core::Maths::lookAt(lightPos, lightPos + Core::Maths::vec3(1.f, 0.f, 0.f),
-			Core::Maths::vec3(0.f, -1.f, 0.f)));
-		shadowTransforms.push_back(shadowProjection * Core::Maths::lookAt(lightPos, lightPos + Core::Maths::vec3(-1.f, 0.f, 0.f),
-			Core::Maths::vec3(0.f, -1.f, 0.f)));
-		shadowTransforms.push_back(shadowProjection * Core::Maths::lookAt(lightPos, lightPos + Core::Maths::vec3(0.f, 1.f, 0.f),
-			Core::Maths::vec3(0.f, 0.f, 1.f)));
-		shadowTransforms.push_back(shadowProjection * Core::Maths::lookAt(lightPos, lightPos + Core::Maths::vec3(0.f, -1.f, 0.f),
-			Core::Maths::vec3(0.f, 0.f, -1.f)));
-		shadowTransforms.push_back(shadowProjection * Core::Maths::lookAt(lightPos, lightPos + Core::Maths::vec3(0.f, 0.f, 1.f),
-			Core::Maths::vec3(0.f, -1.f, 0.f)));
-		shadowTransforms.push_back(shadowProjection * Core::Maths::lookAt(lightPos, lightPos + Core::Maths::vec3(0.f, 0.f, -1.f),
-			Core::Maths::vec3(0.f, -1.f, 0.f)));
+		// Six faces of this size take a bit more than a directional light
+		return 2048;
+	}
 
-		for (int i = 0; i < 6; i++)
-			program->setUniform("shadowMatrices[" + std::to_string(i) + "][0]", shadowTransforms[i].e, true, 1, 1);
+	bool ShadowPoint::isCaster(size_t pass, const ModelDraw& draw, float& depth) const
+	{
+		// Meshes that reach the range of the light, sorted by their distance to it
+		depth = (draw.bounds.center - matricesPosition).magnitude();
 
-		program->setUniform("farPlane", &farPlane, true);
-		program->setUniform("lightPos", &lightPos, true);
+		return depth - draw.bounds.radius <= farPlane;
+	}
+
+	uint64_t ShadowPoint::getPassHash(size_t pass) const
+	{
+		return Utils::hashBytes(&matricesPosition, sizeof(matricesPosition), emptyCastersHash);
 	}
 }
\ No newline at end of file
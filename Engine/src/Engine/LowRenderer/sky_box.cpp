@@ -31,10 +31,9 @@ namespace LowRenderer
 		Camera* cam = LowRenderer::RenderManager::getCurrentCamera();
 
 		Core::Maths::mat4 newView =  Core::Maths::toMat4(Core::Maths::toMat3(cam->getViewMatrix()));
-		m_shaderProgram->setUniform("viewProj", (cam->getProjection() * newView).e, true, 1, 1);
+		m_shaderProgram->setUniform(UniformIDs::viewProj, cam->getProjection() * newView);
 
-		m_shaderProgram->setSampler("cubemap", cubeMap->getID());
-		glActiveTexture(0);
+		m_shaderProgram->setSampler(UniformIDs::cubemap, cubeMap->getID());
 
 		cubeMesh->draw();
 
@@ -53,7 +52,7 @@ namespace LowRenderer
 		return strParse;
 	}
 
-	void SkyBox::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void SkyBox::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		std::vector<std::string> paths;
 		std::string curPath;
@@ -69,7 +68,6 @@ namespace LowRenderer
 
 	void SkyBox::sendToProgram(std::shared_ptr<Resources::ShaderProgram> program) const
 	{
-		program->setSampler("environmentMap", cubeMap->getID());
-		glActiveTexture(0);
+		program->setSampler(UniformIDs::environmentMap, cubeMap->getID());
 	}
 }
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "sprite_batch.hpp"
+
+#include <cstddef>
+
+// The rect pack implementation of ImGui is private to its own unit
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
+
+#include "sprite_renderer.hpp"
+#include "gl_state_cache.hpp"
+#include "texture.hpp"
+#include "shader.hpp"
+#include "uniform.hpp"
+#include "debug.hpp"
+
+namespace LowRenderer
+{
+	SpriteBatch::~SpriteBatch()
+	{
+		if (VBO)
+			glDeleteBuffers(1, &VBO);
+
+		if (VAO)
+			glDeleteVertexArrays(1, &VAO);
+
+		if (atlasID)
+			glDeleteTextures(1, &atlasID);
+	}
+
+	void SpriteBatch::createBuffers()
+	{
+		glGenVertexArrays(1, &VAO);
+		GLStateCache::bindVertexArray(VAO);
+
+		glGenBuffers(1, &VBO);
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, VBO);
+
+		GLsizei stride = sizeof(SpriteVertex);
+
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(SpriteVertex, position)));
+		glEnableVertexAttribArray(0);
+
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(SpriteVertex, texCoords)));
+		glEnableVertexAttribArray(1);
+
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(SpriteVertex, color)));
+		glEnableVertexAttribArray(2);
+
+		glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(SpriteVertex, region)));
+		glEnableVertexAttribArray(3);
+
+		// The atlas has no mipmap, the sprites are drawn close to the size of their textures
+		glGenTextures(1, &atlasID);
+		glBindTexture(GL_TEXTURE_2D, atlasID);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, atlasSize, atlasSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// The texture binding was changed behind the cache
+		GLStateCache::invalidate();
+	}
+
+	void SpriteBatch::packAtlas()
+	{
+		std::vector<stbrp_rect> rects;
+
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			AtlasEntry& entry = entries[i];
+
+			entry.isPacked = false;
+			entry.uploadCount = entry.texture->getUploadCount();
+			entry.width = entry.texture->getWidth();
+			entry.height = entry.texture->getHeight();
+
+			// The textures still being loaded are packed once they are uploaded
+			if (entry.uploadCount > 0u && entry.width > 0 && entry.height > 0)
+				rects.push_back({ (int)i, entry.width, entry.height });
+		}
+
+		std::vector<stbrp_node> nodes(atlasSize);
+
+		stbrp_context context;
+		stbrp_init_target(&context, atlasSize, atlasSize, nodes.data(), (int)nodes.size());
+
+		if (!stbrp_pack_rects(&context, rects.data(), (int)rects.size()))
+			Core::Debug::Log::warning("The sprite atlas is full, some sprites are drawn with their own texture");
+
+		for (const stbrp_rect& rect : rects)
+		{
+			if (!rect.was_packed)
+				continue;
+
+			AtlasEntry& entry = entries[rect.id];
+
+			entry.isPacked = true;
+			entry.x = rect.x;
+			entry.y = rect.y;
+
+			glCopyImageSubData(entry.texture->getID(), GL_TEXTURE_2D, 0, 0, 0, 0, atlasID, GL_TEXTURE_2D, 0, entry.x, entry.y, 0, entry.width, entry.height, 1);
+		}
+
+		isAtlasDirty = false;
+	}
+
+	void SpriteBatch::pruneEntries()
+	{
+		size_t entryCount = entries.size();
+
+		std::erase_if(entries, [](const AtlasEntry& entry) { return !entry.isUsed; });
+
+		for (AtlasEntry& entry : entries)
+			entry.isUsed = false;
+
+		if (entries.size() == entryCount)
+			return;
+
+		// Release the textures of the removed entries and pack the others again to reuse their place
+		entryIndices.clear();
+		for (size_t i = 0; i < entries.size(); i++)
+			entryIndices[entries[i].texture.get()] = i;
+
+		isAtlasDirty = true;
+	}
+
+	void SpriteBatch::begin()
+	{
+		quads.clear();
+	}
+
+	void SpriteBatch::addSprite(const SpriteRenderer& sprite)
+	{
+		std::shared_ptr<Resources::Texture> texture = sprite.getTexture();
+
+		if (!texture || !texture->getID())
+			texture = Resources::Texture::defaultDiffuse;
+
+		auto [indexIt, isNewEntry] = entryIndices.try_emplace(texture.get(), entries.size());
+
+		if (isNewEntry)
+		{
+			entries.push_back({ texture });
+			isAtlasDirty = true;
+		}
+
+		// A reloaded texture is copied again, at its new size
+		AtlasEntry& entry = entries[indexIt->second];
+		entry.isUsed = true;
+
+		if (entry.uploadCount != texture->getUploadCount() || entry.width != texture->getWidth() || entry.height != texture->getHeight())
+			isAtlasDirty = true;
+
+		SpriteQuad& quad = quads.emplace_back();
+		quad.entryIndex = indexIt->second;
+
+		sprite.addQuad(quad.vertices);
+	}
+
+	unsigned int SpriteBatch::draw(const std::shared_ptr<Resources::ShaderProgram>& program)
+	{
+		if (quads.empty())
+			return 0u;
+
+		if (!VAO)
+			createBuffers();
+		else
+		{
+			GLStateCache::bindVertexArray(VAO);
+			GLStateCache::bindBuffer(GL_ARRAY_BUFFER, VBO);
+		}
+
+		if (isAtlasDirty)
+			packAtlas();
+
+		const float texelSize = 1.f / (float)atlasSize;
+
+		for (SpriteQuad& quad : quads)
+		{
+			const AtlasEntry& entry = entries[quad.entryIndex];
+
+			Core::Maths::vec4 region(0.f, 0.f, 1.f, 1.f);
+			quad.textureID = entry.texture->getID();
+
+			if (entry.isPacked)
+			{
+				region = Core::Maths::vec4(entry.x * texelSize, entry.y * texelSize, entry.width * texelSize, entry.height * texelSize);
+				quad.textureID = atlasID;
+			}
+
+			for (SpriteVertex& vertex : quad.vertices)
+				vertex.region = region;
+		}
+
+		vertices.clear();
+		for (const SpriteQuad& quad : quads)
+			vertices.insert(vertices.end(), std::begin(quad.vertices), std::end(quad.vertices));
+
+		// Orphan the previous buffer and upload all the quads
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(SpriteVertex), vertices.data(), GL_STREAM_DRAW);
+
+		unsigned int drawCalls = 0u;
+
+		// Keep the order of the sprites for the blending, a batch ends where the bound texture changes
+		for (size_t first = 0; first < quads.size();)
+		{
+			size_t last = first + 1;
+			while (last < quads.size() && quads[last].textureID == quads[first].textureID)
+				last++;
+
+			program->setSampler(UniformIDs::diffuseTex, quads[first].textureID);
+			glDrawArrays(GL_TRIANGLES, (GLint)(first * 6u), (GLsizei)((last - first) * 6u));
+
+			drawCalls++;
+			first = last;
+		}
+
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, 0);
+		GLStateCache::bindVertexArray(0);
+
+		return drawCalls;
+	}
+
+	void SpriteBatch::clear()
+	{
+		quads.clear();
+		entries.clear();
+		entryIndices.clear();
+
+		isAtlasDirty = false;
+	}
+
+	size_t SpriteBatch::getSpriteCount() const
+	{
+		return quads.size();
+	}
+}
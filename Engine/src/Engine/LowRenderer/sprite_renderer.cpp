@@ -21,7 +21,6 @@ namespace LowRenderer
 	SpriteRenderer::SpriteRenderer(Engine::Entity& owner, const std::string& shaderProgramName, const Core::Maths::vec2& tilling)
 		: SpriteRenderer(owner, shaderProgramName)
 	{ 
-		mesh = Resources::ResourcesManager::getMeshByName("Plane");
 		texture = Resources::Texture::defaultDiffuse;
 
 		tillingMultiplier = tilling.x;
@@ -32,7 +31,6 @@ namespace LowRenderer
 		: SpriteRenderer(owner, shaderProgramName)
 	{
 		texture = Resources::ResourcesManager::loadTexture(texturePath);
-		mesh = Resources::ResourcesManager::getMeshByName("Plane");
 
 		tillingMultiplier = tilling.x;
 		tillingOffset = tilling.y;
@@ -50,21 +48,35 @@ namespace LowRenderer
 		return texture->getPath();
 	}
 
+	const std::shared_ptr<Resources::Texture>& SpriteRenderer::getTexture() const
+	{
+		return texture;
+	}
+
 	void SpriteRenderer::draw() const
 	{
-		if (!mesh)
-			return;
+		// Draw the sprite alone, the render manager batches the sprites of a program instead
+		LowRenderer::RenderManager::drawSpriteBatch(m_shaderProgram, { this });
+	}
 
-		m_shaderProgram->setUniform("model", m_transform->getGlobalModel().e, false, 1, 1);
-		m_shaderProgram->setUniform("color", m_color.e, false);
+	void SpriteRenderer::addQuad(SpriteVertex* vertices) const
+	{
+		// Corners of the plane mesh, with its texture coordinates
+		static constexpr float corners[6][2] = { { -1.f, -1.f }, { 1.f, -1.f }, { 1.f, 1.f }, { -1.f, -1.f }, { 1.f, 1.f }, { -1.f, 1.f } };
+
+		Core::Maths::mat4 model = m_transform->getGlobalModel();
 
-		m_shaderProgram->setUniform("tilling", Core::Maths::vec2(tillingMultiplier, tillingOffset).e, false);
+		for (int i = 0; i < 6; i++)
+		{
+			Core::Maths::vec4 position = model * Core::Maths::vec4(corners[i][0], corners[i][1], 0.f, 1.f);
 
-		if (texture)
-			if (!m_shaderProgram->setSampler("diffuseTex", texture->getID()))
-				m_shaderProgram->setSampler("diffuseTex", Resources::Texture::defaultDiffuse->getID());
+			float u = corners[i][0] * 0.5f + 0.5f;
+			float v = corners[i][1] * 0.5f + 0.5f;
 
-		mesh->draw();
+			vertices[i].position = position.xyz;
+			vertices[i].texCoords = Core::Maths::vec2(u * tillingMultiplier + tillingOffset, v * tillingMultiplier + tillingOffset);
+			vertices[i].color = m_color;
+		}
 	}
 
 	void SpriteRenderer::drawImGui()
@@ -99,7 +111,7 @@ namespace LowRenderer
 		return "COMP SPRITERENDERER " +  m_shaderProgram->getName() + " " + texture->getPath() + " " + std::to_string(tillingMultiplier) + " " + std::to_string(tillingOffset);
 	}
 
-	void SpriteRenderer::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void SpriteRenderer::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		std::string texturePath, shaderProgramName;
 		Core::Maths::vec2 tilling;
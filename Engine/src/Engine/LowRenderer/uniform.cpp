@@ -2,113 +2,58 @@
 
 #include <stdio.h>
 #include <string>
+#include <cstring>
+#include <unordered_map>
 
 namespace LowRenderer
 {
-	bool Uniform::bind(const void* value, int count, bool transpose) const
-	{
-        if (location < 0)
-            return false;
+#ifdef _DEBUG
+    // Names of the uniforms found in the programs, only read by the warnings
+    static std::unordered_map<UniformID, std::string> uniformNames;
+#endif
 
-        switch (type)
-        {
-        case GL_INT:
-        case GL_BOOL:
-        case GL_SAMPLER_2D:
-        case GL_SAMPLER_CUBE:
-            glUniform1iv(location, count, (GLint*)value);
-            return true;
-
-        case GL_INT_VEC2:
-        case GL_BOOL_VEC2:
-            glUniform2iv(location, count, (GLint*)value);
-            return true;
-
-        case GL_INT_VEC3:
-        case GL_BOOL_VEC3:
-            glUniform3iv(location, count, (GLint*)value);
-            return true;
-
-        case GL_INT_VEC4:
-        case GL_BOOL_VEC4:
-            glUniform4iv(location, count, (GLint*)value);
-            return true;
-
-        case GL_FLOAT:
-            glUniform1fv(location, count, (GLfloat*)value);
-            return true;
-
-        case GL_FLOAT_VEC2:
-            glUniform2fv(location, count, (GLfloat*)value);
-            return true;
-
-        case GL_FLOAT_VEC3:
-            glUniform3fv(location, count, (GLfloat*)value);
-            return true;
-
-        case GL_FLOAT_VEC4:
-            glUniform4fv(location, count, (GLfloat*)value);
-            return true;
-
-        case GL_FLOAT_MAT2:
-            glUniformMatrix2fv(location, count, transpose, (GLfloat*)value);
-            return true;
-
-        case GL_FLOAT_MAT3:
-            glUniformMatrix3fv(location, count, transpose, (GLfloat*)value);
-            return true;
-
-        case GL_FLOAT_MAT4:
-            glUniformMatrix4fv(location, count, transpose, (GLfloat*)value);
-            return true;
-
-        default:
-            // return false if the type is not supported
-            return false;
-        }
-	}
-
-    Uniform::Uniform(GLint location, GLenum type)
-        : location(location), type(type)
+    void registerUniformName(UniformID ID, const std::string& name)
     {
-
+#ifdef _DEBUG
+        uniformNames[ID] = name;
+#endif
     }
 
-    bool Uniform::areSame(const void* value)
+    std::string getUniformName(UniformID ID)
     {
-        return currentValue == value || memcmp(currentValue, value, typeSize);
+#ifdef _DEBUG
+        auto nameIt = uniformNames.find(ID);
+
+        if (nameIt != uniformNames.end())
+            return nameIt->second;
+#endif
+
+        return "ID " + std::to_string(ID);
     }
 
-    UniformBlock::UniformBlock(GLuint bindingPoint, GLsizei UBOsize)
-        : bindingPoint(bindingPoint)
+    Uniform::Uniform(GLint location, GLenum type)
+        : location(location), type(type)
     {
-        glGenBuffers(1, &UBO);
 
-        // TODO: REMOVE THIS SHIT
-        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
-        glBufferData(GL_UNIFORM_BUFFER, UBOsize, NULL, GL_STATIC_DRAW);
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
-        
-        glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, UBO, 0, UBOsize);
     }
 
-    UniformBlock::~UniformBlock()
+    GLint Uniform::getLocation() const
     {
-        glDeleteBuffers(1, &UBO);
+        return location;
     }
 
-    void UniformBlock::bind()
+    GLenum Uniform::getType() const
     {
-        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+        return type;
     }
 
-    void UniformBlock::unbind()
+    bool Uniform::areSame(const void* value, size_t size) const
     {
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        return currentValue.size() == size && memcmp(currentValue.data(), value, size) == 0;
     }
 
-    GLuint UniformBlock::getBindingPoint() const
+    void Uniform::resetValue() const
     {
-        return bindingPoint;
+        currentValue.clear();
     }
 }
\ No newline at end of file
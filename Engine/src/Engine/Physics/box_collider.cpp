@@ -14,7 +14,7 @@ namespace Physics
 		: Collider(owner)
 	{
 		PhysicManager::linkComponent(this);
-		owner.addComponent<LowRenderer::ColliderRenderer>(this, "resources/obj/colliders/boxCollider.obj");
+		owner.addComponent<LowRenderer::ColliderRenderer>(this);
 	}
 
 	void BoxCollider::updateShape()
@@ -52,7 +52,7 @@ namespace Physics
 									 std::to_string(box.offsetRounding) + " " + std::to_string(isTrigger);
 	}
 
-	void BoxCollider::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void BoxCollider::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		BoxCollider* collider;
 		if (!owner.tryGetComponent(collider))
@@ -1,10 +1,11 @@
 #include "collider.hpp"
 
-#include "imGui.h"
+#include "imgui.h"
 
 #include <algorithm>
 
 #include "debug.hpp"
+#include "debug_draw.hpp"
 
 #include "utils.hpp"
 
@@ -79,6 +80,12 @@ namespace Physics
 		}
 	}
 
+	void Collider::drawContacts() const
+	{
+		for (const auto& [collider, collision] : m_colliders)
+			LowRenderer::DebugDraw::contact(collision.hit.point, collision.hit.normal, CONTACT_COLOR);
+	}
+
 	void Collider::drawImGui()
 	{
 		Component::drawImGui();
@@ -9,6 +9,7 @@
 #include "intersection.h"
 #include "utils.hpp"
 #include "collision.hpp"
+#include "debug_draw.hpp"
 
 namespace Physics
 {
@@ -262,5 +263,18 @@ namespace Physics
 
 			PM->computeCollisions();
 		}
+
+		// Show the contacts of the drawn colliders, the debug lines are removed after each frame
+		for (auto& sphereCollider : PM->sphereColliders)
+		{
+			if (sphereCollider->isActive() && sphereCollider->isDraw)
+				sphereCollider->drawContacts();
+		}
+
+		for (auto& boxCollider : PM->boxColliders)
+		{
+			if (boxCollider->isActive() && boxCollider->isDraw)
+				boxCollider->drawContacts();
+		}
 	}
 }
\ No newline at end of file
@@ -83,7 +83,7 @@ namespace Physics
 								   std::to_string(mass) + " " + std::to_string(drag) + " " + std::to_string(isAwake);
 	}
 
-	void Rigidbody::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void Rigidbody::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		Rigidbody* rb;
 		if (!owner.tryGetComponent(rb))
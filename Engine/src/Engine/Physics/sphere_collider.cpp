@@ -16,7 +16,7 @@ namespace Physics
 		sphere = Sphere(vec3(0.f), 1.f);
 
 		PhysicManager::linkComponent(this);
-		owner.addComponent<LowRenderer::ColliderRenderer>(this, "resources/obj/colliders/sphereCollider.obj");
+		owner.addComponent<LowRenderer::ColliderRenderer>(this);
 	}
 
 	void SphereCollider::updateShape()
@@ -56,7 +56,7 @@ namespace Physics
 										Utils::quatToStringParsing(sphere.quaternion) + std::to_string(isTrigger);
 	}
 
-	void SphereCollider::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void SphereCollider::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		SphereCollider* collider;
 		if (!owner.tryGetComponent(collider))
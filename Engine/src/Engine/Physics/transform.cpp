@@ -209,7 +209,7 @@ namespace Physics
 									Utils::vecToStringParsing(scale) + (parent ? parent->getHost().m_name : "none");
 	}
 
-	void TransformComponent::parseComponent(Engine::Entity& owner, std::istringstream& iss, std::string& parentName)
+	void TransformComponent::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss, std::string& parentName)
 	{
 		TransformComponent* transform;
 		if (!owner.tryGetComponent(transform))
@@ -102,7 +102,7 @@ namespace UI
 		return "COMP BUTTON " + m_image->getProgram()->getName() + " " + m_image->getTexturePath();
 	}
 
-	void Button::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void Button::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		std::string shaderProgramName, texturePath;
 
@@ -0,0 +1,101 @@
+#include "component_reader.hpp"
+
+#include <cstring>
+
+namespace Engine
+{
+	ComponentReader::ComponentReader(std::istringstream& stream)
+		: stream(&stream)
+	{
+
+	}
+
+	ComponentReader::ComponentReader(const uint32_t* words, size_t wordCount, const std::vector<std::string>& strings)
+		: words(words), wordsEnd(words + wordCount), strings(&strings)
+	{
+
+	}
+
+	bool ComponentReader::readWord(uint32_t& word)
+	{
+		if (words == wordsEnd)
+			return false;
+
+		word = *words++;
+
+		return true;
+	}
+
+	ComponentReader& ComponentReader::operator>>(float& value)
+	{
+		if (stream)
+		{
+			*stream >> value;
+			return *this;
+		}
+
+		// The floats are stored by their bits
+		uint32_t word;
+		if (readWord(word))
+			std::memcpy(&value, &word, sizeof(value));
+
+		return *this;
+	}
+
+	ComponentReader& ComponentReader::operator>>(int& value)
+	{
+		if (stream)
+		{
+			*stream >> value;
+			return *this;
+		}
+
+		uint32_t word;
+		if (readWord(word))
+			value = (int)word;
+
+		return *this;
+	}
+
+	ComponentReader& ComponentReader::operator>>(bool& value)
+	{
+		if (stream)
+		{
+			*stream >> value;
+			return *this;
+		}
+
+		uint32_t word;
+		if (readWord(word))
+			value = word != 0u;
+
+		return *this;
+	}
+
+	ComponentReader& ComponentReader::operator>>(std::string& value)
+	{
+		if (stream)
+		{
+			*stream >> value;
+			return *this;
+		}
+
+		// The strings are stored by their index in the table of the scene
+		uint32_t word;
+		if (readWord(word))
+			value = (*strings)[word];
+
+		return *this;
+	}
+
+	void ComponentReader::readLine(std::string& line)
+	{
+		if (stream)
+		{
+			std::getline(*stream >> std::ws, line);
+			return;
+		}
+
+		*this >> line;
+	}
+}
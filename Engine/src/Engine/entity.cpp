@@ -31,6 +31,7 @@
 #include "transform.hpp"
 #include "rigidbody.hpp"
 #include "life_bar.hpp"
+#include "character.hpp"
 #include "sky_box.hpp"
 #include "button.hpp"
 #include "medkit.hpp"
@@ -171,6 +172,9 @@ namespace Engine
 		if (m_recipe != "")
 			entityParse += "RECIPE " + m_recipe + '\n';
 
+		if (isStatic)
+			entityParse += "STATIC\n";
+
 		for (auto& componentPair : m_components)
 		{
 			Component* component = componentPair.second.get();
@@ -190,6 +194,8 @@ namespace Engine
 		if (ImGui::Checkbox("Enable", &activated))
 			setActive(activated);
 
+		ImGui::Checkbox("Static", &isStatic);
+
 		if (ImGui::Button("Destroy"))
 			destroy();
 
@@ -252,67 +258,149 @@ namespace Engine
 			Utils::selectImGuiString(m_name, curEntityName);
 	}
 
+	ComponentType Entity::getComponentType(const std::string& typeName)
+	{
+		static const std::unordered_map<std::string, ComponentType> componentTypes =
+		{
+			{ "TRANSFORM", ComponentType::TRANSFORM },
+			{ "RIGIDBODY", ComponentType::RIGIDBODY },
+			{ "BOXCOLLIDER", ComponentType::BOXCOLLIDER },
+			{ "SPHERECOLLIDER", ComponentType::SPHERECOLLIDER },
+			{ "MODELRENDERER", ComponentType::MODELRENDERER },
+			{ "CAMERA", ComponentType::CAMERA },
+			{ "LIGHT", ComponentType::LIGHT },
+			{ "SKYBOX", ComponentType::SKYBOX },
+			{ "SPRITERENDERER", ComponentType::SPRITERENDERER },
+			{ "TEXT", ComponentType::TEXT },
+			{ "PLAYERMOVEMENT", ComponentType::PLAYERMOVEMENT },
+			{ "PLAYERSTATE", ComponentType::PLAYERSTATE },
+			{ "PLAYERLIFE", ComponentType::PLAYERLIFE },
+			{ "PLAYERSHOOTING", ComponentType::PLAYERSHOOTING },
+			{ "ENEMYMOVEMENT", ComponentType::ENEMYMOVEMENT },
+			{ "ENEMYSTATE", ComponentType::ENEMYSTATE },
+			{ "ENEMYLIFE", ComponentType::ENEMYLIFE },
+			{ "LIFEBAR", ComponentType::LIFEBAR },
+			{ "AMMOCOUNTER", ComponentType::AMMOCOUNTER },
+			{ "MAINMENU", ComponentType::MAINMENU },
+			{ "LOSESCREEN", ComponentType::LOSESCREEN },
+			{ "WINSCREEN", ComponentType::WINSCREEN },
+			{ "PAUSESCREEN", ComponentType::PAUSESCREEN },
+			{ "GAMEMASTER", ComponentType::GAMEMASTER },
+			{ "CAMERAMOVEMENT", ComponentType::CAMERAMOVEMENT },
+			{ "BUTTON", ComponentType::BUTTON },
+			{ "BULLETHOLE", ComponentType::BULLETHOLE },
+			{ "NOCLIPMOVEMENT", ComponentType::NOCLIPMOVEMENT },
+			{ "MEDKIT", ComponentType::MEDKIT }
+		};
+
+		auto typeIt = componentTypes.find(typeName);
+
+		return typeIt != componentTypes.end() ? typeIt->second : ComponentType::NONE;
+	}
+
+	void Entity::parseComponent(ComponentType type, ComponentReader& iss, std::string& parentName)
+	{
+		switch (type)
+		{
+		case ComponentType::TRANSFORM:
+			Physics::TransformComponent::parseComponent(*this, iss, parentName);
+			break;
+		case ComponentType::RIGIDBODY:
+			Physics::Rigidbody::parseComponent(*this, iss);
+			break;
+		case ComponentType::BOXCOLLIDER:
+			Physics::BoxCollider::parseComponent(*this, iss);
+			break;
+		case ComponentType::SPHERECOLLIDER:
+			Physics::SphereCollider::parseComponent(*this, iss);
+			break;
+		case ComponentType::MODELRENDERER:
+			LowRenderer::ModelRenderer::parseComponent(*this, iss);
+			break;
+		case ComponentType::CAMERA:
+			LowRenderer::Camera::parseComponent(*this, iss);
+			break;
+		case ComponentType::LIGHT:
+			LowRenderer::Light::parseComponent(*this, iss);
+			break;
+		case ComponentType::SKYBOX:
+			LowRenderer::SkyBox::parseComponent(*this, iss);
+			break;
+		case ComponentType::SPRITERENDERER:
+			LowRenderer::SpriteRenderer::parseComponent(*this, iss);
+			break;
+		case ComponentType::TEXT:
+			Resources::Text::parseComponent(*this, iss);
+			break;
+		case ComponentType::PLAYERMOVEMENT:
+			Gameplay::PlayerMovement::parseComponent(*this, iss);
+			break;
+		case ComponentType::PLAYERSTATE:
+			Gameplay::PlayerState::parseComponent(*this, iss);
+			break;
+		case ComponentType::PLAYERLIFE:
+			Gameplay::PlayerLife::parseComponent(*this, iss);
+			break;
+		case ComponentType::PLAYERSHOOTING:
+			Gameplay::PlayerShooting::parseComponent(*this, iss);
+			break;
+		case ComponentType::ENEMYMOVEMENT:
+			Gameplay::EnemyMovement::parseComponent(*this, iss);
+			break;
+		case ComponentType::ENEMYSTATE:
+			Gameplay::EnemyState::parseComponent(*this, iss);
+			break;
+		case ComponentType::ENEMYLIFE:
+			Gameplay::EnemyLife::parseComponent(*this, iss);
+			break;
+		case ComponentType::LIFEBAR:
+			Gameplay::LifeBar::parseComponent(*this, iss);
+			break;
+		case ComponentType::AMMOCOUNTER:
+			Gameplay::AmmoCounter::parseComponent(*this, iss);
+			break;
+		case ComponentType::MAINMENU:
+			Gameplay::MainMenu::parseComponent(*this, iss);
+			break;
+		case ComponentType::LOSESCREEN:
+			Gameplay::LoseScreen::parseComponent(*this, iss);
+			break;
+		case ComponentType::WINSCREEN:
+			Gameplay::WinScreen::parseComponent(*this, iss);
+			break;
+		case ComponentType::PAUSESCREEN:
+			Gameplay::PauseScreen::parseComponent(*this, iss);
+			break;
+		case ComponentType::GAMEMASTER:
+			Gameplay::GameMaster::parseComponent(*this, iss);
+			break;
+		case ComponentType::CAMERAMOVEMENT:
+			Gameplay::CameraMovement::parseComponent(*this, iss);
+			break;
+		case ComponentType::BUTTON:
+			UI::Button::parseComponent(*this, iss);
+			break;
+		case ComponentType::BULLETHOLE:
+			Gameplay::BulletHole::parseComponent(*this, iss);
+			break;
+		case ComponentType::NOCLIPMOVEMENT:
+			NoClipMovement::parseComponent(*this, iss);
+			break;
+		case ComponentType::MEDKIT:
+			Gameplay::MedKit::parseComponent(*this, iss);
+			break;
+		default:
+			break;
+		}
+	}
+
 	void Entity::parseComponents(std::istringstream& entityStream, std::string& parentName)
 	{
 		std::string comp;
 		entityStream >> comp;
 
-		if (comp == "TRANSFORM")
-			Physics::TransformComponent::parseComponent(*this, entityStream, parentName);
-		else if (comp == "RIGIDBODY")
-			Physics::Rigidbody::parseComponent(*this, entityStream);
-		else if (comp == "BOXCOLLIDER")
-			Physics::BoxCollider::parseComponent(*this, entityStream);
-		else if (comp == "SPHERECOLLIDER")
-			Physics::SphereCollider::parseComponent(*this, entityStream);
-		else if (comp == "MODELRENDERER")
-			LowRenderer::ModelRenderer::parseComponent(*this, entityStream);
-		else if (comp == "CAMERA")
-			LowRenderer::Camera::parseComponent(*this, entityStream);
-		else if (comp == "LIGHT")
-			LowRenderer::Light::parseComponent(*this, entityStream);
-		else if (comp == "SKYBOX")
-			LowRenderer::SkyBox::parseComponent(*this, entityStream);
-		else if (comp == "SPRITERENDERER")
-			LowRenderer::SpriteRenderer::parseComponent(*this, entityStream);
-		else if (comp == "PLAYERMOVEMENT")
-			Gameplay::PlayerMovement::parseComponent(*this, entityStream);
-		else if (comp == "PLAYERSTATE")
-			Gameplay::PlayerState::parseComponent(*this, entityStream);
-		else if (comp == "PLAYERLIFE")
-			Gameplay::PlayerLife::parseComponent(*this, entityStream);
-		else if (comp == "PLAYERSHOOTING")
-			Gameplay::PlayerShooting::parseComponent(*this, entityStream);
-		else if (comp == "ENEMYMOVEMENT")
-			Gameplay::EnemyMovement::parseComponent(*this, entityStream);
-		else if (comp == "ENEMYSTATE")
-			Gameplay::EnemyState::parseComponent(*this, entityStream);
-		else if (comp == "ENEMYLIFE")
-			Gameplay::EnemyLife::parseComponent(*this, entityStream);
-		else if (comp == "LIFEBAR")
-			Gameplay::LifeBar::parseComponent(*this, entityStream);
-		else if (comp == "AMMOCOUNTER")
-			Gameplay::AmmoCounter::parseComponent(*this, entityStream);
-		else if (comp == "MAINMENU")
-			Gameplay::MainMenu::parseComponent(*this, entityStream);
-		else if (comp == "LOSESCREEN")
-			Gameplay::LoseScreen::parseComponent(*this, entityStream);
-		else if (comp == "WINSCREEN")
-			Gameplay::WinScreen::parseComponent(*this, entityStream);
-		else if (comp == "PAUSESCREEN")
-			Gameplay::PauseScreen::parseComponent(*this, entityStream);
-		else if (comp == "GAMEMASTER")
-			Gameplay::GameMaster::parseComponent(*this, entityStream);
-		else if (comp == "CAMERAMOVEMENT")
-			Gameplay::CameraMovement::parseComponent(*this, entityStream);
-		else if (comp == "BUTTON")
-			UI::Button::parseComponent(*this, entityStream);
-		else if (comp == "BULLETHOLE")
-			Gameplay::BulletHole::parseComponent(*this, entityStream);
-		else if (comp == "NOCLIPMOVEMENT")
-			NoClipMovement::parseComponent(*this, entityStream);
-		else if (comp == "MEDKIT")
-			Gameplay::MedKit::parseComponent(*this, entityStream);
+		ComponentReader reader(entityStream);
+		parseComponent(getComponentType(comp), reader, parentName);
 	}
 
 	void Entity::parseRecipe(const std::string& filePath, std::string& parentName)
@@ -353,6 +441,8 @@ namespace Engine
 				iss >> filePath;
 				parseRecipe(filePath, parentName);
 			}
+			else if (type == "STATIC")
+				isStatic = true;
 			else if (type == "endGO")
 				break;
 		}
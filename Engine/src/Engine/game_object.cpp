@@ -215,62 +215,64 @@ namespace Engine
 		std::string comp;
 		goStream >> comp;
 
+		Engine::ComponentReader reader(goStream);
+
 		if (comp == "TRANSFORM")
-			Physics::Transform::parseComponent(*this, goStream, parentName);
+			Physics::Transform::parseComponent(*this, reader, parentName);
 		else if (comp == "RIGIDBODY")
-			Physics::Rigidbody::parseComponent(*this, goStream);
+			Physics::Rigidbody::parseComponent(*this, reader);
 		else if (comp == "BOXCOLLIDER")
-			Physics::BoxCollider::parseComponent(*this, goStream);
+			Physics::BoxCollider::parseComponent(*this, reader);
 		else if (comp == "SPHERECOLLIDER")
-			Physics::SphereCollider::parseComponent(*this, goStream);
+			Physics::SphereCollider::parseComponent(*this, reader);
 		else if (comp == "MODELRENDERER")
-			LowRenderer::ModelRenderer::parseComponent(*this, goStream);
+			LowRenderer::ModelRenderer::parseComponent(*this, reader);
 		else if (comp == "CAMERA")
-			LowRenderer::Camera::parseComponent(*this, goStream);
+			LowRenderer::Camera::parseComponent(*this, reader);
 		else if (comp == "LIGHT")
-			LowRenderer::Light::parseComponent(*this, goStream);
+			LowRenderer::Light::parseComponent(*this, reader);
 		else if (comp == "SKYBOX")
-			LowRenderer::SkyBox::parseComponent(*this, goStream);
+			LowRenderer::SkyBox::parseComponent(*this, reader);
 		else if (comp == "SPRITERENDERER")
-			LowRenderer::SpriteRenderer::parseComponent(*this, goStream);
+			LowRenderer::SpriteRenderer::parseComponent(*this, reader);
 		else if (comp == "PLAYERMOVEMENT")
-			Gameplay::PlayerMovement::parseComponent(*this, goStream);
+			Gameplay::PlayerMovement::parseComponent(*this, reader);
 		else if (comp == "PLAYERSTATE")
-			Gameplay::PlayerState::parseComponent(*this, goStream);
+			Gameplay::PlayerState::parseComponent(*this, reader);
 		else if (comp == "PLAYERLIFE")
-			Gameplay::PlayerLife::parseComponent(*this, goStream);
+			Gameplay::PlayerLife::parseComponent(*this, reader);
 		else if (comp == "PLAYERSHOOTING")
-			Gameplay::PlayerShooting::parseComponent(*this, goStream);
+			Gameplay::PlayerShooting::parseComponent(*this, reader);
 		else if (comp == "ENEMYMOVEMENT")
-			Gameplay::EnemyMovement::parseComponent(*this, goStream);
+			Gameplay::EnemyMovement::parseComponent(*this, reader);
 		else if (comp == "ENEMYSTATE")
-			Gameplay::EnemyState::parseComponent(*this, goStream);
+			Gameplay::EnemyState::parseComponent(*this, reader);
 		else if (comp == "ENEMYLIFE")
-			Gameplay::EnemyLife::parseComponent(*this, goStream);
+			Gameplay::EnemyLife::parseComponent(*this, reader);
 		else if (comp == "LIFEBAR")
-			Gameplay::LifeBar::parseComponent(*this, goStream);
+			Gameplay::LifeBar::parseComponent(*this, reader);
 		else if (comp == "AMMOCOUNTER")
-			Gameplay::AmmoCounter::parseComponent(*this, goStream);
+			Gameplay::AmmoCounter::parseComponent(*this, reader);
 		else if (comp == "PAUSESCREEN")
-			Gameplay::PauseScreen::parseComponent(*this, goStream);
+			Gameplay::PauseScreen::parseComponent(*this, reader);
 		else if (comp == "MAINMENU")
-			Gameplay::MainMenu::parseComponent(*this, goStream);		
+			Gameplay::MainMenu::parseComponent(*this, reader);		
 		else if (comp == "LOSESCREEN")
-			Gameplay::LoseScreen::parseComponent(*this, goStream);
+			Gameplay::LoseScreen::parseComponent(*this, reader);
 		else if (comp == "WINSCREEN")
-			Gameplay::WinScreen::parseComponent(*this, goStream);
+			Gameplay::WinScreen::parseComponent(*this, reader);
 		else if (comp == "PAUSESCREEN")
-			Gameplay::PauseScreen::parseComponent(*this, goStream);
+			Gameplay::PauseScreen::parseComponent(*this, reader);
 		else if (comp == "GAMEMASTER")
-			Gameplay::GameMaster::parseComponent(*this, goStream);
+			Gameplay::GameMaster::parseComponent(*this, reader);
 		else if (comp == "CAMERAMOVEMENT")
-			Gameplay::CameraMovement::parseComponent(*this, goStream);
+			Gameplay::CameraMovement::parseComponent(*this, reader);
 		else if (comp == "BUTTON")
-			UI::Button::parseComponent(*this, goStream);
+			UI::Button::parseComponent(*this, reader);
 		else if (comp == "BULLETHOLE")
-			Gameplay::BulletHole::parseComponent(*this, goStream);
+			Gameplay::BulletHole::parseComponent(*this, reader);
 		else if (comp == "MEDKIT")
-			Gameplay::MedKit::parseComponent(*this, goStream);
+			Gameplay::MedKit::parseComponent(*this, reader);
 	}
 
 	void GameObject::parseScripts(std::istringstream& parseScript)
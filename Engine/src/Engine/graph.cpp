@@ -7,6 +7,7 @@
 #include "render_manager.hpp"
 #include "thread_manager.hpp"
 #include "application.hpp"
+#include "binary_scene.hpp"
 #include "debug.hpp"
 #include "time.hpp"
 
@@ -31,7 +32,8 @@ namespace Core::Engine
 
 	void Graph::loadScene(const std::string& scenePath, bool wipeAll)
 	{
-		Multithread::ThreadManager::syncAndClean("load");
+		// Cancel the loading of the previous scene instead of waiting for it
+		Resources::ResourcesManager::cancelLoading();
 
 		LowRenderer::RenderManager::clearAll();
 		Physics::PhysicManager::clearAll();
@@ -42,6 +44,8 @@ namespace Core::Engine
 
 		if (wipeAll)
 			Resources::ResourcesManager::purgeResources();
+		else
+			Resources::ResourcesManager::purgeCancelledResources();
 
 		curScene.load(scenePath);
 
@@ -121,6 +125,11 @@ namespace Core::Engine
 			if (ImGui::Button("Wipe current scene"))
 				reloadScene(true);
 
+			const std::string& scenePath = graph->curScene.filePath;
+
+			if (!Resources::BinaryScene::isBinaryScene(scenePath) && ImGui::Button("Convert current scene to binary"))
+				Resources::BinaryScene::convert(scenePath, Resources::BinaryScene::getBinaryPath(scenePath));
+
 			if (ImGui::CollapsingHeader("Hierarchy"))
 				graph->curScene.drawHierarchy();
 		}
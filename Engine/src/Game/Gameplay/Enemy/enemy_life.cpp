@@ -27,7 +27,7 @@ namespace Gameplay
 		return "COMP ENEMYLIFE " + EntityLife::toString();
 	}
 
-	void EnemyLife::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void EnemyLife::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		EnemyLife* el;
 		if (!owner.tryGetComponent(el))
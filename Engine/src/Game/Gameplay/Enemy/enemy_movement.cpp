@@ -54,7 +54,7 @@ namespace Gameplay
 		return "COMP ENEMYMOVEMENT " + std::to_string(m_speed);
 	}
 
-	void EnemyMovement::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void EnemyMovement::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		EnemyMovement* em;
 		if (!owner.tryGetComponent(em))
@@ -76,7 +76,7 @@ namespace Gameplay
 			+ " " + std::to_string(isGrounded);
 	}
 
-	void EnemyState::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void EnemyState::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		EnemyState* es;
 		if (!owner.tryGetComponent(es))
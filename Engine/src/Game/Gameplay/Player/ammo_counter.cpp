@@ -88,7 +88,7 @@ namespace Gameplay
 		return "COMP AMMOCOUNTER ";
 	}
 
-	void AmmoCounter::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void AmmoCounter::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		AmmoCounter* ac;
 		if (!owner.tryGetComponent(ac))
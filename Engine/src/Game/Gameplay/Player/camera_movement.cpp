@@ -51,7 +51,7 @@ namespace Gameplay
 		return "COMP CAMERAMOVEMENT " + std::to_string(m_sensitivity);
 	}
 
-	void CameraMovement::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void CameraMovement::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		owner.addComponent<CameraMovement>();
 		auto player = owner.getComponent<CameraMovement>();
@@ -33,7 +33,7 @@ namespace Gameplay
 		return "COMP PLAYERLIFE " + EntityLife::toString() + " " + lifeBarName;
 	}
 
-	void PlayerLife::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void PlayerLife::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		PlayerLife* pl;
 		if (!owner.tryGetComponent(pl))
@@ -52,7 +52,7 @@ namespace Gameplay
 		return "COMP PLAYERMOVEMENT " + std::to_string(m_speed) + " " + std::to_string(m_jumpForce) + " " + std::to_string(m_sensivityY);
 	}
 
-	void PlayerMovement::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void PlayerMovement::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		PlayerMovement* player;
 		if (!owner.tryGetComponent(player))
@@ -150,7 +150,7 @@ namespace Gameplay
 		}
 	}
 
-	void PlayerShooting::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void PlayerShooting::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		PlayerShooting* ps;
 		if (!owner.tryGetComponent(ps))
@@ -61,7 +61,7 @@ namespace Gameplay
 			+ " " + std::to_string(isGrounded);
 	}
 
-	void PlayerState::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void PlayerState::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		if (!owner.tryGetComponent<PlayerState>())
 			owner.addComponent<PlayerState>();
@@ -21,7 +21,7 @@ namespace Gameplay
 			getHost().destroy();
 	}
 
-	void BulletHole::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void BulletHole::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		BulletHole* bulletHole;
 		if (!owner.tryGetComponent(bulletHole))
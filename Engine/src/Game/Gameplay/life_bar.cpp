@@ -32,7 +32,7 @@ namespace Gameplay
 		return "COMP LIFEBAR ";
 	}
 
-	void LifeBar::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void LifeBar::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		LifeBar* lb;
 		if (!owner.tryGetComponent(lb))
@@ -39,7 +39,7 @@ namespace Gameplay
 		return "COMP MEDKIT " + std::to_string(healCount);
 	}
 
-	void MedKit::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void MedKit::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		MedKit* mk;
 		if (!owner.tryGetComponent(mk))
@@ -80,7 +80,7 @@ namespace Gameplay
 		return "COMP GAMEMASTER";
 	}
 
-	void GameMaster::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void GameMaster::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		if (!owner.tryGetComponent<GameMaster>())
 			owner.addComponent<GameMaster>();
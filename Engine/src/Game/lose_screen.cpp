@@ -66,7 +66,7 @@ namespace Gameplay
 		return "COMP LOSESCREEN";
 	}
 
-	void LoseScreen::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void LoseScreen::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		if (!owner.tryGetComponent<LoseScreen>())
 			owner.addComponent<LoseScreen>();
@@ -58,7 +58,7 @@ namespace Gameplay
 		return "COMP MAINMENU";
 	}
 
-	void MainMenu::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void MainMenu::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		if (!owner.tryGetComponent<MainMenu>())
 			owner.addComponent<MainMenu>();
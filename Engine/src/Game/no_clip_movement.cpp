@@ -44,7 +44,7 @@ void NoClipMovement::fixedUpdate()
 	m_transform->position = m_transform->position + Core::Maths::vec3(horizontal * cos + vertical * sin, verticalMove, vertical * cos - horizontal * sin).normalized() * fixedSpeed;
 }
 
-void NoClipMovement::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+void NoClipMovement::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 {
 	NoClipMovement* movement;
 	if (!owner.tryGetComponent(movement))
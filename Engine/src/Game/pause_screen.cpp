@@ -94,7 +94,7 @@ namespace Gameplay
 		return "COMP PAUSESCREEN";
 	}
 
-	void PauseScreen::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void PauseScreen::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		if (!owner.tryGetComponent<PauseScreen>())
 			owner.addComponent<PauseScreen>();
@@ -67,7 +67,7 @@ namespace Gameplay
 		return "COMP WINSCREEN";
 	}
 
-	void WinScreen::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void WinScreen::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
 		if (!owner.tryGetComponent<WinScreen>())
 			owner.addComponent<WinScreen>();
@@ -0,0 +1,597 @@
+#include "binary_scene.hpp"
+
+#include <sstream>
+#include <fstream>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+#include "resources_manager.hpp"
+#include "benchmarker.hpp"
+#include "entity.hpp"
+#include "recipe.hpp"
+#include "scene.hpp"
+#include "debug.hpp"
+
+namespace Resources
+{
+	const std::string BinaryScene::extension = ".scnb";
+
+	// Arguments of a component in the order its parser reads them: f float, i int, b bool, s string, l rest of the line
+	const char* getComponentLayout(Engine::ComponentType type)
+	{
+		switch (type)
+		{
+		case Engine::ComponentType::TRANSFORM:		return "fffffffffs";
+		case Engine::ComponentType::RIGIDBODY:		return "ffffffffb";
+		case Engine::ComponentType::BOXCOLLIDER:	return "fffffffffffb";
+		case Engine::ComponentType::SPHERECOLLIDER:	return "ffffffffb";
+		case Engine::ComponentType::MODELRENDERER:	return "ssff";
+		case Engine::ComponentType::CAMERA:			return "fff";
+		case Engine::ComponentType::LIGHT:			return "ffffffffffffffffffffffb";
+		case Engine::ComponentType::SKYBOX:			return "ssssss";
+		case Engine::ComponentType::SPRITERENDERER:	return "ssff";
+		case Engine::ComponentType::TEXT:			return "sibfffffffl";
+		case Engine::ComponentType::PLAYERMOVEMENT:	return "fff";
+		case Engine::ComponentType::PLAYERSTATE:	return "bbbbb";
+		case Engine::ComponentType::PLAYERLIFE:		return "iis";
+		case Engine::ComponentType::ENEMYMOVEMENT:	return "f";
+		case Engine::ComponentType::ENEMYSTATE:		return "bbbb";
+		case Engine::ComponentType::ENEMYLIFE:		return "ii";
+		case Engine::ComponentType::CAMERAMOVEMENT:	return "f";
+		case Engine::ComponentType::BUTTON:			return "ss";
+		case Engine::ComponentType::MEDKIT:			return "i";
+		case Engine::ComponentType::NONE:			return nullptr;
+		default:									return "";
+		}
+	}
+
+	uint32_t floatToWord(float value)
+	{
+		uint32_t word;
+		std::memcpy(&word, &value, sizeof(word));
+
+		return word;
+	}
+
+	// Build the tables of a binary scene from the text format
+	class BinarySceneWriter
+	{
+	private:
+		std::unordered_map<std::string, uint32_t> stringIndices;
+		std::unordered_map<std::string, uint32_t> recipeIndices;
+
+	public:
+		BinarySceneData data;
+
+		uint32_t addString(const std::string& str)
+		{
+			auto stringIt = stringIndices.find(str);
+			if (stringIt != stringIndices.end())
+				return stringIt->second;
+
+			uint32_t stringIndex = (uint32_t)data.strings.size();
+
+			data.strings.push_back(str);
+			stringIndices[str] = stringIndex;
+
+			return stringIndex;
+		}
+
+		bool addComponent(std::istringstream& iss, std::vector<BinaryComponent>& components)
+		{
+			std::string typeName;
+			iss >> typeName;
+
+			Engine::ComponentType type = Engine::Entity::getComponentType(typeName);
+
+			if (type == Engine::ComponentType::NONE)
+			{
+				Core::Debug::Log::warning("Unknown component " + typeName + ", it will not be converted");
+				return false;
+			}
+
+			BinaryComponent component;
+			component.type = (uint16_t)type;
+			component.firstWord = (uint32_t)data.words.size();
+
+			// Read the arguments with their own types, the missing ones at the end keep the defaults of the component
+			for (const char* kind = getComponentLayout(type); *kind != '\0'; kind++)
+			{
+				uint32_t word = 0u;
+
+				if (*kind == 'f')
+				{
+					float value;
+					if (!(iss >> value))
+						break;
+
+					word = floatToWord(value);
+				}
+				else if (*kind == 'i')
+				{
+					int value;
+					if (!(iss >> value))
+						break;
+
+					word = (uint32_t)value;
+				}
+				else if (*kind == 'b')
+				{
+					bool value;
+					if (!(iss >> value))
+						break;
+
+					word = value ? 1u : 0u;
+				}
+				else if (*kind == 's')
+				{
+					std::string value;
+					if (!(iss >> value))
+						break;
+
+					word = addString(value);
+				}
+				else
+				{
+					std::string line;
+					std::getline(iss >> std::ws, line);
+
+					word = addString(line);
+				}
+
+				data.words.push_back(word);
+			}
+
+			component.wordCount = (uint16_t)(data.words.size() - component.firstWord);
+			components.push_back(component);
+
+			return true;
+		}
+
+		void addComponents(const std::vector<BinaryComponent>& components, uint32_t& firstComponent, uint32_t& componentCount)
+		{
+			firstComponent = (uint32_t)data.components.size();
+			componentCount = (uint32_t)components.size();
+
+			data.components.insert(data.components.end(), components.begin(), components.end());
+		}
+
+		uint32_t addRecipe(const std::string& recipePath)
+		{
+			auto recipeIt = recipeIndices.find(recipePath);
+			if (recipeIt != recipeIndices.end())
+				return recipeIt->second;
+
+			std::istringstream recipeStream(ResourcesManager::loadRecipe(recipePath)->recipe);
+
+			std::vector<BinaryComponent> components;
+
+			std::string line;
+			while (std::getline(recipeStream, line))
+			{
+				std::istringstream iss(line);
+
+				std::string type;
+				iss >> type;
+
+				if (type == "COMP")
+					addComponent(iss, components);
+			}
+
+			BinaryRecipe recipe;
+			recipe.pathIndex = addString(recipePath);
+			addComponents(components, recipe.firstComponent, recipe.componentCount);
+
+			uint32_t recipeIndex = (uint32_t)data.recipes.size();
+
+			data.recipes.push_back(recipe);
+			recipeIndices[recipePath] = recipeIndex;
+
+			return recipeIndex;
+		}
+	};
+
+	// Read the tables of a binary scene from its buffer
+	class BinarySceneReader
+	{
+	private:
+		const char* cursor = nullptr;
+		const char* end = nullptr;
+
+	public:
+		BinarySceneReader(const std::vector<char>& buffer)
+			: cursor(buffer.data()), end(buffer.data() + buffer.size())
+		{
+
+		}
+
+		template <typename T>
+		bool read(T& value)
+		{
+			return readArray(&value, 1u);
+		}
+
+		template <typename T>
+		bool readArray(T* values, size_t count)
+		{
+			size_t size = sizeof(T) * count;
+
+			if ((size_t)(end - cursor) < size)
+				return false;
+
+			std::memcpy(values, cursor, size);
+			cursor += size;
+
+			return true;
+		}
+
+		template <typename T>
+		bool readVector(std::vector<T>& values, size_t count)
+		{
+			// Do not allocate more than what is left in the buffer
+			if ((size_t)(end - cursor) / sizeof(T) < count)
+				return false;
+
+			values.resize(count);
+
+			return readArray(values.data(), count);
+		}
+
+		bool readStrings(std::vector<std::string>& strings, uint32_t stringCount, uint32_t stringBytes)
+		{
+			// Offsets of each string in the character data, and the end of the last one
+			std::vector<uint32_t> offsets;
+			if (!readVector(offsets, (size_t)stringCount + 1u))
+				return false;
+
+			if ((size_t)(end - cursor) < stringBytes || offsets.back() > stringBytes)
+				return false;
+
+			strings.resize(stringCount);
+			for (uint32_t i = 0u; i < stringCount; i++)
+			{
+				if (offsets[i] > offsets[i + 1])
+					return false;
+
+				strings[i].assign(cursor + offsets[i], offsets[i + 1] - offsets[i]);
+			}
+
+			cursor += stringBytes;
+
+			return true;
+		}
+	};
+
+	bool BinaryScene::isBinaryScene(const std::string& filePath)
+	{
+		return filePath.size() >= extension.size() && filePath.compare(filePath.size() - extension.size(), extension.size(), extension) == 0;
+	}
+
+	std::string BinaryScene::getBinaryPath(const std::string& scenePath)
+	{
+		size_t extensionPos = scenePath.find_last_of('.');
+
+		return scenePath.substr(0, extensionPos) + extension;
+	}
+
+	bool BinaryScene::read(const std::string& filePath, BinarySceneData& data)
+	{
+		std::ifstream ifs(ResourcesManager::getResourcesPath() + filePath, std::ios::binary | std::ios::ate);
+
+		if (!ifs)
+		{
+			Core::Debug::Log::error("Can not find the binary scene at " + filePath);
+			return false;
+		}
+
+		// Read the whole file at once
+		std::vector<char> buffer((size_t)ifs.tellg());
+		ifs.seekg(0);
+		ifs.read(buffer.data(), buffer.size());
+
+		BinarySceneReader reader(buffer);
+		BinarySceneHeader defaultHeader;
+
+		bool isRead = reader.read(data.header) &&
+			std::memcmp(data.header.magic, defaultHeader.magic, sizeof(defaultHeader.magic)) == 0 &&
+			data.header.version == defaultHeader.version &&
+			reader.readStrings(data.strings, data.header.stringCount, data.header.stringBytes) &&
+			reader.readVector(data.recipes, data.header.recipeCount) &&
+			reader.readVector(data.entities, data.header.entityCount) &&
+			reader.readVector(data.components, data.header.componentCount) &&
+			reader.readVector(data.words, data.header.wordCount);
+
+		if (!isRead || !isValid(data))
+		{
+			Core::Debug::Log::error("The binary scene " + filePath + " is corrupted or has an unsupported version");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool BinaryScene::write(const std::string& filePath, const BinarySceneData& data)
+	{
+		std::ofstream ofs(ResourcesManager::getResourcesPath() + filePath, std::ios::binary);
+
+		if (!ofs)
+		{
+			Core::Debug::Log::error("Can not write the binary scene at " + filePath);
+			return false;
+		}
+
+		std::vector<uint32_t> offsets = { 0u };
+		for (const std::string& str : data.strings)
+			offsets.push_back(offsets.back() + (uint32_t)str.size());
+
+		BinarySceneHeader header;
+		header.stringCount = (uint32_t)data.strings.size();
+		header.stringBytes = offsets.back();
+		header.recipeCount = (uint32_t)data.recipes.size();
+		header.entityCount = (uint32_t)data.entities.size();
+		header.componentCount = (uint32_t)data.components.size();
+		header.wordCount = (uint32_t)data.words.size();
+
+		ofs.write((const char*)&header, sizeof(header));
+		ofs.write((const char*)offsets.data(), offsets.size() * sizeof(uint32_t));
+
+		for (const std::string& str : data.strings)
+			ofs.write(str.data(), str.size());
+
+		ofs.write((const char*)data.recipes.data(), data.recipes.size() * sizeof(BinaryRecipe));
+		ofs.write((const char*)data.entities.data(), data.entities.size() * sizeof(BinaryEntity));
+		ofs.write((const char*)data.components.data(), data.components.size() * sizeof(BinaryComponent));
+		ofs.write((const char*)data.words.data(), data.words.size() * sizeof(uint32_t));
+
+		return ofs.good();
+	}
+
+	bool BinaryScene::isValid(const BinarySceneData& data)
+	{
+		auto isRangeValid = [](uint64_t first, uint64_t count, size_t size)
+		{
+			return first + count <= size;
+		};
+
+		for (const BinaryComponent& component : data.components)
+		{
+			if (!isRangeValid(component.firstWord, component.wordCount, data.words.size()))
+				return false;
+
+			const uint32_t* words = data.words.data() + component.firstWord;
+
+			if (component.type == recipeComponentType)
+			{
+				if (component.wordCount != 1u || words[0] >= data.recipes.size())
+					return false;
+			}
+			else
+			{
+				const char* layout = getComponentLayout((Engine::ComponentType)component.type);
+
+				if (!layout || component.wordCount > std::strlen(layout))
+					return false;
+
+				// The strings are given by their index in the table
+				for (uint32_t i = 0u; i < component.wordCount; i++)
+				{
+					if ((layout[i] == 's' || layout[i] == 'l') && words[i] >= data.strings.size())
+						return false;
+				}
+			}
+		}
+
+		for (const BinaryRecipe& recipe : data.recipes)
+		{
+			if (recipe.pathIndex >= data.strings.size() || !isRangeValid(recipe.firstComponent, recipe.componentCount, data.components.size()))
+				return false;
+
+			// Recipes can not instantiate other recipes
+			for (uint32_t i = 0u; i < recipe.componentCount; i++)
+			{
+				if (data.components[recipe.firstComponent + i].type == recipeComponentType)
+					return false;
+			}
+		}
+
+		for (const BinaryEntity& entity : data.entities)
+		{
+			if (entity.nameIndex >= data.strings.size() || !isRangeValid(entity.firstComponent, entity.componentCount, data.components.size()))
+				return false;
+		}
+
+		return true;
+	}
+
+	bool BinaryScene::convert(const std::string& scenePath, const std::string& binaryPath)
+	{
+		std::ifstream scnStream(ResourcesManager::getResourcesPath() + scenePath);
+
+		if (!scnStream)
+		{
+			Core::Debug::Log::error("Can not find the scene to convert at " + scenePath);
+			return false;
+		}
+
+		BinarySceneWriter writer;
+
+		BinaryEntity entity;
+		std::vector<BinaryComponent> components;
+		bool isInEntity = false;
+
+		std::string line;
+		while (std::getline(scnStream, line))
+		{
+			std::istringstream iss(line);
+
+			std::string type;
+			iss >> type;
+
+			if (type == "GO")
+			{
+				std::string entityName;
+				iss >> entityName;
+
+				entity.nameIndex = writer.addString(entityName);
+				entity.flags = 0u;
+				components.clear();
+				isInEntity = true;
+			}
+			else if (!isInEntity)
+				continue;
+			else if (type == "COMP")
+				writer.addComponent(iss, components);
+			else if (type == "STATIC")
+				entity.flags |= BinaryEntity::staticFlag;
+			else if (type == "RECIPE")
+			{
+				std::string recipePath;
+				iss >> recipePath;
+
+				BinaryComponent recipeComponent;
+				recipeComponent.type = recipeComponentType;
+				recipeComponent.wordCount = 1u;
+				recipeComponent.firstWord = (uint32_t)writer.data.words.size();
+
+				writer.data.words.push_back(writer.addRecipe(recipePath));
+				components.push_back(recipeComponent);
+			}
+			else if (type == "endGO")
+			{
+				// The components of an entity are stored after the ones of its recipes
+				writer.addComponents(components, entity.firstComponent, entity.componentCount);
+				writer.data.entities.push_back(entity);
+
+				isInEntity = false;
+			}
+		}
+
+		if (!write(binaryPath, writer.data))
+			return false;
+
+		Core::Debug::Log::info("Converted " + scenePath + " to " + binaryPath + " (" + std::to_string(writer.data.entities.size()) + " entities)");
+
+		return true;
+	}
+
+	void BinaryScene::instantiateComponents(Engine::Entity& owner, const BinarySceneData& data, uint32_t firstComponent, uint32_t componentCount, std::string& parentName)
+	{
+		for (uint32_t componentIndex = firstComponent; componentIndex < firstComponent + componentCount; componentIndex++)
+		{
+			const BinaryComponent& component = data.components[componentIndex];
+			const uint32_t* words = data.words.data() + component.firstWord;
+
+			if (component.type == recipeComponentType)
+			{
+				const BinaryRecipe& recipe = data.recipes[words[0]];
+
+				owner.m_recipe = data.strings[recipe.pathIndex];
+				instantiateComponents(owner, data, recipe.firstComponent, recipe.componentCount, parentName);
+			}
+			else
+			{
+				// The parsers of the components read the typed words like their text arguments
+				Engine::ComponentReader reader(words, component.wordCount, data.strings);
+				owner.parseComponent((Engine::ComponentType)component.type, reader, parentName);
+			}
+		}
+	}
+
+	bool BinaryScene::load(Scene& scene, const std::string& filePath)
+	{
+		BinarySceneData data;
+
+		if (!read(filePath, data))
+			return false;
+
+		scene.entities.reserve(scene.entities.size() + data.entities.size());
+
+		std::vector<std::pair<uint32_t, std::string>> parents;
+
+		for (const BinaryEntity& entity : data.entities)
+		{
+			Engine::Entity& owner = scene.instantiate(data.strings[entity.nameIndex]);
+			owner.isStatic = (entity.flags & BinaryEntity::staticFlag) != 0u;
+
+			std::string parentName;
+			instantiateComponents(owner, data, entity.firstComponent, entity.componentCount, parentName);
+
+			if (parentName == "" || parentName == "none")
+				continue;
+
+			parents.push_back({ entity.nameIndex, parentName });
+		}
+
+		for (const auto& parentPair : parents)
+			scene.setEntityParent(parentPair.second, data.strings[parentPair.first]);
+
+		return true;
+	}
+
+	bool BinaryScene::generate(const std::string& scenePath, int entityCount)
+	{
+		std::ofstream scnStream(ResourcesManager::getResourcesPath() + scenePath);
+
+		if (!scnStream)
+		{
+			Core::Debug::Log::error("Can not write the generated scene at " + scenePath);
+			return false;
+		}
+
+		for (int i = 0; i < entityCount; i++)
+		{
+			bool isParent = i % 8 == 0;
+			std::string parentName = isParent ? "none" : "Entity_" + std::to_string(i - i % 8);
+
+			scnStream << "GO Entity_" << i << '\n'
+					  << "COMP TRANSFORM " << (float)(i % 100) << ' ' << (float)(i % 7) << ' ' << (float)(i / 100) << " 0.000000 "
+					  << (float)(i % 360) * 0.0174533f << " 0.000000 1.000000 1.000000 1.000000 " << parentName << '\n';
+
+			// Give the parsers of the other components some work, in both formats
+			if (isParent)
+				scnStream << "COMP BOXCOLLIDER 0.000000 0.000000 0.000000 1.000000 1.000000 1.000000 0.000000 0.000000 0.000000 1.000000 0.000000 0\n";
+
+			scnStream << "endGO\n\n";
+		}
+
+		return true;
+	}
+
+	void BinaryScene::benchmark(int entityCount, int runCount)
+	{
+		const std::string scenePath = "resources/scenes/generatedScene.scn";
+		const std::string binaryPath = getBinaryPath(scenePath);
+
+		if (entityCount <= 0 || runCount <= 0 || !generate(scenePath, entityCount) || !convert(scenePath, binaryPath))
+			return;
+
+		// The first instantiation creates the resources, the measured ones find them in the cache
+		std::make_unique<Scene>(scenePath).reset();
+
+		double textDuration = 0.0;
+		double binaryDuration = 0.0;
+
+		// Alternate the formats, only measuring the instantiation and not the destruction of the scenes
+		for (int run = 0; run < runCount; run++)
+		{
+			Core::Debug::Benchmarker::startChrono("Text scene instantiation");
+			auto textScene = std::make_unique<Scene>(scenePath);
+			Core::Debug::Benchmarker::stopChrono("Text scene instantiation");
+
+			textScene.reset();
+
+			Core::Debug::Benchmarker::startChrono("Binary scene instantiation");
+			auto binaryScene = std::make_unique<Scene>(binaryPath);
+			Core::Debug::Benchmarker::stopChrono("Binary scene instantiation");
+
+			binaryScene.reset();
+
+			textDuration += Core::Debug::Benchmarker::getDuration("Text scene instantiation").count() * 1000.0;
+			binaryDuration += Core::Debug::Benchmarker::getDuration("Binary scene instantiation").count() * 1000.0;
+		}
+
+		Core::Debug::Log::info("Instantiated " + std::to_string(entityCount) + " entities in " + std::to_string(textDuration / runCount) +
+							   " ms from text and in " + std::to_string(binaryDuration / runCount) + " ms from binary, on average over " + std::to_string(runCount) + " runs");
+	}
+}
@@ -1,109 +1,446 @@
 #include "character.hpp"
 
-#include <glad/glad.h>
+#include <imgui.h>
+
+#include <algorithm>
+#include <cmath>
+
+// The rect pack implementation of ImGui is private to its own unit
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
 
 #include "debug.hpp"
+#include "tracer.hpp"
+#include "gl_state_cache.hpp"
 #include "resources_manager.hpp"
+#include "render_manager.hpp"
+
+#include "utils.hpp"
 
 namespace Resources
 {
-	Font::Font(const std::string& path)
+	// Printable ASCII characters
+	constexpr unsigned char firstChar = 32u;
+	constexpr unsigned char lastChar = 126u;
+
+	// Convert a coverage bitmap to a signed distance field, 128 being the edge of the glyph
+	std::vector<unsigned char> computeDistanceField(const std::vector<unsigned char>& bitmap, int width, int height, int spread)
+	{
+		std::vector<unsigned char> distanceField(bitmap.size());
+
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				bool isInside = bitmap[y * width + x] > 127u;
+
+				// Search the closest pixel on the other side of the edge
+				int minSquaredDistance = spread * spread;
+
+				for (int offsetY = -spread; offsetY <= spread; offsetY++)
+				{
+					int sampleY = y + offsetY;
+
+					if (sampleY < 0 || sampleY >= height)
+						continue;
+
+					for (int offsetX = -spread; offsetX <= spread; offsetX++)
+					{
+						int sampleX = x + offsetX;
+
+						if (sampleX < 0 || sampleX >= width)
+							continue;
+
+						int squaredDistance = offsetX * offsetX + offsetY * offsetY;
+
+						if (squaredDistance < minSquaredDistance && (bitmap[sampleY * width + sampleX] > 127u) != isInside)
+							minSquaredDistance = squaredDistance;
+					}
+				}
+
+				float distance = std::sqrt((float)minSquaredDistance) / (float)spread;
+				float signedDistance = isInside ? distance : -distance;
+
+				distanceField[y * width + x] = (unsigned char)std::clamp(128.f + signedDistance * 127.f, 0.f, 255.f);
+			}
+		}
+
+		return distanceField;
+	}
+
+	Font::Font(const std::string& path, int pixelSize, bool isSDF)
+		: Resource(path), pixelSize(pixelSize), isSDF(isSDF)
+	{
+	}
+
+	Font::~Font()
+	{
+		if (atlasID)
+			glDeleteTextures(1, &atlasID);
+	}
+
+	bool Font::generateAtlas()
 	{
+		// Do not rasterize the font if the load has been cancelled
+		if (isLoadCancelled())
+			return false;
+
+		Core::Debug::Tracer::Scope rasterScope("Font rasterization", m_name);
+
 		FT_Library ft;
 		if (FT_Init_FreeType(&ft))
 		{
-			Core::Debug::Log::error("Unable to init freetype lib" + path);
-			return;
+			Core::Debug::Log::error("Unable to init freetype lib " + m_filePath);
+			return false;
 		}
 
+		std::string correctPath = ResourcesManager::getResourcesPath() + m_filePath;
+
 		FT_Face face;
-		if (FT_New_Face(ft, "resources/fonts/test.ttf", 0, &face))
+		if (FT_New_Face(ft, correctPath.c_str(), 0, &face))
 		{
-			Core::Debug::Log::error("Unable to load the font " + path);
-			return;
+			Core::Debug::Log::error("Unable to load the font " + m_filePath);
+			FT_Done_FreeType(ft);
+			return false;
 		}
 
-		FT_Set_Pixel_Sizes(face, 0, 48);
+		FT_Set_Pixel_Sizes(face, 0, pixelSize);
+
+		lineHeight = (float)(face->size->metrics.height >> 6);
+
+		// Keep a border around the glyphs, large enough for the distance field
+		int padding = isSDF ? distanceSpread : 1;
+
+		std::vector<std::vector<unsigned char>> bitmaps;
+		std::vector<unsigned char> rectChars;
+		std::vector<stbrp_rect> rects;
 
-		if (FT_Load_Char(face, 'X', FT_LOAD_RENDER))
+		// Rasterize each glyph in its own padded bitmap
+		for (unsigned char c = firstChar; c <= lastChar; c++)
 		{
-			Core::Debug::Log::error("Unable to load the font glyph " + path);
-			return;
+			if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+			{
+				Core::Debug::Log::warning("Unable to load the glyph " + std::string(1, c) + " of the font " + m_filePath);
+				continue;
+			}
+
+			const FT_GlyphSlot glyph = face->glyph;
+
+			int width = (int)glyph->bitmap.width + 2 * padding;
+			int height = (int)glyph->bitmap.rows + 2 * padding;
+
+			std::vector<unsigned char> bitmap(width * height, 0u);
+
+			for (unsigned int row = 0u; row < glyph->bitmap.rows; row++)
+			{
+				const unsigned char* source = glyph->bitmap.buffer + row * glyph->bitmap.pitch;
+				std::copy(source, source + glyph->bitmap.width, bitmap.begin() + (row + padding) * width + padding);
+			}
+
+			if (isSDF)
+				bitmap = computeDistanceField(bitmap, width, height, distanceSpread);
+
+			charMap[c] = {
+				Core::Maths::vec2((float)width, (float)height),
+				Core::Maths::vec2((float)(glyph->bitmap_left - padding), (float)(glyph->bitmap_top + padding)),
+				Core::Maths::vec2(), Core::Maths::vec2(),
+				(float)(glyph->advance.x >> 6)
+			};
+
+			stbrp_rect rect{};
+			rect.id = (int)bitmaps.size();
+			rect.w = (stbrp_coord)width;
+			rect.h = (stbrp_coord)height;
+
+			rects.push_back(rect);
+			rectChars.push_back(c);
+			bitmaps.push_back(std::move(bitmap));
 		}
 
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
-
-        for (unsigned char c = 0; c < 128; c++)
-        {
-            // load character glyph 
-            if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-            {
-                std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-                continue;
-            }
-            // generate texture
-            unsigned int texture;
-            glGenTextures(1, &texture);
-            glBindTexture(GL_TEXTURE_2D, texture);
-            glTexImage2D(
-                GL_TEXTURE_2D,
-                0,
-                GL_RED,
-                face->glyph->bitmap.width,
-                face->glyph->bitmap.rows,
-                0,
-                GL_RED,
-                GL_UNSIGNED_BYTE,
-                face->glyph->bitmap.buffer
-            );
-            // set texture options
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            // now store character for later use
-            Character character = {
-                texture,
-                Core::Maths::vec2((float)face->glyph->bitmap.width, (float)face->glyph->bitmap.rows),
-                Core::Maths::vec2((float)face->glyph->bitmap_left, (float)face->glyph->bitmap_top),
-				(unsigned int)face->glyph->advance.x
-            };
-
-            charMap.insert(std::pair<char, Character>(c, character));
-        }
-
-        FT_Done_Face(face);
-        FT_Done_FreeType(ft);
-	}
-
-	Text::Text(Engine::Entity& owner, const std::string& path)
+		FT_Done_Face(face);
+		FT_Done_FreeType(ft);
+
+		if (isLoadCancelled())
+			return false;
+
+		// Pack the glyphs in the smallest square atlas
+		bool isPacked = false;
+		for (atlasSize = 128; atlasSize <= 4096 && !isPacked; atlasSize *= 2)
+		{
+			std::vector<stbrp_node> nodes(atlasSize);
+
+			stbrp_context context;
+			stbrp_init_target(&context, atlasSize, atlasSize, nodes.data(), (int)nodes.size());
+
+			isPacked = stbrp_pack_rects(&context, rects.data(), (int)rects.size());
+		}
+
+		// Undo the last size increment of the loop
+		atlasSize /= 2;
+
+		if (!isPacked)
+		{
+			Core::Debug::Log::error("Unable to pack the glyphs of the font " + m_filePath);
+			return false;
+		}
+
+		atlasBuffer.assign((size_t)atlasSize * atlasSize, 0u);
+
+		// Copy the glyphs in the atlas and set their coordinates
+		for (const stbrp_rect& rect : rects)
+		{
+			const std::vector<unsigned char>& bitmap = bitmaps[rect.id];
+
+			for (int row = 0; row < rect.h; row++)
+				std::copy_n(bitmap.begin() + row * rect.w, rect.w, atlasBuffer.begin() + (rect.y + row) * atlasSize + rect.x);
+
+			Character& character = charMap[rectChars[rect.id]];
+			character.uvMin = Core::Maths::vec2((float)rect.x / atlasSize, (float)rect.y / atlasSize);
+			character.uvMax = Core::Maths::vec2((float)(rect.x + rect.w) / atlasSize, (float)(rect.y + rect.h) / atlasSize);
+		}
+
+		Core::Debug::Log::info("Font " + m_filePath + " packed in a " + std::to_string(atlasSize) + "x" + std::to_string(atlasSize) + " atlas");
+
+		// Tell to the RM that the initialization is finished
+		ResourcesManager::addToMainThreadInitializerQueue(this);
+
+		return true;
+	}
+
+	bool Font::generateID()
+	{
+		if (atlasBuffer.empty() || atlasID)
+			return false;
+
+		glGenTextures(1, &atlasID);
+		glBindTexture(GL_TEXTURE_2D, atlasID);
+
+		// The atlas has a single byte per texel
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlasSize, atlasSize, 0, GL_RED, GL_UNSIGNED_BYTE, atlasBuffer.data());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// The texture binding was changed behind the cache
+		LowRenderer::GLStateCache::invalidate();
+
+		// The glyphs are now on the GPU
+		if (!keepCPUData)
+		{
+			atlasBuffer.clear();
+			atlasBuffer.shrink_to_fit();
+		}
+
+		return true;
+	}
+
+	void Font::mainThreadInitialization()
+	{
+		generateID();
+	}
+
+	GLuint Font::getID() const
+	{
+		return atlasID;
+	}
+
+	int Font::getPixelSize() const
+	{
+		return pixelSize;
+	}
+
+	size_t Font::getCPUBytes() const
+	{
+		return atlasBuffer.capacity();
+	}
+
+	size_t Font::getGPUBytes() const
+	{
+		return atlasID ? (size_t)atlasSize * atlasSize : 0u;
+	}
+
+	bool Font::isDistanceField() const
+	{
+		return isSDF;
+	}
+
+	float Font::getLineHeight() const
+	{
+		return lineHeight;
+	}
+
+	const Character* Font::getCharacter(char c) const
+	{
+		auto characterIt = charMap.find(c);
+
+		if (characterIt == charMap.end())
+			return nullptr;
+
+		return &characterIt->second;
+	}
+
+	Text::Text(Engine::Entity& owner, const std::string& fontPath, int pixelSize, bool isSDF)
 		: Component(owner)
 	{
-		m_shaderProgram = Resources::ResourcesManager::loadShaderProgram("skyBox");
+		m_font = Resources::ResourcesManager::loadFont(fontPath, pixelSize, isSDF);
 
-		m_font = Resources::ResourcesManager::loadFont(path);
+		LowRenderer::RenderManager::linkComponent(this);
 	}
 
-	Text::~Text()
+	void Text::onDestroy()
 	{
-		//Core::Debug::Log::info("Unload model " + cubeMap;
+		Component::onDestroy();
+
+		LowRenderer::RenderManager::removeComponent(this);
 	}
 
-	void Text::draw() const
+	void Text::setText(const std::string& text)
 	{
-		
+		if (m_text == text)
+			return;
+
+		m_text = text;
+		isDirty = true;
+	}
+
+	const std::string& Text::getText() const
+	{
+		return m_text;
+	}
+
+	void Text::setPosition(const Core::Maths::vec2& position)
+	{
+		m_position = position;
+		isDirty = true;
+	}
+
+	void Text::setColor(const Core::Maths::vec4& color)
+	{
+		m_color = color;
+		isDirty = true;
+	}
+
+	void Text::setScale(float scale)
+	{
+		m_scale = scale;
+		isDirty = true;
+	}
+
+	const std::shared_ptr<Font>& Text::getFont() const
+	{
+		return m_font;
+	}
+
+	const std::vector<TextVertex>& Text::getVertices() const
+	{
+		// The glyph metrics are only known once the font is loaded
+		if (!isDirty || !m_font || !m_font->getID())
+			return vertices;
+
+		vertices.clear();
+		vertices.reserve(m_text.size() * 6);
+
+		Core::Maths::vec2 cursor = m_position;
+
+		for (char c : m_text)
+		{
+			if (c == '\n')
+			{
+				cursor.x = m_position.x;
+				cursor.y -= m_font->getLineHeight() * m_scale;
+				continue;
+			}
+
+			const Character* character = m_font->getCharacter(c);
+
+			if (!character)
+				continue;
+
+			float left = cursor.x + character->bearing.x * m_scale;
+			float top = cursor.y + character->bearing.y * m_scale;
+			float right = left + character->size.x * m_scale;
+			float bottom = top - character->size.y * m_scale;
+
+			const Core::Maths::vec2& uvMin = character->uvMin;
+			const Core::Maths::vec2& uvMax = character->uvMax;
+
+			// Two counter-clockwise triangles per glyph
+			vertices.push_back({ Core::Maths::vec4(left, top, uvMin.x, uvMin.y), m_color });
+			vertices.push_back({ Core::Maths::vec4(left, bottom, uvMin.x, uvMax.y), m_color });
+			vertices.push_back({ Core::Maths::vec4(right, bottom, uvMax.x, uvMax.y), m_color });
+
+			vertices.push_back({ Core::Maths::vec4(left, top, uvMin.x, uvMin.y), m_color });
+			vertices.push_back({ Core::Maths::vec4(right, bottom, uvMax.x, uvMax.y), m_color });
+			vertices.push_back({ Core::Maths::vec4(right, top, uvMax.x, uvMin.y), m_color });
+
+			cursor.x += character->advance * m_scale;
+		}
+
+		isDirty = false;
+
+		return vertices;
+	}
+
+	void Text::drawImGui()
+	{
+		if (ImGui::TreeNode("Text"))
+		{
+			ImGui::Text("%s", m_text.c_str());
+
+			isDirty |= ImGui::DragFloat2("Position", m_position.e);
+			isDirty |= ImGui::ColorEdit4("Color", m_color.e);
+			isDirty |= ImGui::DragFloat("Scale", &m_scale, 0.01f, 0.f, 10.f);
+
+			Component::drawImGui();
+
+			ImGui::TreePop();
+		}
 	}
 
 	std::string Text::toString() const
 	{
-		return "";
+		return "COMP TEXT " + m_font->getPath() + " " + std::to_string(m_font->getPixelSize()) + " " + std::to_string(m_font->isDistanceField()) + " "
+			+ Utils::vecToStringParsing(m_position) + Utils::vecToStringParsing(m_color) + std::to_string(m_scale) + " " + m_text;
 	}
 
-	void Text::parseComponent(Engine::Entity& owner, std::istringstream& iss)
+	void Text::parseComponent(Engine::Entity& owner, Engine::ComponentReader& iss)
 	{
-		std::string path;
-		iss >> path;
+		std::string fontPath;
+		int pixelSize;
+		bool isSDF;
+
+		iss >> fontPath;
+		iss >> pixelSize;
+		iss >> isSDF;
+
+		Core::Maths::vec2 position;
+		iss >> position.x;
+		iss >> position.y;
+
+		Core::Maths::vec4 color;
+		iss >> color.x;
+		iss >> color.y;
+		iss >> color.z;
+		iss >> color.w;
+
+		float scale;
+		iss >> scale;
+
+		// The rest of the line is the displayed string
+		std::string text;
+		iss.readLine(text);
 
-		owner.addComponent<Text>(path);
+		Text* textComp = owner.addComponent<Text>(fontPath, pixelSize, isSDF);
+		textComp->setPosition(position);
+		textComp->setColor(color);
+		textComp->setScale(scale);
+		textComp->setText(text);
 	}
-}
\ No newline at end of file
+}
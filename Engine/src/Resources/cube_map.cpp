@@ -1,9 +1,10 @@
 #include "cube_map.hpp"
 
-#include "stb_image.h"
-
 #include "debug.hpp"
+#include "gl_state_cache.hpp"
 #include "resources_manager.hpp"
+#include "utils.hpp"
+#include "hash.hpp"
 
 namespace Resources
 {
@@ -21,12 +22,84 @@ namespace Resources
 
 	bool CubeMap::generateBuffers()
 	{
-		stbi_set_flip_vertically_on_load(false);
+		remainingFaces = 6;
 
+		// Read and hash each face as its own task, the faces follow the residency of the cube map
 		for (int i = 0; i < 6; i++)
-			textures[i].generateBuffer();
+		{
+			textures[i].setKeepCPUData(keepCPUData);
+			ResourcesManager::manageTask(&CubeMap::readFace, this, i);
+		}
+
+		return true;
+	}
+
+	bool CubeMap::readFace(int faceIndex)
+	{
+		if (!isLoadCancelled() && !textures[faceIndex].readContent(faceHashes[faceIndex]))
+			isFaceMissing = true;
+
+		// Only the last read face resolves the content of the cube map
+		if (remainingFaces.fetch_sub(1) > 1)
+			return true;
+
+		if (isLoadCancelled())
+			return false;
+
+		// A face that cannot be read is reported by its decode
+		if (!isFaceMissing)
+		{
+			uint64_t contentHash = 0u;
+			for (int i = 0; i < 6; i++)
+				contentHash = Utils::combineHashes(contentHash, faceHashes[i]);
+
+			sharedCubeMap = ResourcesManager::resolveCubeMapContent(Utils::getDirectory(paths.back()), contentHash);
+
+			if (sharedCubeMap)
+			{
+				for (int i = 0; i < 6; i++)
+					textures[i].releaseContent();
+
+				Core::Debug::Log::info(Utils::getDirectory(paths.back()) + " has the same faces as " + Utils::getDirectory(sharedCubeMap->getPaths().back()) + ", its cube map is shared");
+
+				ResourcesManager::addToMainThreadInitializerQueue(this);
+				return true;
+			}
+		}
+
+		// Decode each face from the content read, as its own task
+		remainingFaces = 6;
+
+		for (int i = 0; i < 6; i++)
+			ResourcesManager::manageTask(&CubeMap::generateFaceBuffer, this, i);
+
+		return true;
+	}
+
+	void CubeMap::reload()
+	{
+		remainingFaces = 6;
+
+		// A hot reload is not part of the scene load
+		for (int i = 0; i < 6; i++)
+		{
+			textures[i].setKeepCPUData(keepCPUData);
+			ResourcesManager::manageReloadTask(&CubeMap::generateFaceBuffer, this, i);
+		}
+	}
+
+	bool CubeMap::generateFaceBuffer(int faceIndex)
+	{
+		// The flip is set per thread by the face, so concurrent textures are not affected
+		if (!isLoadCancelled())
+			textures[faceIndex].generateBuffer();
+
+		// Only the last decoded face sends the cube map to the main thread
+		if (remainingFaces.fetch_sub(1) > 1)
+			return true;
 
-		stbi_set_flip_vertically_on_load(true);
+		if (isLoadCancelled())
+			return false;
 
 		ResourcesManager::addToMainThreadInitializerQueue(this);
 
@@ -35,7 +108,10 @@ namespace Resources
 
 	bool CubeMap::generateID()
 	{
-		glGenTextures(1, &ID);
+		// A reloaded cube map keeps its texture
+		if (ID == (GLuint)-1)
+			glGenTextures(1, &ID);
+
 		glBindTexture(GL_TEXTURE_CUBE_MAP, ID);
 
 		for (int i = 0; i < 6; i++)
@@ -47,24 +123,71 @@ namespace Resources
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
-		glActiveTexture(0);
 		glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
+		// The texture binding was changed behind the cache
+		LowRenderer::GLStateCache::invalidate();
+
 		return true;
 	}
 
 	GLuint CubeMap::getID() const
 	{
-		return ID;
+		return isShared ? sharedCubeMap->getID() : ID;
 	}
 
-	void CubeMap::bind() const
+	const std::vector<std::string>& CubeMap::getPaths() const
 	{
-		glBindTexture(GL_TEXTURE_CUBE_MAP, ID);
+		return paths;
+	}
+
+	size_t CubeMap::getDecodedSize() const
+	{
+		size_t decodedSize = 0u;
+
+		for (int i = 0; i < 6; i++)
+			decodedSize += textures[i].getDecodedSize();
+
+		return decodedSize;
+	}
+
+	size_t CubeMap::getCPUBytes() const
+	{
+		size_t cpuBytes = 0u;
+
+		for (int i = 0; i < 6; i++)
+			cpuBytes += textures[i].getCPUBytes();
+
+		return cpuBytes;
+	}
+
+	size_t CubeMap::getGPUBytes() const
+	{
+		if (ID == (GLuint)-1)
+			return 0u;
+
+		// The faces are stored as RGBA8, without mipmaps
+		size_t gpuBytes = 0u;
+
+		for (int i = 0; i < 6; i++)
+			gpuBytes += (size_t)textures[i].getWidth() * textures[i].getHeight() * 4;
+
+		return gpuBytes;
+	}
+
+	void CubeMap::bind(GLuint unit) const
+	{
+		LowRenderer::GLStateCache::bindTexture(unit, GL_TEXTURE_CUBE_MAP, getID());
 	}
 
 	void CubeMap::mainThreadInitialization()
 	{
+		if (sharedCubeMap)
+		{
+			isShared = true;
+			return;
+		}
+
 		generateID();
 	}
 }
\ No newline at end of file
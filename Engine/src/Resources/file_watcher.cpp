@@ -0,0 +1,178 @@
+#include "file_watcher.hpp"
+
+#include <chrono>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <poll.h>
+#endif
+
+#include "resources_manager.hpp"
+#include "debug.hpp"
+
+namespace Resources
+{
+	FileWatcher::~FileWatcher()
+	{
+		isWatching = false;
+
+		if (watchThread.joinable())
+			watchThread.join();
+
+#ifdef __linux__
+		if (inotifyDescriptor >= 0)
+			close(inotifyDescriptor);
+#endif
+	}
+
+	void FileWatcher::init(const std::string& directoryPath)
+	{
+		FileWatcher* FW = instance();
+
+		if (FW->isWatching)
+			return;
+
+		FW->basePath = ResourcesManager::getResourcesPath();
+		FW->watchedPath = FW->basePath / directoryPath;
+
+		if (!std::filesystem::is_directory(FW->watchedPath))
+		{
+			Core::Debug::Log::error("Can not watch the directory " + FW->watchedPath.string());
+			return;
+		}
+
+#ifdef __linux__
+		FW->inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+		if (FW->inotifyDescriptor < 0)
+		{
+			Core::Debug::Log::error("Can not initialize inotify, the resources will not be hot reloaded");
+			return;
+		}
+
+		// inotify is not recursive, each directory is watched
+		FW->addWatch(FW->watchedPath);
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(FW->watchedPath))
+		{
+			if (entry.is_directory())
+				FW->addWatch(entry.path());
+		}
+#else
+		FW->scanWriteTimes(false);
+#endif
+
+		FW->isWatching = true;
+		FW->watchThread = std::thread(&FileWatcher::watch, FW);
+
+		Core::Debug::Log::info("Watching " + FW->watchedPath.string() + " for hot reload");
+	}
+
+	void FileWatcher::addChangedFile(const std::filesystem::path& filePath)
+	{
+		// Use the same relative paths as the resources
+		changedFiles.tryPush(std::filesystem::relative(filePath, basePath).generic_string());
+	}
+
+#ifdef __linux__
+	void FileWatcher::addWatch(const std::filesystem::path& directoryPath)
+	{
+		int watchDescriptor = inotify_add_watch(inotifyDescriptor, directoryPath.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+
+		if (watchDescriptor < 0)
+		{
+			Core::Debug::Log::warning("Can not watch the directory " + directoryPath.string());
+			return;
+		}
+
+		watchedDirectories[watchDescriptor] = directoryPath;
+	}
+
+	void FileWatcher::readEvents()
+	{
+		alignas(inotify_event) char buffer[4096];
+
+		ssize_t length;
+		while ((length = read(inotifyDescriptor, buffer, sizeof(buffer))) > 0)
+		{
+			for (char* cursor = buffer; cursor < buffer + length; cursor += sizeof(inotify_event) + ((inotify_event*)cursor)->len)
+			{
+				const inotify_event* event = (inotify_event*)cursor;
+
+				auto directoryIt = watchedDirectories.find(event->wd);
+				if (!event->len || directoryIt == watchedDirectories.end())
+					continue;
+
+				std::filesystem::path filePath = directoryIt->second / event->name;
+
+				// Watch the new directories, and wait for the created files to be written
+				if (event->mask & IN_ISDIR)
+				{
+					if (event->mask & (IN_CREATE | IN_MOVED_TO))
+						addWatch(filePath);
+				}
+				else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+					addChangedFile(filePath);
+			}
+		}
+	}
+#else
+	void FileWatcher::scanWriteTimes(bool notifyChanges)
+	{
+		std::error_code error;
+
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(watchedPath, error))
+		{
+			if (!entry.is_regular_file(error))
+				continue;
+
+			std::filesystem::file_time_type writeTime = entry.last_write_time(error);
+			if (error)
+				continue;
+
+			auto [writeTimeIt, isNew] = writeTimes.try_emplace(entry.path().string(), writeTime);
+
+			if (!isNew && writeTimeIt->second != writeTime)
+			{
+				writeTimeIt->second = writeTime;
+
+				if (notifyChanges)
+					addChangedFile(entry.path());
+			}
+		}
+	}
+#endif
+
+	void FileWatcher::watch()
+	{
+		while (isWatching)
+		{
+#ifdef __linux__
+			pollfd descriptor = { inotifyDescriptor, POLLIN, 0 };
+
+			if (poll(&descriptor, 1, 100) > 0)
+				readEvents();
+#else
+			// Without inotify, compare the write times of the files
+			std::this_thread::sleep_for(std::chrono::milliseconds(250));
+			scanWriteTimes(true);
+#endif
+		}
+	}
+
+	void FileWatcher::update()
+	{
+		FileWatcher* FW = instance();
+
+		// A save can trigger several events, reload each file once
+		std::unordered_set<std::string> reloadedFiles;
+
+		std::string filePath;
+		while (FW->changedFiles.tryPop(filePath))
+		{
+			if (reloadedFiles.insert(filePath).second)
+				ResourcesManager::reloadFile(filePath);
+		}
+	}
+}
@@ -3,6 +3,7 @@
 #include <imgui.h>
 
 #include "resources_manager.hpp"
+#include "tracer.hpp"
 #include "utils.hpp"
 #include "maths.hpp"
 
@@ -16,27 +17,51 @@ namespace Resources
 
 	}
 
+	Material::Material(const std::shared_ptr<Material>& reloadedMaterial)
+		: Resource(reloadedMaterial->getPath()), reloadedMaterial(reloadedMaterial)
+	{
+
+	}
+
+	void Material::mainThreadInitialization()
+	{
+		if (!reloadedMaterial)
+			return;
+
+		// Give the parsed values to the material in use, between two frames
+		reloadedMaterial->ambient = ambient;
+		reloadedMaterial->diffuse = diffuse;
+		reloadedMaterial->specular = specular;
+		reloadedMaterial->emissive = emissive;
+
+		for (int i = 0; i < TEXTURE_COUNT; i++)
+			reloadedMaterial->textures[i] = textures[i];
+
+		reloadedMaterial->shininess = shininess;
+		reloadedMaterial->opticalDensity = opticalDensity;
+		reloadedMaterial->transparency = transparency;
+		reloadedMaterial->illumination = illumination;
+	}
+
 	void Material::sendToShader(const std::shared_ptr<ShaderProgram>& shaderProgram) const
 	{
 		// Set the model's material informations 
-		shaderProgram->setUniform("material.ambient", &ambient, false);
-		shaderProgram->setUniform("material.diffuse", &diffuse, false);
-		shaderProgram->setUniform("material.specular", &specular, false);
-		shaderProgram->setUniform("material.emissive", &emissive, false);
+		shaderProgram->setUniform(LowRenderer::UniformIDs::materialAmbient, ambient);
+		shaderProgram->setUniform(LowRenderer::UniformIDs::materialDiffuse, diffuse);
+		shaderProgram->setUniform(LowRenderer::UniformIDs::materialSpecular, specular);
+		shaderProgram->setUniform(LowRenderer::UniformIDs::materialEmissive, emissive);
 		
-		shaderProgram->setUniform("material.shininess", &shininess, false);
-		shaderProgram->setUniform("material.refractiveIndex", &opticalDensity, false);
+		shaderProgram->setUniform(LowRenderer::UniformIDs::materialShininess, shininess);
+		shaderProgram->setUniform(LowRenderer::UniformIDs::materialRefractiveIndex, opticalDensity);
 
-		for (auto [textureName, texturePtr] : textures)
+		for (int i = 0; i < TEXTURE_COUNT; i++)
 		{
-			if (!texturePtr)
+			if (!textures[i])
 				continue;
 
-			if (!shaderProgram->setSampler(textureName, texturePtr->getID()))
-				shaderProgram->setSampler(textureName, Material::defaultMaterial->textures[textureName]->getID());
+			if (!shaderProgram->setSampler(textureIDs[i], textures[i]->getID()))
+				shaderProgram->setSampler(textureIDs[i], Material::defaultMaterial->textures[i]->getID());
 		}
-
-		glActiveTexture(0);
 	}
 
 	void Material::drawImGui()
@@ -53,14 +78,14 @@ namespace Resources
 			ImGui::DragFloat("Transparency", &transparency);
 			ImGui::DragFloat("Illumination", &illumination);
 
-			for (auto [textureName, texturePtr] : textures)
+			for (int i = 0; i < TEXTURE_COUNT; i++)
 			{
-				if (!texturePtr)
+				if (!textures[i])
 					continue;
 
-				if (ImGui::TreeNode(textureName.c_str()))
+				if (ImGui::TreeNode(textureNames[i]))
 				{
-					texturePtr->drawImGui();
+					textures[i]->drawImGui();
 					ImGui::TreePop();
 				}
 			}
@@ -83,11 +108,17 @@ namespace Resources
 
 	void Material::parse(const std::string& toParse, const std::string& directoryPath)
 	{
+		Core::Debug::Tracer::Scope parseScope("MTL parse", m_name);
+
 		std::istringstream stringStream(toParse);
 
 		std::string line;
 		while (std::getline(stringStream, line))
 		{
+			// Stop parsing if the load has been cancelled
+			if (isLoadCancelled())
+				return;
+
 			std::istringstream iss(line);
 			std::string type;
 			iss >> type;
@@ -141,17 +172,21 @@ namespace Resources
 
 			// Load mesh textures
 			if (type == "map_d")
-				textures["material.alphaTexture"] = ResourcesManager::loadTexture(directoryPath + Utils::getFileNameFromPath(texName));
+				textures[ALPHA_TEXTURE] = ResourcesManager::loadTexture(directoryPath + Utils::getFileNameFromPath(texName));
 			else if (type == "map_Ka")
-				textures["material.ambientTexture"] = ResourcesManager::loadTexture(directoryPath + Utils::getFileNameFromPath(texName));
+				textures[AMBIENT_TEXTURE] = ResourcesManager::loadTexture(directoryPath + Utils::getFileNameFromPath(texName));
 			else if (type == "map_Kd")
-				textures["material.diffuseTexture"] = ResourcesManager::loadTexture(directoryPath + Utils::getFileNameFromPath(texName));
+				textures[DIFFUSE_TEXTURE] = ResourcesManager::loadTexture(directoryPath + Utils::getFileNameFromPath(texName));
 			else if (type == "map_Ke")
-				textures["material.emissiveTexture"] = ResourcesManager::loadTexture(directoryPath + Utils::getFileNameFromPath(texName));
+				textures[EMISSIVE_TEXTURE] = ResourcesManager::loadTexture(directoryPath + Utils::getFileNameFromPath(texName));
 			else if (type == "map_Ks")
-				textures["material.specularTexture"] = ResourcesManager::loadTexture(directoryPath + Utils::getFileNameFromPath(texName));
+				textures[SPECULAR_TEXTURE] = ResourcesManager::loadTexture(directoryPath + Utils::getFileNameFromPath(texName));
 			else if (type == "map_bump")
-				textures["material.normalMap"] = ResourcesManager::loadTexture(directoryPath + Utils::getFileNameFromPath(texName));
+				textures[NORMAL_MAP] = ResourcesManager::loadTexture(directoryPath + Utils::getFileNameFromPath(texName));
 		}
+
+		// A reloaded copy is swapped into the material in use by the main thread
+		if (reloadedMaterial)
+			ResourcesManager::addToMainThreadInitializerQueue(this);
 	}
 }
\ No newline at end of file
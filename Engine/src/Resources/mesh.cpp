@@ -1,8 +1,16 @@
 #include "mesh.hpp"
 
 #include <fstream>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
 
 #include "resources_manager.hpp"
+#include "mesh_simplifier.hpp"
+#include "tracer.hpp"
+#include "debug.hpp"
+#include "hash.hpp"
 
 namespace Resources
 {
@@ -12,79 +20,316 @@ namespace Resources
 
 	}
 
+	Mesh::Mesh(const std::shared_ptr<Mesh>& reloadedMesh)
+		: Mesh(reloadedMesh->getPath(), reloadedMesh->parentMeshName)
+	{
+		this->reloadedMesh = reloadedMesh;
+	}
+
 	Mesh::~Mesh()
 	{
-		// Destroy the VBO
-		if (VAO)
-			glDeleteVertexArrays(1, &VAO);
+		// Give back the ranges of the mesh to the arena
+		if (isUploaded())
+			LowRenderer::GeometryArena::free(vertexRange, indexRange);
+	}
 
-		// Destroy the VBO
-		if (VBO)
-			glDeleteBuffers(1, &VBO);
+	// Copy the vertices and the indices of the mesh to the geometry arena
+	void Mesh::upload()
+	{
+		if (vertices.empty() || indices.empty())
+			return;
+
+		// The meshes filled without any import only have their full level
+		if (lods.empty())
+			lods.push_back({ 0u, (GLuint)indices.size() });
+
+		// A reloaded mesh keeps its ranges if it still fits in them
+		if (vertexRange.count != vertices.size() || indexRange.count != indices.size())
+		{
+			if (isUploaded())
+				LowRenderer::GeometryArena::free(vertexRange, indexRange);
+
+			LowRenderer::GeometryArena::allocate((GLuint)vertices.size(), (GLuint)indices.size(), vertexRange, indexRange);
+		}
+
+		LowRenderer::GeometryArena::upload(vertexRange, vertices.data(), indexRange, indices.data());
+
+		// The geometry is now on the GPU, a reload parses it again
+		if (!keepCPUData)
+		{
+			std::vector<Vertex>().swap(vertices);
+			std::vector<unsigned int>().swap(indices);
+		}
 	}
 
-	// Generate VAO, VBO and EBO from mesh
-	void Mesh::generateVAO()
+	bool Mesh::isUploaded() const
 	{
-		// VAO initialization and binding
-		glGenVertexArrays(1, &VAO);
-		glBindVertexArray(VAO);
+		return indexRange.count > 0u;
+	}
 
-		// VBO initialization and binding
-		glGenBuffers(1, &VBO);
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	const Bounds& Mesh::getBounds() const
+	{
+		return bounds;
+	}
+
+	void Mesh::computeBounds()
+	{
+		if (vertices.empty())
+			return;
+
+		Core::Maths::vec3 minPosition = vertices[0].position;
+		Core::Maths::vec3 maxPosition = vertices[0].position;
+
+		for (const Vertex& vertex : vertices)
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				minPosition.e[i] = std::min(minPosition.e[i], vertex.position.e[i]);
+				maxPosition.e[i] = std::max(maxPosition.e[i], vertex.position.e[i]);
+			}
+		}
+
+		Bounds newBounds;
+		newBounds.center = (minPosition + maxPosition) * 0.5f;
+		newBounds.extents = (maxPosition - minPosition) * 0.5f;
+
+		// The sphere is centered on the box, it is tighter than the sphere around the box
+		for (const Vertex& vertex : vertices)
+			newBounds.radius = std::max(newBounds.radius, (vertex.position - newBounds.center).magnitude());
 
-		GLsizei stride = sizeof(Vertex);
+		bounds = newBounds;
+	}
 
-		glBufferData(GL_ARRAY_BUFFER, vertices.size() * stride, vertices.data(), GL_STATIC_DRAW);
+	Bounds Bounds::transform(const Core::Maths::mat4& model) const
+	{
+		Bounds worldBounds;
 
-		// Set the attrib pointer to the positions
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(Vertex, position)));
-		glEnableVertexAttribArray(0);
+		const float* e = model.e;
 
-		// Set the attrib pointer to the texture coordinates
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(Vertex, texCoords)));
-		glEnableVertexAttribArray(1);
+		// Transform the center, and project the extents on the axes of the matrix
+		for (int row = 0; row < 3; row++)
+		{
+			const float* rowValues = e + row * 4;
 
-		// Set the attrib pointer to the tangents
-		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(Vertex, tangent)));
-		glEnableVertexAttribArray(2);
+			worldBounds.center.e[row] = rowValues[0] * center.x + rowValues[1] * center.y + rowValues[2] * center.z + rowValues[3];
+			worldBounds.extents.e[row] = std::abs(rowValues[0]) * extents.x + std::abs(rowValues[1]) * extents.y + std::abs(rowValues[2]) * extents.z;
+		}
 
-		// Set the attrib pointer to the bitangents
-		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(Vertex, bitangent)));
-		glEnableVertexAttribArray(3);
+		// The sphere is scaled by the largest scale of the matrix
+		float maxScale = 0.f;
+		for (int column = 0; column < 3; column++)
+			maxScale = std::max(maxScale, std::sqrt(e[column] * e[column] + e[4 + column] * e[4 + column] + e[8 + column] * e[8 + column]));
 
-		// Set the attrib pointer to the normals
-		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offsetof(Vertex, normal)));
-		glEnableVertexAttribArray(4);
+		worldBounds.radius = radius * maxScale;
 
-		glEnableVertexAttribArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindVertexArray(0);
+		return worldBounds;
 	}
 
-	void Mesh::compute(std::array<unsigned int, 3> offsets, std::vector<Core::Maths::vec3>& positions, std::vector<Core::Maths::vec3>& texCoords, std::vector<Core::Maths::vec3>& normals, std::vector<unsigned int>& indices)
+	LowRenderer::DrawElementsIndirectCommand Mesh::getDrawCommand(GLuint drawIndex, size_t lod) const
 	{
-		// Create attributs vector from mesh values
-		for (size_t i = 0; i < indices.size(); i += 3)
+		const LodRange& lodRange = lods[std::min(lod, lods.size() - 1)];
+
+		// The base instance gives its draw index to the vertex shader
+		return { lodRange.count, 1u, indexRange.first + lodRange.first, (GLint)vertexRange.first, drawIndex };
+	}
+
+	size_t Mesh::getLodCount() const
+	{
+		return lods.size();
+	}
+
+	GLuint Mesh::getTriangleCount(size_t lod) const
+	{
+		if (lods.empty())
+			return 0u;
+
+		return lods[std::min(lod, lods.size() - 1)].count / 3u;
+	}
+
+	void Mesh::generateLods()
+	{
+		Core::Debug::Tracer::Scope lodScope("Mesh LODs", m_name);
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		lods.clear();
+		lods.push_back({ 0u, (GLuint)indices.size() });
+
+		// Each level is simplified from the previous one, with half of its triangles
+		std::vector<unsigned int> lodIndices = indices;
+		std::string lodTriangles = std::to_string(indices.size() / 3);
+
+		while (lods.size() < maxLodCount && lodIndices.size() / 6 >= minLodTriangleCount)
+		{
+			if (isLoadCancelled())
+				return;
+
+			std::vector<unsigned int> simplified = simplifyMesh(vertices, lodIndices, lodIndices.size() / 6 * 3);
+
+			// A level that keeps most of the triangles is not worth its indices, the locked seams stop the collapses
+			if (simplified.size() > lodIndices.size() * 3 / 4)
+				break;
+
+			lods.push_back({ (GLuint)indices.size(), (GLuint)simplified.size() });
+			indices.insert(indices.end(), simplified.begin(), simplified.end());
+
+			lodTriangles += ", " + std::to_string(simplified.size() / 3);
+			lodIndices.swap(simplified);
+		}
+
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		Core::Debug::Log::info("Mesh " + m_name + " LODs: " + lodTriangles + " triangles in " + std::to_string(milliseconds) + " ms");
+	}
+
+	void Mesh::computeOccluder()
+	{
+		occluderPositions.clear();
+		occluderIndices.clear();
+
+		if (lods.empty())
+			return;
+
+		// Finest level under the cap, the large walls and buildings only fit in it once simplified
+		auto lodIt = std::find_if(lods.begin(), lods.end(), [](const LodRange& lod) { return lod.count / 3u <= maxOccluderTriangleCount; });
+		const LodRange& lod = lodIt != lods.end() ? *lodIt : lods.back();
+
+		std::vector<unsigned int> lodIndices(indices.begin() + lod.first, indices.begin() + lod.first + lod.count);
+
+		// Even the coarsest level is over the cap, simplify it down to it
+		if (lodIndices.size() / 3u > maxOccluderTriangleCount)
+			lodIndices = simplifyMesh(vertices, lodIndices, maxOccluderTriangleCount * 3u);
+
+		// The locked seams can stop the collapses, keep the largest triangles that hide the most
+		if (lodIndices.size() / 3u > maxOccluderTriangleCount)
 		{
-			Vertex vertex;
-			vertex.position = positions[indices[i] - offsets[0]];
+			auto getArea = [&](size_t triangle)
+			{
+				const Core::Maths::vec3& a = vertices[lodIndices[triangle * 3]].position;
+				const Core::Maths::vec3& b = vertices[lodIndices[triangle * 3 + 1]].position;
+				const Core::Maths::vec3& c = vertices[lodIndices[triangle * 3 + 2]].position;
+
+				Core::Maths::vec3 normal = (b - a) ^ (c - a);
+				return Core::Maths::dot(normal, normal);
+			};
+
+			std::vector<std::pair<float, size_t>> triangleAreas(lodIndices.size() / 3u);
+			for (size_t triangle = 0; triangle < triangleAreas.size(); triangle++)
+				triangleAreas[triangle] = { getArea(triangle), triangle };
 
-			if (!texCoords.empty())
-				vertex.texCoords = texCoords[indices[i + 1] - offsets[1]];
+			std::nth_element(triangleAreas.begin(), triangleAreas.begin() + maxOccluderTriangleCount, triangleAreas.end(),
+				[](const std::pair<float, size_t>& lhs, const std::pair<float, size_t>& rhs) { return lhs.first > rhs.first; });
 
-			vertex.normal = normals[indices[i + 2] - offsets[2]];
+			std::vector<unsigned int> largestIndices;
+			largestIndices.reserve(maxOccluderTriangleCount * 3u);
 
-			vertices.push_back(vertex);
+			for (size_t i = 0; i < maxOccluderTriangleCount; i++)
+			{
+				size_t triangle = triangleAreas[i].second;
+				largestIndices.insert(largestIndices.end(), lodIndices.begin() + triangle * 3, lodIndices.begin() + triangle * 3 + 3);
+			}
+
+			lodIndices.swap(largestIndices);
 		}
 
+		// Remap the indices of the level to its own positions, they stay on the CPU after the upload
+		std::unordered_map<unsigned int, unsigned int> occluderVertices;
+
+		occluderIndices.reserve(lodIndices.size());
+		for (unsigned int index : lodIndices)
+		{
+			auto [vertexIt, isNewVertex] = occluderVertices.try_emplace(index, (unsigned int)occluderPositions.size());
+
+			if (isNewVertex)
+				occluderPositions.push_back(vertices[index].position);
+
+			occluderIndices.push_back(vertexIt->second);
+		}
+	}
+
+	bool Mesh::isOccluder() const
+	{
+		return !occluderIndices.empty();
+	}
+
+	const std::vector<Core::Maths::vec3>& Mesh::getOccluderPositions() const
+	{
+		return occluderPositions;
+	}
+
+	const std::vector<unsigned int>& Mesh::getOccluderIndices() const
+	{
+		return occluderIndices;
+	}
+
+	size_t Mesh::getCPUBytes() const
+	{
+		return vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(unsigned int)
+			+ occluderPositions.capacity() * sizeof(Core::Maths::vec3) + occluderIndices.capacity() * sizeof(unsigned int);
+	}
+
+	size_t Mesh::getGPUBytes() const
+	{
+		return vertexRange.count * sizeof(Vertex) + indexRange.count * sizeof(unsigned int);
+	}
+
+	// Attribute indices of an obj face corner
+	struct VertexKey
+	{
+		unsigned int position;
+		unsigned int texCoords;
+		unsigned int normal;
+
+		bool operator==(const VertexKey& other) const = default;
+	};
+
+	struct VertexKeyHash
+	{
+		size_t operator()(const VertexKey& key) const
+		{
+			return (size_t)Utils::hashBytes(&key, sizeof(key));
+		}
+	};
+
+	void Mesh::compute(std::array<unsigned int, 3> offsets, std::vector<Core::Maths::vec3>& positions, std::vector<Core::Maths::vec3>& texCoords, std::vector<Core::Maths::vec3>& normals, std::vector<unsigned int>& faceIndices)
+	{
+		Core::Debug::Tracer::Scope computeScope("Mesh::compute", m_name);
+
+		// Remove the geometry of a previous import
+		vertices.clear();
+		indices.clear();
+
+		// The corners with the same attributes share a single vertex
+		std::unordered_map<VertexKey, unsigned int, VertexKeyHash> vertexIndices;
+
+		for (size_t i = 0; i < faceIndices.size(); i += 3)
+		{
+			VertexKey key = { faceIndices[i] - offsets[0], faceIndices[i + 1] - offsets[1], faceIndices[i + 2] - offsets[2] };
+
+			auto [vertexIt, isNewVertex] = vertexIndices.try_emplace(key, (unsigned int)vertices.size());
+
+			if (isNewVertex)
+			{
+				Vertex vertex;
+				vertex.position = positions[key.position];
+
+				if (!texCoords.empty())
+					vertex.texCoords = texCoords[key.texCoords];
+
+				vertex.normal = normals[key.normal];
+
+				vertices.push_back(vertex);
+			}
+
+			indices.push_back(vertexIt->second);
+		}
+
+		// Accumulate the tangents of the triangles around each vertex, they are normalized by the shaders
 		if (!texCoords.empty())
-		for (size_t i = 0; i < vertices.size(); i += 3)
+		for (size_t i = 0; i < indices.size(); i += 3)
 		{
-			Vertex& vert1 = vertices[i + 0];
-			Vertex& vert2 = vertices[i + 1];
-			Vertex& vert3 = vertices[i + 2];
+			Vertex& vert1 = vertices[indices[i + 0]];
+			Vertex& vert2 = vertices[indices[i + 1]];
+			Vertex& vert3 = vertices[indices[i + 2]];
 
 			const Core::Maths::vec3& deltaPos1 = vert2.position - vert1.position;
 			const Core::Maths::vec3& deltaPos2 = vert3.position - vert1.position;
@@ -94,13 +339,32 @@ namespace Resources
 
 			float f = 1.f / (deltaUV1.u * deltaUV2.v - deltaUV2.u * deltaUV1.v);
 
+			// The triangles without texture area have no tangent
+			if (!std::isfinite(f))
+				continue;
+
 			Core::Maths::vec3 tangent = f * (deltaUV2.v * deltaPos1 - deltaUV1.v * deltaPos2);
 			Core::Maths::vec3 bitangent = f * (deltaUV1.u * deltaPos2 - deltaUV2.u * deltaPos1);
 
-			vert1.tangent = vert2.tangent = vert3.tangent = tangent;
-			vert1.bitangent = vert2.bitangent = vert3.bitangent = bitangent;
+			vert1.tangent += tangent;
+			vert2.tangent += tangent;
+			vert3.tangent += tangent;
+
+			vert1.bitangent += bitangent;
+			vert2.bitangent += bitangent;
+			vert3.bitangent += bitangent;
 		}
 
+		computeBounds();
+
+		// The levels are appended to the indices, after the tangents that only use the full level
+		generateLods();
+
+		computeOccluder();
+
+		if (isLoadCancelled())
+			return;
+
 		// Tell to the RM that the initialization is finished
 		ResourcesManager::addToMainThreadInitializerQueue(this);
 	}
@@ -218,17 +482,23 @@ namespace Resources
 
 	void Mesh::parse(const std::string& toParse, std::array<unsigned int, 3> offsets)
 	{
+		Core::Debug::Tracer::Scope parseScope("Mesh::parse", m_name);
+
 		std::istringstream stringStream(toParse);
 
 		std::vector<Core::Maths::vec3> positions;
 		std::vector<Core::Maths::vec3> texCoords;
 		std::vector<Core::Maths::vec3> normals;
-		std::vector<unsigned int> indices;
+		std::vector<unsigned int> faceIndices;
 		
 		// Parse the attributs
 		std::string line;
 		while (std::getline(stringStream, line))
 		{
+			// Stop parsing if the load has been cancelled
+			if (isLoadCancelled())
+				return;
+
 			std::string_view view = line;
 
 			if (view.starts_with("#") || view == "" || view.starts_with("\n"))
@@ -241,26 +511,39 @@ namespace Resources
 			else if (view.starts_with("vn "))
 				addData(normals, line.substr(3));
 			else if (view.starts_with("f "))
-				addIndices(indices, line.substr(2));
+				addIndices(faceIndices, line.substr(2));
 		}
 
-		compute(offsets, positions, texCoords, normals, indices);
+		compute(offsets, positions, texCoords, normals, faceIndices);
 	}
 
 	void Mesh::draw() const
 	{
-		if (!VAO)
+		if (!isUploaded())
 			return;
 
-		// Bind the mesh's VAO and draw it
-		glBindVertexArray(VAO);
-		glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertices.size() * sizeof(Vertex));
-		glBindVertexArray(0);
+		// Draw the ranges of the mesh from the shared VAO, kept bound for the next meshes
+		LowRenderer::GeometryArena::bind();
+		glDrawElementsBaseVertex(GL_TRIANGLES, lods[0].count, GL_UNSIGNED_INT, (GLvoid*)(indexRange.first * sizeof(unsigned int)), vertexRange.first);
 	}
 
 	void Mesh::mainThreadInitialization()
 	{
-		// Generate the VAO buffer
-		generateVAO();
+		// A reloaded copy gives its geometry to the mesh in use, which keeps its ranges if they still fit
+		if (reloadedMesh)
+		{
+			reloadedMesh->vertices.swap(vertices);
+			reloadedMesh->indices.swap(indices);
+			reloadedMesh->lods.swap(lods);
+			reloadedMesh->occluderPositions.swap(occluderPositions);
+			reloadedMesh->occluderIndices.swap(occluderIndices);
+			reloadedMesh->bounds = bounds;
+
+			reloadedMesh->upload();
+			return;
+		}
+
+		// Copy the geometry to the arena
+		upload();
 	}
 }
\ No newline at end of file
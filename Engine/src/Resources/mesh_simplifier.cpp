@@ -0,0 +1,303 @@
+#include "mesh_simplifier.hpp"
+
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+
+#include "hash.hpp"
+
+namespace Resources
+{
+	// Sum of the squared distances to some planes, as a symmetric 4x4 matrix
+	struct Quadric
+	{
+		double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+		double b2 = 0.0, bc = 0.0, bd = 0.0;
+		double c2 = 0.0, cd = 0.0;
+		double d2 = 0.0;
+
+		void addPlane(double a, double b, double c, double d, double weight)
+		{
+			a2 += weight * a * a; ab += weight * a * b; ac += weight * a * c; ad += weight * a * d;
+			b2 += weight * b * b; bc += weight * b * c; bd += weight * b * d;
+			c2 += weight * c * c; cd += weight * c * d;
+			d2 += weight * d * d;
+		}
+
+		void add(const Quadric& other)
+		{
+			a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+			b2 += other.b2; bc += other.bc; bd += other.bd;
+			c2 += other.c2; cd += other.cd;
+			d2 += other.d2;
+		}
+
+		double getError(const Core::Maths::vec3& p) const
+		{
+			double x = p.x, y = p.y, z = p.z;
+
+			return a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x
+				+ b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y
+				+ c2 * z * z + 2.0 * cd * z
+				+ d2;
+		}
+	};
+
+	// Vertex moved on one of its neighbours
+	struct Collapse
+	{
+		unsigned int from;
+		unsigned int to;
+		double error;
+	};
+
+	struct PositionKey
+	{
+		float x, y, z;
+
+		bool operator==(const PositionKey& other) const = default;
+	};
+
+	struct PositionKeyHash
+	{
+		size_t operator()(const PositionKey& key) const
+		{
+			return (size_t)Utils::hashBytes(&key, sizeof(key));
+		}
+	};
+
+	static uint64_t getEdgeKey(unsigned int a, unsigned int b)
+	{
+		return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+	}
+
+	// Check if moving a vertex keeps the facing of its triangles, the ones that would collapse are ignored
+	static bool isFlipping(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+		const std::vector<unsigned int>& triangles, unsigned int from, unsigned int to, const std::vector<unsigned int>& positionIDs)
+	{
+		const Core::Maths::vec3& newPosition = vertices[to].position;
+
+		for (unsigned int triangle : triangles)
+		{
+			const unsigned int* corners = &indices[triangle * 3];
+
+			if (positionIDs[corners[0]] == positionIDs[to] || positionIDs[corners[1]] == positionIDs[to] || positionIDs[corners[2]] == positionIDs[to])
+				continue;
+
+			Core::Maths::vec3 oldPositions[3] = { vertices[corners[0]].position, vertices[corners[1]].position, vertices[corners[2]].position };
+			Core::Maths::vec3 newPositions[3] = { oldPositions[0], oldPositions[1], oldPositions[2] };
+
+			for (int corner = 0; corner < 3; corner++)
+			{
+				if (corners[corner] == from)
+					newPositions[corner] = newPosition;
+			}
+
+			Core::Maths::vec3 oldNormal = (oldPositions[1] - oldPositions[0]) ^ (oldPositions[2] - oldPositions[0]);
+			Core::Maths::vec3 newNormal = (newPositions[1] - newPositions[0]) ^ (newPositions[2] - newPositions[0]);
+
+			if (Core::Maths::dot(oldNormal, newNormal) <= 0.f)
+				return true;
+		}
+
+		return false;
+	}
+
+	std::vector<unsigned int> simplifyMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, size_t targetIndexCount)
+	{
+		size_t vertexCount = vertices.size();
+
+		// The vertices split by their texture coordinates or their normals share a position
+		std::vector<unsigned int> positionIDs(vertexCount);
+		std::vector<unsigned int> positionVertexCounts;
+		{
+			std::unordered_map<PositionKey, unsigned int, PositionKeyHash> positions;
+
+			for (size_t vertex = 0; vertex < vertexCount; vertex++)
+			{
+				const Core::Maths::vec3& position = vertices[vertex].position;
+				auto [positionIt, isNew] = positions.try_emplace({ position.x, position.y, position.z }, (unsigned int)positions.size());
+
+				if (isNew)
+					positionVertexCounts.push_back(0u);
+
+				positionIDs[vertex] = positionIt->second;
+				positionVertexCounts[positionIt->second]++;
+			}
+		}
+
+		// The seams and the borders are locked, moving them would tear the mesh or its texture
+		std::vector<bool> isLocked(vertexCount, false);
+		{
+			std::unordered_map<uint64_t, unsigned int> edgeTriangleCounts;
+
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				for (int corner = 0; corner < 3; corner++)
+					edgeTriangleCounts[getEdgeKey(positionIDs[indices[i + corner]], positionIDs[indices[i + (corner + 1) % 3]])]++;
+			}
+
+			std::vector<bool> isBorderPosition(positionVertexCounts.size(), false);
+			for (const auto& [edgeKey, triangleCount] : edgeTriangleCounts)
+			{
+				if (triangleCount == 1u)
+				{
+					isBorderPosition[edgeKey >> 32] = true;
+					isBorderPosition[edgeKey & 0xFFFFFFFFu] = true;
+				}
+			}
+
+			for (size_t vertex = 0; vertex < vertexCount; vertex++)
+				isLocked[vertex] = positionVertexCounts[positionIDs[vertex]] > 1u || isBorderPosition[positionIDs[vertex]];
+		}
+
+		// Planes of the triangles around each position, weighted by their area
+		std::vector<Quadric> quadrics(positionVertexCounts.size());
+
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const Core::Maths::vec3& p0 = vertices[indices[i]].position;
+			const Core::Maths::vec3& p1 = vertices[indices[i + 1]].position;
+			const Core::Maths::vec3& p2 = vertices[indices[i + 2]].position;
+
+			Core::Maths::vec3 normal = (p1 - p0) ^ (p2 - p0);
+			float doubleArea = normal.magnitude();
+
+			if (doubleArea <= 0.f)
+				continue;
+
+			normal = normal / doubleArea;
+
+			Quadric quadric;
+			quadric.addPlane(normal.x, normal.y, normal.z, -Core::Maths::dot(normal, p0), doubleArea * 0.5f);
+
+			for (int corner = 0; corner < 3; corner++)
+				quadrics[positionIDs[indices[i + corner]]].add(quadric);
+		}
+
+		std::vector<unsigned int> result = indices;
+		std::vector<unsigned int> remap(vertexCount);
+
+		std::vector<Collapse> collapses;
+		std::vector<unsigned int> triangleOffsets;
+		std::vector<unsigned int> vertexTriangles;
+		std::vector<bool> isTouched;
+		std::vector<unsigned int> triangles;
+
+		while (result.size() > targetIndexCount)
+		{
+			// Each edge of the remaining triangles can move one of its vertices on the other
+			collapses.clear();
+
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (int corner = 0; corner < 3; corner++)
+				{
+					unsigned int from = result[i + corner];
+					unsigned int to = result[i + (corner + 1) % 3];
+
+					for (int direction = 0; direction < 2; direction++, std::swap(from, to))
+					{
+						if (isLocked[from])
+							continue;
+
+						Quadric quadric = quadrics[positionIDs[from]];
+						quadric.add(quadrics[positionIDs[to]]);
+
+						collapses.push_back({ from, to, quadric.getError(vertices[to].position) });
+					}
+				}
+			}
+
+			if (collapses.empty())
+				break;
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs)
+			{
+				return lhs.error < rhs.error;
+			});
+
+			// Triangles around each vertex, packed after the offset of the vertex
+			triangleOffsets.assign(vertexCount + 1, 0u);
+			for (unsigned int index : result)
+				triangleOffsets[index + 1]++;
+
+			for (size_t vertex = 0; vertex < vertexCount; vertex++)
+				triangleOffsets[vertex + 1] += triangleOffsets[vertex];
+
+			vertexTriangles.resize(result.size());
+			{
+				std::vector<unsigned int> fillOffsets(triangleOffsets.begin(), triangleOffsets.end() - 1);
+
+				for (size_t i = 0; i < result.size(); i++)
+					vertexTriangles[fillOffsets[result[i]]++] = (unsigned int)(i / 3);
+			}
+
+			for (size_t vertex = 0; vertex < vertexCount; vertex++)
+				remap[vertex] = (unsigned int)vertex;
+
+			// Apply the cheapest collapses, a vertex changed in this pass waits for the next one
+			isTouched.assign(vertexCount, false);
+
+			size_t trianglesToRemove = (result.size() - targetIndexCount + 2) / 3;
+			size_t removedTriangles = 0u;
+
+			for (const Collapse& collapse : collapses)
+			{
+				if (isTouched[collapse.from] || isTouched[collapse.to])
+					continue;
+
+				triangles.assign(vertexTriangles.begin() + triangleOffsets[collapse.from], vertexTriangles.begin() + triangleOffsets[collapse.from + 1]);
+
+				if (isFlipping(vertices, result, triangles, collapse.from, collapse.to, positionIDs))
+					continue;
+
+				remap[collapse.from] = collapse.to;
+				quadrics[positionIDs[collapse.to]].add(quadrics[positionIDs[collapse.from]]);
+
+				// The neighbours keep the triangles that were tested
+				for (unsigned int triangle : triangles)
+				{
+					bool isCollapsed = false;
+
+					for (int corner = 0; corner < 3; corner++)
+					{
+						unsigned int index = result[triangle * 3 + corner];
+
+						isTouched[index] = true;
+						isCollapsed |= positionIDs[index] == positionIDs[collapse.to];
+					}
+
+					removedTriangles += isCollapsed ? 1u : 0u;
+				}
+
+				if (removedTriangles >= trianglesToRemove)
+					break;
+			}
+
+			if (removedTriangles == 0u)
+				break;
+
+			// Move the collapsed vertices and remove the triangles that lost their area
+			size_t writeIndex = 0u;
+
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				unsigned int a = remap[result[i]];
+				unsigned int b = remap[result[i + 1]];
+				unsigned int c = remap[result[i + 2]];
+
+				if (positionIDs[a] == positionIDs[b] || positionIDs[b] == positionIDs[c] || positionIDs[a] == positionIDs[c])
+					continue;
+
+				result[writeIndex++] = a;
+				result[writeIndex++] = b;
+				result[writeIndex++] = c;
+			}
+
+			result.resize(writeIndex);
+		}
+
+		return result;
+	}
+}
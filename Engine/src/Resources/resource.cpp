@@ -1,11 +1,18 @@
 #include "resource.hpp"
 
+#include "resources_manager.hpp"
+
 #include "utils.hpp"
 
 namespace Resources
 {
+	Resource::Resource()
+		: loadToken(ResourcesManager::getLoadToken())
+	{
+	}
+
 	Resource::Resource(const std::string& filePath)
-		: m_filePath(filePath), m_name(Utils::getFileNameFromPath(filePath))
+		: m_filePath(filePath), loadToken(ResourcesManager::getLoadToken()), m_name(Utils::getFileNameFromPath(filePath))
 	{
 	}
 
@@ -13,4 +20,19 @@ namespace Resources
 	{
 		return m_filePath;
 	}
+
+	bool Resource::isLoadCancelled() const
+	{
+		return loadToken.isCancelled();
+	}
+
+	void Resource::setKeepCPUData(bool keep)
+	{
+		keepCPUData = keep;
+	}
+
+	bool Resource::isCPUDataKept() const
+	{
+		return keepCPUData;
+	}
 }
\ No newline at end of file
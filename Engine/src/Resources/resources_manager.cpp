@@ -1,6 +1,8 @@
 #include "resources_manager.hpp"
 
 #include <fstream>
+#include <sstream>
+#include <algorithm>
 
 #include <imgui.h>
 
@@ -8,6 +10,7 @@
 
 #include "maths.hpp"
 #include "utils.hpp"
+#include "hash.hpp"
 
 namespace Resources
 {
@@ -56,11 +59,15 @@ namespace Resources
 
 		Multithread::ThreadManager::init("load", workerCount);
 
+		// The persistent resources can not be cancelled by a scene switch
+		Multithread::CancellationToken::Scope persistentScope(RM->persistentToken);
+
 		// Set the shader program
 		loadShaderProgram("shader", "resources/shaders/vertexShader.vert", "resources/shaders/fragmentShader.frag", "", true);
 		loadShaderProgram("skyBox", "resources/shaders/skyBox.vert", "resources/shaders/skyBox.frag", "", true);
-		loadShaderProgram("colliderShader", "resources/shaders/vertexCollider.vert", "resources/shaders/fragmentCollider.frag", "", true);
+		loadShaderProgram("debugLineShader", "resources/shaders/debugLine.vert", "resources/shaders/debugLine.frag", "", true);
 		loadShaderProgram("spriteShader", "resources/shaders/spriteVertex.vert", "resources/shaders/spriteFragment.frag", "", true);
+		loadShaderProgram("textShader", "resources/shaders/textShader.vert", "resources/shaders/textShader.frag", "", true);
 		loadShaderProgram("depthShader", "resources/shaders/depthShader.vert", "resources/shaders/depthShader.frag", "", true);
 		loadShaderProgram("depthCubeShader", "resources/shaders/depthCubeShader.vert", "resources/shaders/depthShader.frag", "resources/shaders/depthCubeShader.geom", true);
 
@@ -68,8 +75,6 @@ namespace Resources
 		loadObj("resources/obj/cube.obj", true);
 		loadObj("resources/obj/sphere.obj", true);
 		loadObj("resources/obj/plane.obj", true);
-		loadObj("resources/obj/colliders/boxCollider.obj", true);
-		loadObj("resources/obj/colliders/sphereCollider.obj", true);
 
 		// Set default textures and materials
 		RM->setDefaultResources();
@@ -77,21 +82,95 @@ namespace Resources
 
 	void ResourcesManager::clearResources()
 	{
-		instance()->toInitInMainThread.clear();
+		// Only the persistent resources are kept in the initialization queue
+		instance()->toInitInMainThread.eraseIf([](Resource* resource) { return resource->isLoadCancelled(); });
 	}
 
 	void ResourcesManager::purgeResources()
 	{
 		ResourcesManager* RM = instance();
 
+		// Release the aliases first so the resources they share can be purged
+		RM->purgeContentAliases();
+
 		RM->purgeMap(RM->materials, RM->lockMaterials);
 		RM->purgeMap(RM->textures, RM->lockTextures);
 		RM->purgeMap(RM->cubeMaps, RM->lockCubemaps);
 		RM->purgeMap(RM->meshes, RM->lockMeshes);
+		RM->purgeMap(RM->fonts, RM->lockFonts);
 		RM->purgeMap(RM->shaders);
 		RM->purgeMap(RM->shaderPrograms);
+
+		// The obj aliases are released with the meshes they share
+		RM->purgeContentAliases();
  	}
 
+	void ResourcesManager::purgeCancelledResources()
+	{
+		ResourcesManager* RM = instance();
+
+		// Remove the unused resources created by a cancelled load, they may be partially loaded
+		RM->purgeContentAliases(true);
+		RM->purgeMap(RM->materials, RM->lockMaterials, true);
+		RM->purgeMap(RM->textures, RM->lockTextures, true);
+		RM->purgeMap(RM->cubeMaps, RM->lockCubemaps, true);
+		RM->purgeMap(RM->meshes, RM->lockMeshes, true);
+		RM->purgeMap(RM->fonts, RM->lockFonts, true);
+		RM->purgeContentAliases(true);
+
+		// The reloads of a cancelled load never reach the main thread
+		while (RM->lockStagedResources.test_and_set());
+		std::erase_if(RM->stagedResources, [](const std::shared_ptr<Resource>& resourcePtr) { return resourcePtr->isLoadCancelled(); });
+		RM->lockStagedResources.clear();
+	}
+
+	void ResourcesManager::cancelLoading()
+	{
+		ResourcesManager* RM = instance();
+
+		// Tasks may still be queued once the load is marked as finished
+		bool wasLoading = RM->isLoading || !Multithread::ThreadManager::isEmpty("load");
+
+		if (wasLoading)
+		{
+			Core::Debug::Log::info("Cancelling the loading of the previous scene");
+
+			// Stop the current load and start a new one
+			RM->loadToken.cancel();
+			RM->loadToken = Multithread::CancellationToken::create();
+		}
+
+		RM->isLoading = false;
+
+		// Discard the queued tasks and wait for the running ones to reach a safe point
+		Multithread::ThreadManager::discardCancelled("load");
+		Multithread::ThreadManager::sync("load");
+
+		if (wasLoading)
+			Core::Debug::Tracer::endTrace("cancelled");
+	}
+
+	const Multithread::CancellationToken& ResourcesManager::getLoadToken()
+	{
+		// Tasks keep the token they have been added with
+		const Multithread::CancellationToken* currentToken = Multithread::CancellationToken::getCurrent();
+
+		if (currentToken)
+			return *currentToken;
+
+		return instance()->loadToken;
+	}
+
+	bool ResourcesManager::isLoadCancelled()
+	{
+		return getLoadToken().isCancelled();
+	}
+
+	bool ResourcesManager::isLoadInProgress()
+	{
+		return instance()->isLoading;
+	}
+
 	std::shared_ptr<Shader> ResourcesManager::loadShader(const std::string& shaderPath, bool setAsPersistent)
 	{
 		ResourcesManager* RM = instance();
@@ -132,6 +211,20 @@ namespace Resources
 		return programPtr;
 	}
 
+	void ResourcesManager::addStagedResource(const std::shared_ptr<Resource>& resourcePtr)
+	{
+		while (lockStagedResources.test_and_set());
+		stagedResources.push_back(resourcePtr);
+		lockStagedResources.clear();
+	}
+
+	void ResourcesManager::releaseStagedResource(const Resource* resource)
+	{
+		while (lockStagedResources.test_and_set());
+		std::erase_if(stagedResources, [resource](const std::shared_ptr<Resource>& resourcePtr) { return resourcePtr.get() == resource; });
+		lockStagedResources.clear();
+	}
+
 	void ResourcesManager::addToMainThreadInitializerQueue(Resource* resourcePtr)
 	{
 		ResourcesManager* RM = instance();
@@ -148,8 +241,19 @@ namespace Resources
 		while (!RM->toInitInMainThread.empty())
 		{
 			Resource* resource = nullptr;
-			if (RM->toInitInMainThread.tryPop(resource))
+
+			if (!RM->toInitInMainThread.tryPop(resource))
+				continue;
+
+			// Skip the resources of a cancelled load
+			if (!resource->isLoadCancelled())
+			{
+				Core::Debug::Tracer::Scope uploadScope("GL upload", resource->m_name);
 				resource->mainThreadInitialization();
+			}
+
+			// A reloaded copy is no longer needed once it is swapped
+			RM->releaseStagedResource(resource);
 		}
 
 		if (checkLoadEnd())
@@ -169,7 +273,13 @@ namespace Resources
 
 		RM->isLoading = false;
 
+		// The next load gets its own token, cancelling it keeps the resources of this one
+		RM->loadToken = Multithread::CancellationToken::create();
+
 		Core::Debug::Benchmarker::stopChrono("load");
+		Core::Debug::Tracer::endTrace();
+
+		logDeduplicationReport();
 
 		auto totalDuration = Core::Debug::Benchmarker::getDuration("load");
 		std::string totalDurationString = std::to_string(totalDuration.count() * 1000);
@@ -189,17 +299,33 @@ namespace Resources
 		return true;
 	}
 
-	std::shared_ptr<Font> ResourcesManager::loadFont(const std::string& fontPath)
+	std::shared_ptr<Font> ResourcesManager::loadFont(const std::string& fontPath, int pixelSize, bool isSDF)
 	{
 		ResourcesManager* RM = instance();
 
-		const auto& fontIt = RM->fonts.find(fontPath);
+		// A font is rasterized once for each size and mode
+		std::string fontKey = fontPath + ':' + std::to_string(pixelSize) + (isSDF ? ":sdf" : "");
 
-		// Check if the Texture is already loaded
+		while (RM->lockFonts.test_and_set());
+
+		const auto& fontIt = RM->fonts.find(fontKey);
+
+		// Check if the Font is already loaded
 		if (fontIt != RM->fonts.end())
+		{
+			RM->lockFonts.clear();
 			return fontIt->second;
+		}
+
+		std::shared_ptr<Font> fontPtr = RM->fonts[fontKey] = std::make_shared<Font>(fontPath, pixelSize, isSDF);
+		fontPtr->setKeepCPUData(RM->isCPUResident(fontPath));
+
+		RM->lockFonts.clear();
 
-		return RM->fonts[fontPath] = std::make_shared<Font>(fontPath);
+		// Rasterize and pack its glyphs with the threading system
+		manageTask(&Font::generateAtlas, fontPtr.get());
+
+		return fontPtr;
 	}
 
 	std::shared_ptr<Texture> ResourcesManager::loadTexture(const std::string& texturePath, bool setAsPersistent)
@@ -217,8 +343,9 @@ namespace Resources
 			return textureIt->second;
 		}
 
-		// Create the texture if it does not exist
+		// Create the texture if it does not exist, its load task reads and hashes the file
 		std::shared_ptr<Texture> texturePtr(new Texture(texturePath));
+		texturePtr->setKeepCPUData(RM->isCPUResident(texturePath));
 
 		if (setAsPersistent)
 		{
@@ -281,7 +408,7 @@ namespace Resources
 
 		ResourcesManager* RM = instance();
 
-		while (!RM->lockCubemaps.test_and_set());
+		while (RM->lockCubemaps.test_and_set());
 
 		std::string pathsDir = Utils::getDirectory(cubeMapPaths.back());
 		const auto& cubeMapIt = RM->cubeMaps.find(pathsDir);
@@ -295,6 +422,7 @@ namespace Resources
 
 		// If the cubemap is persistent, add it to the persistent resources vector
 		std::shared_ptr<CubeMap> cubeMapPtr(new CubeMap(cubeMapPaths));
+		cubeMapPtr->setKeepCPUData(RM->isCPUResident(pathsDir));
 
 		if (setAsPersistent)
 		{
@@ -309,12 +437,68 @@ namespace Resources
 
 		RM->lockCubemaps.clear();
 
-		// Generate its buffers with the threading system
-		manageTask(&CubeMap::generateBuffers, cubeMapPtr.get());
+		// Generate its buffers with the threading system, one task per face
+		cubeMapPtr->generateBuffers();
 
 		return cubeMapPtr;
 	}
 
+	std::shared_ptr<Texture> ResourcesManager::resolveTextureContent(const std::string& texturePath, uint64_t contentHash)
+	{
+		ResourcesManager* RM = instance();
+
+		if (!RM->contentDeduplication)
+			return nullptr;
+
+		while (RM->lockTextures.test_and_set());
+
+		std::shared_ptr<Texture> sharedPtr = RM->findSharedContent(RM->textureContents, RM->textures, contentHash);
+
+		// The first path read with this content owns it
+		if (!sharedPtr || sharedPtr->getPath() == texturePath)
+		{
+			RM->textureContents[contentHash] = texturePath;
+			RM->lockTextures.clear();
+			return nullptr;
+		}
+
+		// The next loads of the path get the shared texture directly
+		RM->textures[texturePath] = sharedPtr;
+		RM->lockTextures.clear();
+
+		RM->addContentAlias(ContentType::TEXTURE, texturePath, sharedPtr->getPath());
+
+		return sharedPtr;
+	}
+
+	std::shared_ptr<CubeMap> ResourcesManager::resolveCubeMapContent(const std::string& pathsDir, uint64_t contentHash)
+	{
+		ResourcesManager* RM = instance();
+
+		if (!RM->contentDeduplication)
+			return nullptr;
+
+		while (RM->lockCubemaps.test_and_set());
+
+		std::shared_ptr<CubeMap> sharedPtr = RM->findSharedContent(RM->cubeMapContents, RM->cubeMaps, contentHash);
+		std::string sharedDir = sharedPtr ? Utils::getDirectory(sharedPtr->getPaths().back()) : "";
+
+		// The first skybox read with these six images owns them
+		if (!sharedPtr || sharedDir == pathsDir)
+		{
+			RM->cubeMapContents[contentHash] = pathsDir;
+			RM->lockCubemaps.clear();
+			return nullptr;
+		}
+
+		RM->cubeMaps[pathsDir] = sharedPtr;
+		RM->lockCubemaps.clear();
+
+		RM->addContentAlias(ContentType::CUBEMAP, pathsDir, sharedDir);
+
+		return sharedPtr;
+	}
+
 	std::shared_ptr<Material> ResourcesManager::loadMaterial(const std::string& materialPath, bool setAsPersistent)
 	{
 		ResourcesManager* RM = instance();
@@ -371,6 +555,11 @@ namespace Resources
 
 	// Load an obj with mtl (do triangulation)
 	void ResourcesManager::loadObj(std::string filePath, bool setAsPersistent)
+	{
+		importObj(filePath, setAsPersistent, false);
+	}
+
+	void ResourcesManager::importObj(const std::string& filePath, bool setAsPersistent, bool isReload)
 	{
 		std::string correctPath = getResourcesPath() + filePath;
 
@@ -388,8 +577,8 @@ namespace Resources
 
 		while (RM->lockMeshChildren.test_and_set());
 
-		// Check if the object is already loaded
-		if (RM->childrenMeshes.find(filePath) != RM->childrenMeshes.end())
+		// Check if the object is already loaded, a reload keeps the mesh children that the models read
+		if (!isReload && RM->childrenMeshes.find(filePath) != RM->childrenMeshes.end())
 		{
 			Core::Debug::Log::info("Model at " + filePath + " is already loaded");
 			RM->lockMeshChildren.clear();
@@ -398,6 +587,41 @@ namespace Resources
 
 		RM->lockMeshChildren.clear();
 
+		// Read the whole file before scanning it
+		std::stringstream objStream;
+		{
+			Core::Debug::Tracer::Scope readScope("File read", filePath);
+			objStream << dataObj.rdbuf();
+		}
+
+		// An obj with the same content as a loaded one shares its meshes and materials
+		uint64_t contentHash = 0u;
+		bool isHashed = RM->contentDeduplication && !isReload;
+
+		if (isHashed)
+		{
+			std::string objContent = objStream.str();
+			contentHash = Utils::hashBytes(objContent.data(), objContent.size());
+
+			while (RM->lockMeshChildren.test_and_set());
+
+			auto contentIt = RM->objContents.find(contentHash);
+			auto sharedChildrenIt = contentIt != RM->objContents.end() ? RM->childrenMeshes.find(contentIt->second) : RM->childrenMeshes.end();
+
+			if (sharedChildrenIt != RM->childrenMeshes.end())
+			{
+				std::string sharedPath = contentIt->second;
+				RM->childrenMeshes[filePath] = sharedChildrenIt->second;
+				RM->lockMeshChildren.clear();
+
+				RM->addContentAlias(ContentType::OBJ, filePath, sharedPath);
+				Core::Debug::Log::info("Obj " + filePath + " has the same content as " + sharedPath + ", its meshes are shared");
+				return;
+			}
+
+			RM->lockMeshChildren.clear();
+		}
+
 		Core::Debug::Log::info("Start loading obj " + filePath);
 
 		std::string dirPath = Utils::getDirectory(filePath);
@@ -413,8 +637,14 @@ namespace Resources
 		std::array<unsigned int, 3> countArray{ 0u, 0u, 0u };
 		std::array<unsigned int, 3> lastCountArray{ 0u, 0u, 0u };
 
-		for (std::string line; std::getline(dataObj, line);)
+		Core::Debug::Tracer::Scope scanScope("OBJ scan", filePath);
+
+		for (std::string line; std::getline(objStream, line);)
 		{
+			// Stop reading if the load has been cancelled
+			if (isLoadCancelled())
+				return;
+
 			meshSubString += line + '\n';
 
 			std::istringstream iss(line);
@@ -432,7 +662,7 @@ namespace Resources
 				if (meshPtr)
 				{
 					// Parse the current mesh with the substring and the offsets
-					manageTask(&Mesh::parse, meshPtr.get(), meshSubString, lastCountArray);
+					manageImportTask(isReload, &Mesh::parse, meshPtr.get(), meshSubString, lastCountArray);
 					meshPtr = nullptr;
 				}
 
@@ -441,10 +671,13 @@ namespace Resources
 
 				while (RM->lockMeshes.test_and_set());
 
+				auto meshIt = RM->meshes.find(meshName);
+
 				// Compute and add the mesh
-				if (RM->meshes.find(meshName) == RM->meshes.end())
+				if (meshIt == RM->meshes.end())
 				{
 					meshPtr = RM->meshes[meshName] = std::make_shared<Mesh>(meshName, filePath);
+					meshPtr->setKeepCPUData(RM->isCPUResident(filePath));
 
 					if (setAsPersistent)
 					{
@@ -456,15 +689,16 @@ namespace Resources
 						RM->lockPersistentResources.clear();
 					}
 				}
+				// Parse a copy of the existing mesh when reloading, the renderer keeps reading the mesh in use
+				else if (isReload)
+				{
+					meshPtr = std::make_shared<Mesh>(meshIt->second);
+					RM->addStagedResource(meshPtr);
+				}
 
 				RM->lockMeshes.clear();
 
-				while (RM->lockMeshChildren.test_and_set());
-
-				// Set the dependency with the meshes
-				RM->childrenMeshes[filePath].push_back(meshName);
-
-				RM->lockMeshChildren.clear();
+				RM->addMeshChild(filePath, meshName);
 			}
 			// Count the attributs offsets for the mesh parsing
 			else if (type == "v")
@@ -494,7 +728,7 @@ namespace Resources
 				iss >> mtlName;
 
 				// Load mtl file
-				manageTask(&ResourcesManager::loadMaterials, dirPath, mtlName);
+				manageImportTask(isReload, &ResourcesManager::importMtl, dirPath, mtlName, isReload);
 			}
 		}
 
@@ -502,8 +736,10 @@ namespace Resources
 		{
 			while (RM->lockMeshes.test_and_set());
 
+			auto meshIt = RM->meshes.find(meshName);
+
 			// Compute and add the mesh
-			if (RM->meshes.find(meshName) == RM->meshes.end())
+			if (meshIt == RM->meshes.end())
 			{
 				meshPtr = RM->meshes[meshName] = std::make_shared<Mesh>(meshName, filePath);
 
@@ -517,23 +753,43 @@ namespace Resources
 					RM->lockPersistentResources.clear();
 				}
 			}
+			else if (isReload)
+			{
+				meshPtr = std::make_shared<Mesh>(meshIt->second);
+				RM->addStagedResource(meshPtr);
+			}
 
 			RM->lockMeshes.clear();
 
-			while (RM->lockMeshChildren.test_and_set());
+			RM->addMeshChild(filePath, meshName);
+		}
 
-			// Set the dependency with the meshes
-			RM->childrenMeshes[filePath].push_back(meshName);
+		if (meshPtr)
+			manageImportTask(isReload, &Mesh::parse, meshPtr.get(), meshSubString, lastCountArray);
 
+		// Share the meshes only once all of them are listed
+		if (isHashed)
+		{
+			while (RM->lockMeshChildren.test_and_set());
+			RM->objContents[contentHash] = filePath;
 			RM->lockMeshChildren.clear();
 		}
 
-		if (meshPtr)
-			manageTask(&Mesh::parse, meshPtr.get(), meshSubString, lastCountArray);
-
 		Core::Debug::Log::info("Finish loading obj " + filePath);
 	}
 
+	void ResourcesManager::addMeshChild(const std::string& filePath, const std::string& meshName)
+	{
+		while (lockMeshChildren.test_and_set());
+
+		// Set the dependency with the meshes, once even if the obj is reloaded
+		std::vector<std::string>& meshNames = childrenMeshes[filePath];
+		if (std::find(meshNames.begin(), meshNames.end(), meshName) == meshNames.end())
+			meshNames.push_back(meshName);
+
+		lockMeshChildren.clear();
+	}
+
 	std::vector<std::string>* ResourcesManager::getMeshNames(const std::string& filePath)
 	{
 		ResourcesManager* RM = instance();
@@ -585,7 +841,13 @@ namespace Resources
 
 	void ResourcesManager::loadMaterials(const std::string& dirPath, const std::string& mtlName)
 	{
-		std::string filePath = getResourcesPath() + dirPath + mtlName;
+		importMtl(dirPath, mtlName, false);
+	}
+
+	void ResourcesManager::importMtl(const std::string& dirPath, const std::string& mtlName, bool isReload)
+	{
+		std::string mtlPath = dirPath + mtlName;
+		std::string filePath = getResourcesPath() + mtlPath;
 
 		// Check if the file exist
 		std::ifstream dataMat(filePath.c_str());
@@ -596,12 +858,25 @@ namespace Resources
 			return;
 		}
 
+		// Read the whole file before scanning it
+		std::stringstream mtlStream;
+		{
+			Core::Debug::Tracer::Scope readScope("File read", mtlPath);
+			mtlStream << dataMat.rdbuf();
+		}
+
 		ResourcesManager* RM = instance();
 
+		while (RM->lockMaterials.test_and_set());
+		RM->mtlLibraries.insert(mtlPath);
+		RM->lockMaterials.clear();
+
 		std::string matName;
 
 		Core::Debug::Log::info("Loading materials at " + filePath);
 
+		Core::Debug::Tracer::Scope scanScope("MTL scan", mtlPath);
+
 		std::string matSubString;
 
 		// Create an empty ptr for the next material
@@ -609,8 +884,12 @@ namespace Resources
 
 		// Get all mesh materials
 		std::string line;
-		for (std::string line; std::getline(dataMat, line);)
+		for (std::string line; std::getline(mtlStream, line);)
 		{
+			// Stop reading if the load has been cancelled
+			if (isLoadCancelled())
+				return;
+
 			matSubString += line + '\n';
 
 			std::istringstream iss(line);
@@ -623,7 +902,7 @@ namespace Resources
 			if (matPtr)
 			{
 				// Parse the current material with the substring
-				manageTask(&Material::parse, matPtr.get(), matSubString, dirPath);
+				manageImportTask(isReload, &Material::parse, matPtr.get(), matSubString, dirPath);
 				matPtr = nullptr;
 			}
 
@@ -638,6 +917,12 @@ namespace Resources
 			// Check if the material is already loaded
 			if (matIt == RM->materials.end())
 				matPtr = RM->materials[matName] = std::make_shared<Material>(matName);
+			// Parse a copy of the existing material when reloading, the renderer keeps reading the material in use
+			else if (isReload)
+			{
+				matPtr = std::make_shared<Material>(matIt->second);
+				RM->addStagedResource(matPtr);
+			}
 			else
 				matPtr = matIt->second;
 
@@ -646,7 +931,284 @@ namespace Resources
 
 		// Parse the current material with the substring
 		if (matPtr)
-			manageTask(&Material::parse, matPtr.get(), matSubString, dirPath);
+			manageImportTask(isReload, &Material::parse, matPtr.get(), matSubString, dirPath);
+	}
+
+	void ResourcesManager::reloadFile(const std::string& filePath)
+	{
+		ResourcesManager* RM = instance();
+
+		// A deduplicated path uses the resource of another file, it cannot be reloaded in place
+		std::string sharedPath = RM->getSharedPath(filePath);
+		if (!sharedPath.empty())
+		{
+			Core::Debug::Log::warning(filePath + " shares the content of " + sharedPath + ", it is not hot reloaded");
+			return;
+		}
+
+		bool isReloaded = false;
+
+		// Decode the texture again, its GPU object is updated in place
+		while (RM->lockTextures.test_and_set());
+		auto textureIt = RM->textures.find(filePath);
+		std::shared_ptr<Texture> texturePtr = textureIt != RM->textures.end() ? textureIt->second : nullptr;
+		RM->lockTextures.clear();
+
+		if (texturePtr)
+		{
+			texturePtr->reload();
+			isReloaded = true;
+		}
+
+		while (RM->lockCubemaps.test_and_set());
+		for (auto& cubeMapPair : RM->cubeMaps)
+		{
+			const std::vector<std::string>& facePaths = cubeMapPair.second->getPaths();
+
+			if (std::find(facePaths.begin(), facePaths.end(), filePath) == facePaths.end())
+				continue;
+
+			// Skip the deduplicated directories, their cube map is reloaded once with its own
+			if (Utils::getDirectory(facePaths.back()) != cubeMapPair.first)
+				continue;
+
+			cubeMapPair.second->reload();
+			isReloaded = true;
+		}
+		RM->lockCubemaps.clear();
+
+		// Parse the meshes of the obj again, found with its mesh children
+		while (RM->lockMeshChildren.test_and_set());
+		bool isObjLoaded = RM->childrenMeshes.find(filePath) != RM->childrenMeshes.end();
+		RM->lockMeshChildren.clear();
+
+		if (isObjLoaded)
+		{
+			manageReloadTask(&ResourcesManager::importObj, filePath, false, true);
+			isReloaded = true;
+		}
+
+		// Parse the materials of the mtl library again, the meshes keep their materials
+		while (RM->lockMaterials.test_and_set());
+		bool isMtlLoaded = RM->mtlLibraries.find(filePath) != RM->mtlLibraries.end();
+		RM->lockMaterials.clear();
+
+		if (isMtlLoaded)
+		{
+			manageReloadTask(&ResourcesManager::importMtl, Utils::getDirectory(filePath), Utils::getFileNameFromPath(filePath), true);
+			isReloaded = true;
+		}
+
+		// Compile again the programs that use the shader
+		if (RM->shaders.find(filePath) != RM->shaders.end())
+		{
+			for (auto& programPair : RM->shaderPrograms)
+			{
+				if (programPair.second->usesShader(filePath))
+					programPair.second->reload();
+			}
+
+			isReloaded = true;
+		}
+
+		// The next instantiations use the new recipe
+		auto recipeIt = RM->recipes.find(filePath);
+		if (recipeIt != RM->recipes.end())
+		{
+			recipeIt->second->load(filePath);
+			isReloaded = true;
+		}
+
+		if (isReloaded)
+			Core::Debug::Log::info("Hot reloading " + filePath);
+	}
+
+	void ResourcesManager::setKeepCPUData(const std::string& filePath, bool keep)
+	{
+		ResourcesManager* RM = instance();
+
+		while (RM->lockCPUResidentPaths.test_and_set());
+
+		if (keep)
+			RM->cpuResidentPaths.insert(filePath);
+		else
+			RM->cpuResidentPaths.erase(filePath);
+
+		RM->lockCPUResidentPaths.clear();
+
+		// Flag the resources that are already loaded, the released data comes back with a reload
+		while (RM->lockTextures.test_and_set());
+		auto textureIt = RM->textures.find(filePath);
+		if (textureIt != RM->textures.end())
+			textureIt->second->setKeepCPUData(keep);
+		RM->lockTextures.clear();
+
+		while (RM->lockCubemaps.test_and_set());
+		auto cubeMapIt = RM->cubeMaps.find(filePath);
+		if (cubeMapIt != RM->cubeMaps.end())
+			cubeMapIt->second->setKeepCPUData(keep);
+		RM->lockCubemaps.clear();
+
+		while (RM->lockMeshes.test_and_set());
+		for (auto& meshPair : RM->meshes)
+		{
+			if (meshPair.second->parentMeshName == filePath)
+				meshPair.second->setKeepCPUData(keep);
+		}
+		RM->lockMeshes.clear();
+	}
+
+	bool ResourcesManager::isCPUResident(const std::string& filePath)
+	{
+		while (lockCPUResidentPaths.test_and_set());
+		bool isResident = cpuResidentPaths.find(filePath) != cpuResidentPaths.end();
+		lockCPUResidentPaths.clear();
+
+		return isResident;
+	}
+
+	void ResourcesManager::addContentAlias(ContentType type, const std::string& path, const std::string& sharedPath)
+	{
+		while (lockContentAliases.test_and_set());
+		contentAliases.push_back({ type, path, sharedPath });
+		lockContentAliases.clear();
+	}
+
+	std::string ResourcesManager::getSharedPath(const std::string& path)
+	{
+		std::string sharedPath;
+
+		while (lockContentAliases.test_and_set());
+
+		auto aliasIt = std::find_if(contentAliases.begin(), contentAliases.end(), [&path](const ContentAlias& alias) { return alias.path == path; });
+		if (aliasIt != contentAliases.end())
+			sharedPath = aliasIt->sharedPath;
+
+		lockContentAliases.clear();
+
+		return sharedPath;
+	}
+
+	size_t ResourcesManager::getSavedBytes(const ContentAlias& alias)
+	{
+		size_t savedBytes = 0u;
+
+		switch (alias.type)
+		{
+		case ContentType::TEXTURE:
+		{
+			while (lockTextures.test_and_set());
+			auto textureIt = textures.find(alias.sharedPath);
+			if (textureIt != textures.end())
+				savedBytes = textureIt->second->getDecodedSize();
+			lockTextures.clear();
+			break;
+		}
+
+		case ContentType::CUBEMAP:
+		{
+			while (lockCubemaps.test_and_set());
+			auto cubeMapIt = cubeMaps.find(alias.sharedPath);
+			if (cubeMapIt != cubeMaps.end())
+				savedBytes = cubeMapIt->second->getDecodedSize();
+			lockCubemaps.clear();
+			break;
+		}
+
+		case ContentType::OBJ:
+		{
+			while (lockMeshChildren.test_and_set());
+			auto childrenIt = childrenMeshes.find(alias.sharedPath);
+			std::vector<std::string> meshNames = childrenIt != childrenMeshes.end() ? childrenIt->second : std::vector<std::string>();
+			lockMeshChildren.clear();
+
+			// Named objects are shared by name anyway, only the meshes named after the file would be duplicated
+			while (lockMeshes.test_and_set());
+			for (const std::string& meshName : meshNames)
+			{
+				auto meshIt = meshes.find(meshName);
+				if (meshName == alias.sharedPath && meshIt != meshes.end())
+					savedBytes += meshIt->second->getGPUBytes();
+			}
+			lockMeshes.clear();
+			break;
+		}
+		}
+
+		return savedBytes;
+	}
+
+	void ResourcesManager::purgeContentAliases(bool cancelledOnly)
+	{
+		while (lockContentAliases.test_and_set());
+
+		std::erase_if(contentAliases, [this, cancelledOnly](const ContentAlias& alias)
+		{
+			switch (alias.type)
+			{
+			case ContentType::TEXTURE:
+				return purgeAlias(textures, lockTextures, alias.path, cancelledOnly);
+
+			case ContentType::CUBEMAP:
+				return purgeAlias(cubeMaps, lockCubemaps, alias.path, cancelledOnly);
+
+			case ContentType::OBJ:
+			{
+				while (lockMeshChildren.test_and_set());
+
+				// The obj alias is released once the meshes it shares have been purged
+				bool isUnused = childrenMeshes.find(alias.sharedPath) == childrenMeshes.end();
+				if (isUnused)
+					childrenMeshes.erase(alias.path);
+
+				lockMeshChildren.clear();
+
+				return isUnused;
+			}
+			}
+
+			return false;
+		});
+
+		lockContentAliases.clear();
+	}
+
+	size_t ResourcesManager::getDeduplicationSavedBytes()
+	{
+		ResourcesManager* RM = instance();
+
+		while (RM->lockContentAliases.test_and_set());
+		std::vector<ContentAlias> aliases = RM->contentAliases;
+		RM->lockContentAliases.clear();
+
+		size_t savedBytes = 0u;
+		for (const ContentAlias& alias : aliases)
+			savedBytes += RM->getSavedBytes(alias);
+
+		return savedBytes;
+	}
+
+	void ResourcesManager::logDeduplicationReport()
+	{
+		ResourcesManager* RM = instance();
+
+		while (RM->lockContentAliases.test_and_set());
+		std::vector<ContentAlias> aliases = RM->contentAliases;
+		RM->lockContentAliases.clear();
+
+		if (aliases.empty())
+			return;
+
+		size_t totalSavedBytes = 0u;
+		for (const ContentAlias& alias : aliases)
+		{
+			size_t savedBytes = RM->getSavedBytes(alias);
+			totalSavedBytes += savedBytes;
+
+			Core::Debug::Log::info(alias.path + " shares the content of " + alias.sharedPath + ", saving " + std::to_string(savedBytes / 1024) + " KB");
+		}
+
+		Core::Debug::Log::info("Content deduplication shared " + std::to_string(aliases.size()) + " paths and saved " + std::to_string(totalSavedBytes / 1024) + " KB of decoded data");
 	}
 
 	std::string ResourcesManager::getResourcesPath()
@@ -677,6 +1239,87 @@ namespace Resources
 				for (auto& materialPtr : RM->materials)
 					materialPtr.second->drawImGui();
 			}
+
+			if (ImGui::CollapsingHeader("Residency:"))
+			{
+				std::unordered_set<const Resource*> countedResources;
+
+				auto drawResidentBytes = [&countedResources](const std::string& label, auto& map, std::atomic_flag& mapFlag)
+				{
+					size_t cpuBytes = 0u, gpuBytes = 0u;
+					instance()->addResidentBytes(map, mapFlag, countedResources, cpuBytes, gpuBytes);
+
+					std::string bytesString = label + ": CPU = " + std::to_string(cpuBytes / 1024) + " KB, GPU = " + std::to_string(gpuBytes / 1024) + " KB";
+					ImGui::Text(bytesString.c_str());
+
+					return std::make_pair(cpuBytes, gpuBytes);
+				};
+
+				auto textureBytes = drawResidentBytes("Textures", RM->textures, RM->lockTextures);
+				auto cubeMapBytes = drawResidentBytes("Cube maps", RM->cubeMaps, RM->lockCubemaps);
+				auto meshBytes = drawResidentBytes("Meshes", RM->meshes, RM->lockMeshes);
+				auto fontBytes = drawResidentBytes("Fonts", RM->fonts, RM->lockFonts);
+
+				size_t totalCPUBytes = textureBytes.first + cubeMapBytes.first + meshBytes.first + fontBytes.first;
+				size_t totalGPUBytes = textureBytes.second + cubeMapBytes.second + meshBytes.second + fontBytes.second;
+
+				std::string totalString = "Total: CPU = " + std::to_string(totalCPUBytes / 1024) + " KB, GPU = " + std::to_string(totalGPUBytes / 1024) + " KB";
+				ImGui::Text(totalString.c_str());
+
+				if (ImGui::TreeNode("Keep CPU data"))
+				{
+					// Copy the paths, changing the residency locks the resources again
+					std::vector<std::string> filePaths;
+
+					while (RM->lockTextures.test_and_set());
+					for (const auto& texturePair : RM->textures)
+						filePaths.push_back(texturePair.first);
+					RM->lockTextures.clear();
+
+					while (RM->lockMeshChildren.test_and_set());
+					for (const auto& childrenPair : RM->childrenMeshes)
+						filePaths.push_back(childrenPair.first);
+					RM->lockMeshChildren.clear();
+
+					for (const std::string& filePath : filePaths)
+					{
+						bool keep = RM->isCPUResident(filePath);
+
+						if (!ImGui::Checkbox(filePath.c_str(), &keep))
+							continue;
+
+						setKeepCPUData(filePath, keep);
+
+						// The data already released comes back with a reload
+						if (keep)
+							reloadFile(filePath);
+					}
+
+					ImGui::TreePop();
+				}
+			}
+
+			if (ImGui::CollapsingHeader("Content deduplication:"))
+			{
+				ImGui::Checkbox("Share identical resources", &RM->contentDeduplication);
+
+				while (RM->lockContentAliases.test_and_set());
+				std::vector<ContentAlias> aliases = RM->contentAliases;
+				RM->lockContentAliases.clear();
+
+				size_t totalSavedBytes = 0u;
+				for (const ContentAlias& alias : aliases)
+				{
+					size_t savedBytes = RM->getSavedBytes(alias);
+					totalSavedBytes += savedBytes;
+
+					std::string aliasString = alias.path + " -> " + alias.sharedPath + " (" + std::to_string(savedBytes / 1024) + " KB)";
+					ImGui::Text(aliasString.c_str());
+				}
+
+				std::string savedString = "Saved memory = " + std::to_string(totalSavedBytes / 1024) + " KB";
+				ImGui::Text(savedString.c_str());
+			}
 		}
 		ImGui::End();
 	}
@@ -13,6 +13,7 @@
 #include "physic_manager.hpp"
 #include "inputs_manager.hpp"
 #include "thread_pool.hpp"
+#include "binary_scene.hpp"
 #include "debug.hpp"
 
 #include "player_movement.hpp"
@@ -61,6 +62,16 @@ namespace Resources
 
 	void Scene::load(const std::string& _filePath)
 	{
+		if (BinaryScene::isBinaryScene(_filePath))
+		{
+			filePath = _filePath;
+
+			Core::Debug::Assertion::out(BinaryScene::load(*this, _filePath), "Can not load the binary scene at " + _filePath);
+
+			isLoadFinished = true;
+			return;
+		}
+
 		std::ifstream scnStream(ResourcesManager::getResourcesPath() + _filePath);
 
 		Core::Debug::Assertion::out(scnStream.is_open() && !scnStream.fail(), "Can not find scene at " + _filePath);
@@ -73,10 +84,10 @@ namespace Resources
 
 		while (std::getline(scnStream, line))
 		{
-			if (line == "") continue;
-
 			std::istringstream iss(line);
-			iss >> type;
+
+			// The blank lines keep their carriage return out of Windows
+			if (!(iss >> type)) continue;
 
 			if (type == "GO")
 			{
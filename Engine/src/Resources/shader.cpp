@@ -2,6 +2,7 @@
 
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
 
 #include <imgui.h>
 
@@ -187,10 +188,6 @@ namespace Resources
     void ShaderProgram::mainThreadInitialization()
     {
         linkShaders();
-
-
-        // TODO: REMOVE THIS SHIT 
-        LowRenderer::RenderManager::bindUBO(this, "lightBlock");
     }
 
     void ShaderProgram::create()
@@ -209,15 +206,89 @@ namespace Resources
         destroy();
     }
 
+    void ShaderProgram::addUniform(const std::string& uniformName, GLint location, GLint size, GLenum type, GLuint& samplerUnit)
+    {
+        LowRenderer::UniformID ID = LowRenderer::hashUniformName(uniformName);
+
+        // Arrays are also found by the ID of their name and the index of their elements
+        LowRenderer::UniformID arrayID = 0u;
+        int firstIndex = 0;
+        GLint elementCount = 0;
+
+        size_t bracket = uniformName.find('[');
+        size_t closingBracket = uniformName.find(']', bracket);
+
+        if (bracket != std::string::npos && closingBracket != std::string::npos)
+        {
+            std::string suffix = uniformName.substr(closingBracket + 1);
+
+            if (suffix.empty() || suffix == "[0]")
+            {
+                arrayID = LowRenderer::hashUniformName(std::string_view(uniformName).substr(0, bracket));
+                firstIndex = std::stoi(uniformName.substr(bracket + 1, closingBracket - bracket - 1));
+
+                // The elements of a flat array follow the location of the first one
+                elementCount = suffix.empty() ? size : 1;
+            }
+        }
+
+        GLenum textureType = 0;
+        switch (type)
+        {
+        case GL_SAMPLER_2D:
+            textureType = GL_TEXTURE_2D;
+            break;
+        case GL_SAMPLER_CUBE:
+            textureType = GL_TEXTURE_CUBE_MAP;
+            break;
+        }
+
+        for (GLint i = 0; i < std::max(elementCount, 1); i++)
+        {
+            size_t uniformIndex = uniforms.size();
+            uniforms.emplace_back(location + i, type);
+
+            if (i == 0)
+            {
+                uniformIndices[ID] = uniformIndex;
+                LowRenderer::registerUniformName(ID, uniformName);
+            }
+
+            if (elementCount > 0)
+            {
+                uniformIndices[LowRenderer::getElementID(arrayID, firstIndex + i)] = uniformIndex;
+                LowRenderer::registerUniformName(LowRenderer::getElementID(arrayID, firstIndex + i), uniformName.substr(0, bracket) + '[' + std::to_string(firstIndex + i) + ']');
+            }
+
+            if (!textureType)
+                continue;
+
+            // Give a texture unit to each sampler, the program is bound while its uniforms are loaded
+            Sampler sampler = { samplerUnit++, textureType };
+            glUniform1i(location + i, (GLint)sampler.unit);
+
+            if (i == 0)
+                samplers[ID] = sampler;
+
+            if (elementCount > 0)
+                samplers[LowRenderer::getElementID(arrayID, firstIndex + i)] = sampler;
+        }
+    }
+
     void ShaderProgram::loadUniforms()
     {
         uniforms.clear();
-        samplerIDs.clear();
+        uniformIndices.clear();
+        samplers.clear();
 
         // Get the active uniforms count
         GLint uniformCount;
         glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &uniformCount);
 
+        LowRenderer::GLStateCache::useProgram(programID);
+
+        GLuint samplerUnit = 0u;
+
         // Loop over the active uniforms
         for (GLint i = 0; i < uniformCount; i++)
         {
@@ -238,20 +309,11 @@ namespace Resources
                 continue;
             }
 
-            switch (type)
-            {
-            case GL_SAMPLER_2D:
-                samplerIDs[uniName] = { (GLuint)samplerIDs.size(), GL_TEXTURE_2D };
-                break;
-            case GL_SAMPLER_CUBE:
-                samplerIDs[uniName] = { (GLuint)samplerIDs.size(), GL_TEXTURE_CUBE_MAP };
-                break;
-            }
-
-            // Create a new uniform with the location and the type
-            // And add it to a map
-            uniforms[uniName] = LowRenderer::Uniform(location, type);
+            // Resolve the uniform once, the draws only use its ID
+            addUniform(uniName, location, size, type, samplerUnit);
         }
+
+        LowRenderer::GLStateCache::useProgram(0);
     }
 
     void ShaderProgram::loadLocations()
@@ -259,51 +321,27 @@ namespace Resources
         loadUniforms();
     }
 
-    void ShaderProgram::setUniform(const std::string& target, const void* value, bool shouldBeTracked, int count, bool transpose) const
+    void ShaderProgram::warnMissingUniform(LowRenderer::UniformID ID) const
     {
-        if (!value)
-        {
-            Core::Debug::Log::error("Value sent at " + target + " is not valid");
-            return;
-        }
-
-        // Get the iterator with the target
-        const auto& currentIt = uniforms.find(target);
-
-        // Check if this iterator is valid
-        if (currentIt == uniforms.end())
-        {
-            if (debugSetUniform)
-                Core::Debug::Log::warning("Cannot find the uniform named: " + target + " - There is no uniform named like that");
-
-            return;
-        }
-
-        const LowRenderer::Uniform& uniform = currentIt->second;
-
-        if (!uniform.bind(value, count, transpose))
-            Core::Debug::Log::error("Cannot find the uniform named: " + target);
+        Core::Debug::Log::warning("Cannot find the uniform " + LowRenderer::getUniformName(ID) + " in " + name);
     }
 
-    void Sampler::bind(GLuint textureID)
+    void Sampler::bind(GLuint textureID) const
     {
-        glActiveTexture(GL_TEXTURE0 + location);
-        glBindTexture(type, textureID);
+        LowRenderer::GLStateCache::bindTexture(unit, type, textureID);
     }
 
-    bool ShaderProgram::setSampler(const std::string& target, GLuint textureID)
+    bool ShaderProgram::setSampler(LowRenderer::UniformID ID, GLuint textureID) const
     {
         if (!textureID)
             return false;
 
-        const auto& samplerIt = samplerIDs.find(target);
+        const auto& samplerIt = samplers.find(ID);
 
-        if (samplerIt == samplerIDs.end())
+        if (samplerIt == samplers.end())
             return false;
 
-        auto [samplerName, sampler] = *samplerIt;
-
-        sampler.bind(textureID);
+        samplerIt->second.bind(textureID);
 
         return true;
     }
@@ -313,17 +351,15 @@ namespace Resources
         if (!programID)
             return false;
 
-        glUseProgram(programID);
-
-        for (auto [samplerName, ID] : samplerIDs)
-            setUniform(samplerName, &ID, false);
+        // The sampler units have been set when the uniforms were loaded
+        LowRenderer::GLStateCache::useProgram(programID);
 
         return true;
     }
 
     void ShaderProgram::unbind() const
     {
-        glUseProgram(0);
+        LowRenderer::GLStateCache::useProgram(0);
     }
 
     void ShaderProgram::reload()
@@ -346,23 +382,16 @@ namespace Resources
         ResourcesManager::addToMainThreadInitializerQueue(this);
     }
 
-    std::string ShaderProgram::getName()
+    bool ShaderProgram::usesShader(const std::string& shaderPath) const
     {
-        return name;
+        return (vertShader && vertShader->getPath() == shaderPath) ||
+               (fragShader && fragShader->getPath() == shaderPath) ||
+               (geomShader && geomShader->getPath() == shaderPath);
     }
 
-    GLint ShaderProgram::getUBOLocation(const std::string& UBOName) const
-    {
-        return glGetUniformBlockIndex(programID, UBOName.c_str());
-    }
-
-    bool ShaderProgram::bindToUBO(const std::string& UBOName, GLint UBIndex, GLuint bindingPoint)
+    std::string ShaderProgram::getName()
     {
-        if (UBIndex < -1)
-            return false;
-
-        glUniformBlockBinding(programID, UBIndex, bindingPoint);
-        return true;
+        return name;
     }
 
     void ShaderProgram::drawImGui()
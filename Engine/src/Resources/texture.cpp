@@ -8,10 +8,13 @@
 #include "stb_image.h"
 
 #include "debug.hpp"
+#include "gl_state_cache.hpp"
 #include "thread_pool.hpp"
 #include "resources_manager.hpp"
+#include "tracer.hpp"
 
 #include "utils.hpp"
+#include "hash.hpp"
 
 #include <cerrno>
 
@@ -37,7 +40,8 @@ namespace Resources
 
 	Texture::~Texture()
 	{
-		if (colorBuffer)
+		// The buffers given by name are not owned by the texture
+		if (colorBuffer && stbiLoaded)
 			stbi_image_free(colorBuffer);
 
 		glDeleteTextures(1, &textureID);
@@ -45,9 +49,30 @@ namespace Resources
 
 	bool Texture::generateBuffer()
 	{
-		if (stbiLoaded)
+		if (stbiLoaded || sharedTexture)
 			return true;
 
+		// Do not decode the texture if the load has been cancelled
+		if (isLoadCancelled())
+			return false;
+
+		// A path with the same content as a loaded one shares its texture, a reload keeps its own
+		uint64_t contentHash = 0u;
+		if (!textureID && readContent(contentHash))
+		{
+			sharedTexture = ResourcesManager::resolveTextureContent(m_filePath, contentHash);
+
+			if (sharedTexture)
+			{
+				releaseContent();
+				Core::Debug::Log::info(m_filePath + " has the same content as " + sharedTexture->getPath() + ", its texture is shared");
+
+				// The texture is drawn by the main thread, the alias is only used once it is initialized there
+				ResourcesManager::addToMainThreadInitializerQueue(this);
+				return true;
+			}
+		}
+
 		Core::Debug::Log::info("Start loading " + m_filePath + '.');
 
 		auto loadStart = std::chrono::system_clock::now();
@@ -57,7 +82,10 @@ namespace Resources
 		std::string correctPath = ResourcesManager::getResourcesPath() + m_filePath;
 
 		// Get the color buffer by using stbi
-		colorBuffer = stbi_loadf(correctPath.c_str(), &width, &height, &channel, STBI_rgb_alpha);
+		{
+			Core::Debug::Tracer::Scope decodeScope("Image decode", m_filePath);
+			colorBuffer = decode(correctPath);
+		}
 
 		stbi_set_flip_vertically_on_load_thread(false);
 		
@@ -78,6 +106,14 @@ namespace Resources
 
 		Core::Debug::Log::info("Loading of " + m_filePath + " done with success in " + timeAsString + " ms.");
 
+		// A cancelled texture is decoded again by the next load that uses it
+		if (isLoadCancelled())
+		{
+			stbi_image_free(colorBuffer);
+			colorBuffer = nullptr;
+			return false;
+		}
+
 		stbiLoaded = true;
 
 		// Tell to the RM that the initialization is finished
@@ -88,9 +124,9 @@ namespace Resources
 
 	bool Texture::generateID()
 	{
-		if (!colorBuffer || textureID)
+		if (!colorBuffer)
 		{
-			Core::Debug::Log::error("Texture at " + m_filePath + " is already OpenGL initialized");
+			Core::Debug::Log::error("Texture at " + m_filePath + " has no color buffer to send to OpenGL");
 			return false;
 		}
 
@@ -104,22 +140,31 @@ namespace Resources
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-		// Generate the texture ID
-		glGenTextures(1, &textureID);
+		// Generate the texture ID, a reloaded texture keeps its own
+		if (!textureID)
+			glGenTextures(1, &textureID);
+
 		glBindTexture(GL_TEXTURE_2D, textureID);
 
 		allocateTexture(GL_TEXTURE_2D);
+		uploadCount++;
 
 		// Generate its mipmap
 		glGenerateMipmap(GL_TEXTURE_2D);
 
 		glBindTexture(GL_TEXTURE_2D, 0);
 
-		// Free the color buffer allocated by stbi
-		if (stbiLoaded)
-			stbi_image_free(colorBuffer);
+		// The texture binding was changed behind the cache
+		LowRenderer::GLStateCache::invalidate();
 
-		colorBuffer = nullptr;
+		// Free the color buffer allocated by stbi, unless the texture is read back by the CPU
+		if (!keepCPUData)
+		{
+			if (stbiLoaded)
+				stbi_image_free(colorBuffer);
+
+			colorBuffer = nullptr;
+		}
 
 		auto initEnd = std::chrono::system_clock::now();
 
@@ -132,6 +177,53 @@ namespace Resources
 		return true;
 	}
 
+	void Texture::reload()
+	{
+		// The texture is still being loaded, it will be uploaded anyway
+		if (!textureID)
+			return;
+
+		// A kept color buffer is replaced by the new one
+		if (colorBuffer && stbiLoaded)
+			stbi_image_free(colorBuffer);
+
+		colorBuffer = nullptr;
+		stbiLoaded = false;
+
+		ResourcesManager::manageReloadTask(&Texture::generateBuffer, this);
+	}
+
+	float* Texture::decode(const std::string& correctPath)
+	{
+		// A reload reads the file again
+		if (fileContent.empty())
+			return stbi_loadf(correctPath.c_str(), &width, &height, &channel, STBI_rgb_alpha);
+
+		float* buffer = stbi_loadf_from_memory((const stbi_uc*)fileContent.data(), (int)fileContent.size(), &width, &height, &channel, STBI_rgb_alpha);
+		std::vector<char>().swap(fileContent);
+
+		return buffer;
+	}
+
+	bool Texture::readContent(uint64_t& contentHash)
+	{
+		{
+			Core::Debug::Tracer::Scope readScope("File read", m_filePath);
+
+			if (!Utils::readFile(ResourcesManager::getResourcesPath() + m_filePath, fileContent))
+				return false;
+		}
+
+		contentHash = Utils::hashBytes(fileContent.data(), fileContent.size());
+
+		return true;
+	}
+
+	void Texture::releaseContent()
+	{
+		std::vector<char>().swap(fileContent);
+	}
+
 	void Texture::allocateTexture(int textureType)
 	{
 		glTexImage2D(textureType, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_FLOAT, colorBuffer);
@@ -139,28 +231,56 @@ namespace Resources
 
 	void Texture::mainThreadInitialization()
 	{
+		if (sharedTexture)
+		{
+			isShared = true;
+			return;
+		}
+
 		generateID();
 	}
 
 	GLuint Texture::getID() const
 	{
-		return textureID;
+		return isShared ? sharedTexture->getID() : textureID;
 	}
 
 	int Texture::getHeight() const
 	{
-		return height;
+		return isShared ? sharedTexture->getHeight() : height;
 	}
 
 	int Texture::getWidth() const
 	{
-		return width;
+		return isShared ? sharedTexture->getWidth() : width;
+	}
+
+	unsigned int Texture::getUploadCount() const
+	{
+		return isShared ? sharedTexture->getUploadCount() : uploadCount;
+	}
+
+	size_t Texture::getDecodedSize() const
+	{
+		// The color buffer is decoded as four floats per pixel
+		return (size_t)width * height * 4 * sizeof(float);
+	}
+
+	size_t Texture::getCPUBytes() const
+	{
+		return colorBuffer && stbiLoaded ? getDecodedSize() : 0u;
+	}
+
+	size_t Texture::getGPUBytes() const
+	{
+		// Stored as RGBA8, the mipmap chain adds a third of the base level
+		return textureID ? (size_t)width * height * 4 * 4 / 3 : 0u;
 	}
 
 	void Texture::drawImGui()
 	{
 		ImGui::Text(m_filePath.c_str());
-		ImGui::Image((void*)(std::intptr_t)textureID, ImVec2(128, 128), ImVec2(0, 1), ImVec2(1, 0));
+		ImGui::Image((void*)(std::intptr_t)getID(), ImVec2(128, 128), ImVec2(0, 1), ImVec2(1, 0));
 	}
 
 	CubeMapTexture::CubeMapTexture(int ID, const std::string& filePath)
@@ -171,11 +291,19 @@ namespace Resources
 
 	bool CubeMapTexture::generateBuffer()
 	{
+		// A kept color buffer is replaced by the new one
+		if (colorBuffer && stbiLoaded)
+			stbi_image_free(colorBuffer);
+
 		stbi_set_flip_vertically_on_load_thread(false);
 
 		std::string correctPath = ResourcesManager::getResourcesPath() + m_filePath;
 
-		colorBuffer = stbi_loadf(correctPath.c_str(), &width, &height, &channel, STBI_rgb_alpha);
+		{
+			Core::Debug::Tracer::Scope decodeScope("Image decode", m_filePath);
+			colorBuffer = decode(correctPath);
+		}
+
 		stbi_set_flip_vertically_on_load_thread(true);
 
 		if (!colorBuffer)
@@ -196,10 +324,13 @@ namespace Resources
 	{
 		allocateTexture(GL_TEXTURE_CUBE_MAP_POSITIVE_X + cubeMapID);
 
-		if (stbiLoaded)
-			stbi_image_free(colorBuffer);
+		if (!keepCPUData)
+		{
+			if (stbiLoaded)
+				stbi_image_free(colorBuffer);
 
-		colorBuffer = nullptr;
+			colorBuffer = nullptr;
+		}
 
 		return true;
 	}
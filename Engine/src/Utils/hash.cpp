@@ -0,0 +1,144 @@
+#include "hash.hpp"
+
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+namespace Utils
+{
+    static constexpr uint64_t prime1 = 0x9E3779B185EBCA87ull;
+    static constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr uint64_t prime3 = 0x165667B19E3779F9ull;
+    static constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+    static constexpr uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+    static uint64_t rotateLeft(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    static uint64_t read64(const unsigned char* bytes)
+    {
+        uint64_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    static uint32_t read32(const unsigned char* bytes)
+    {
+        uint32_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    static uint64_t round(uint64_t accumulator, uint64_t input)
+    {
+        accumulator += input * prime2;
+        accumulator = rotateLeft(accumulator, 31);
+        return accumulator * prime1;
+    }
+
+    static uint64_t mergeRound(uint64_t accumulator, uint64_t value)
+    {
+        accumulator ^= round(0u, value);
+        return accumulator * prime1 + prime4;
+    }
+
+    uint64_t hashBytes(const void* data, size_t size, uint64_t seed)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        const unsigned char* end = bytes + size;
+
+        uint64_t hash;
+
+        // Consume the buffer by stripes of 32 bytes with four accumulators
+        if (size >= 32u)
+        {
+            uint64_t v1 = seed + prime1 + prime2;
+            uint64_t v2 = seed + prime2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - prime1;
+
+            const unsigned char* limit = end - 32;
+            do
+            {
+                v1 = round(v1, read64(bytes));
+                v2 = round(v2, read64(bytes + 8));
+                v3 = round(v3, read64(bytes + 16));
+                v4 = round(v4, read64(bytes + 24));
+                bytes += 32;
+            } while (bytes <= limit);
+
+            hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+            hash = mergeRound(hash, v1);
+            hash = mergeRound(hash, v2);
+            hash = mergeRound(hash, v3);
+            hash = mergeRound(hash, v4);
+        }
+        else
+            hash = seed + prime5;
+
+        hash += static_cast<uint64_t>(size);
+
+        // Consume the remaining bytes
+        for (; bytes + 8 <= end; bytes += 8)
+        {
+            hash ^= round(0u, read64(bytes));
+            hash = rotateLeft(hash, 27) * prime1 + prime4;
+        }
+
+        if (bytes + 4 <= end)
+        {
+            hash ^= static_cast<uint64_t>(read32(bytes)) * prime1;
+            hash = rotateLeft(hash, 23) * prime2 + prime3;
+            bytes += 4;
+        }
+
+        for (; bytes < end; bytes++)
+        {
+            hash ^= (*bytes) * prime5;
+            hash = rotateLeft(hash, 11) * prime1;
+        }
+
+        // Mix the bits of the final hash
+        hash ^= hash >> 33;
+        hash *= prime2;
+        hash ^= hash >> 29;
+        hash *= prime3;
+        hash ^= hash >> 32;
+
+        return hash;
+    }
+
+    uint64_t combineHashes(uint64_t hash, uint64_t other)
+    {
+        return hashBytes(&other, sizeof(other), hash);
+    }
+
+    bool hashFile(const std::string& filePath, uint64_t& hash)
+    {
+        std::vector<char> content;
+
+        if (!readFile(filePath, content))
+            return false;
+
+        hash = hashBytes(content.data(), content.size());
+
+        return true;
+    }
+
+    bool readFile(const std::string& filePath, std::vector<char>& content)
+    {
+        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+
+        if (!file)
+            return false;
+
+        std::streamsize size = file.tellg();
+        file.seekg(0, std::ios::beg);
+
+        content.resize(static_cast<size_t>(size));
+
+        return size == 0 || (bool)file.read(content.data(), size);
+    }
+}
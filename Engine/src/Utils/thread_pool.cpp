@@ -7,24 +7,34 @@ namespace Multithread
     {
         while (!terminate)
         {
-            std::function<void()> task;
+            Task task;
 
             if (!tasks.tryPop(task))
                 continue;
 
+            // Set the current working thread
+            workingThreadCount++;
+
+            // Discard the task if its load has been cancelled while it was queued
+            if (task.token.isCancelled())
+            {
+                workingThreadCount--;
+                continue;
+            }
+
             // Catch all exceptions and keep them in the ThreadPool
             try
             {
-                // Set the current working thread
-                workingThreadCount++;
-                task();
-                workingThreadCount--;
+                CancellationToken::Scope tokenScope(task.token);
+                task.function();
             }
             catch (...)
             {
                 exceptions.tryPush(std::current_exception());
             }
 
+            workingThreadCount--;
+
             lastTime = std::chrono::system_clock::now();
         }
     }
@@ -81,6 +91,11 @@ namespace Multithread
         sync();
     }
 
+    void ThreadPool::discardCancelled()
+    {
+        tasks.eraseIf([](const Task& task) { return task.token.isCancelled(); });
+    }
+
     ThreadPool::~ThreadPool()
     {
         stopAllThread();
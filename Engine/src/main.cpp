@@ -1,21 +1,42 @@
 #include <string>
 #include <iostream>
+
+#ifdef _MSC_VER
 #include <crtdbg.h>
+#endif
 
 #include "application.hpp"
+#include "headless_runner.hpp"
 
 #include "debug.hpp"
 
 const unsigned int SCR_WIDTH = 1440;
 const unsigned int SCR_HEIGHT = 900;
 
-int main()
+int main(int argc, char** argv)
 {
+#ifdef _MSC_VER
 	// Check for leak
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+	// Benchmark the load of a scene without any window nor GPU
+	if (Core::Debug::HeadlessRunner::isRequested(argc, argv))
+		return Core::Debug::HeadlessRunner::run(argc, argv);
+
+	// The windowed engine can also count or record its GL calls
+	LowRenderer::RenderBackendType backend = LowRenderer::RenderBackendType::OPENGL;
+	std::string recordPath = "logs/gl_calls.txt";
+
+	if (!LowRenderer::RenderBackend::parseArguments(argc, argv, backend, recordPath))
+	{
+		std::cerr << "Usage: [--backend opengl|null|recording] [--record <path>]" << std::endl;
+		return 1;
+	}
 
 	try
 	{
+		Core::Application::setRenderBackend(backend, recordPath);
 		Core::Application::init(SCR_WIDTH, SCR_HEIGHT, "Engine");
 
 		Core::Application::update();